@@ -4,50 +4,74 @@ void ofApp::setup() {
     ofLogToConsole(); 
     ofSetLogLevel(OF_LOG_VERBOSE);
 
-    actionMap["muteToggle"] = &ofApp::onToggleChanged;
-    actionMap["freqToggle1"] = &ofApp::onFreqToggle1;
-    actionMap["freqToggle2"] = &ofApp::onFreqToggle2;
-    actionMap["freqToggle3"] = &ofApp::onFreqToggle3;
+    ofAddListener(guiManager.onChange, this, &ofApp::handleGuiJsonToggle);
+    guiManager.setup("config.json", true); // Watch config.json so layout edits apply without a restart
+    guiManager.setCachedRendering(true); // Redraw a panel only when one of its widgets changes
 
-    ofAddListener(guiManager.onToggleEvent, this, &ofApp::handleGuiJsonToggle);
-    guiManager.setup("config.json"); //pass contents as string instead of file and handle multiple json loading
-
-    if (guiManager.getConfig().is_null()) {
+    if (guiManager.getModel().panels.empty()) {
         ofLogError() << "Configuration is null after loading.";
         return;
     }
 
     // Audio settings
-    auto audioSettings = guiManager.getConfig()["audio_settings"];
+    const GuiAudioSettings& audioSettings = guiManager.getSettings().audio;
     ofSoundStreamSettings settings;
-    settings.numOutputChannels = audioSettings.value("outputChannels", 0);
-    settings.numInputChannels = audioSettings.value("inputChannels", 0);
-    settings.sampleRate = audioSettings.value("sampleRate", 0);
-    settings.bufferSize = audioSettings.value("bufferSize", 0);
+    settings.numOutputChannels = audioSettings.outputChannels;
+    settings.numInputChannels = audioSettings.inputChannels;
+    settings.sampleRate = audioSettings.sampleRate;
+    settings.bufferSize = audioSettings.bufferSize;
     settings.setApi(ofSoundDevice::Api::MS_DS);
+
+    // Resolve the parameters read by the audio thread before it starts
+    mutedParam = guiManager.getAudioBridge().find("muted");
+    frequencyParam = guiManager.getAudioBridge().declare("frequency", frequency);
+    frequencyParam->setSmoothing(20, audioSettings.sampleRate);
+
     settings.setOutListener(this);
     soundStream.setup(settings);
 
+    // Values shown by the labels with "bind" in config.json, sampled and formatted by ofxGuiJson
+    guiManager.registerValue("audio.frequency", &frequency);
+    guiManager.registerValue("mouse.x", [] { return ofGetMouseX(); });
+    guiManager.registerValue("mouse.y", [] { return ofGetMouseY(); });
+
+    // The device list only instantiates its visible rows, however many devices are discovered
+    ofxGuiJsonVirtualList* deviceList = guiManager.getVirtualList("deviceList");
+    if (deviceList) {
+        deviceList->setSource(&devices);
+    }
+
+    // Pick up where the last run stopped, even after a crash, and keep saving in the background
+    if (ofFile::doesFileExist("gui_state.bin")) {
+        guiManager.loadSnapshot("gui_state.bin");
+    }
+    guiManager.setAutosave(true, "gui_state.bin", 250);
 }
 
 
-void ofApp::handleGuiJsonToggle(std::pair<std::string, bool>& toggleInfo) {
-    ofLogNotice() << "handleGuiJsonToggle called with action: " << toggleInfo.first << " and state: " << toggleInfo.second;
+void ofApp::handleGuiJsonToggle(GuiEvent& change) {
+    bool state = change.asBool();
 
-    // Check if the action corresponds to the mute toggle
-    if (toggleInfo.first == "toggleMute") {
-        ofLogNotice() << "Mute action identified with state: " << toggleInfo.second;
-        onToggleChanged(toggleInfo.second);
-    }
-    else {
-        // Handle other actions
-        auto it = actionMap.find(toggleInfo.first);
-        if (it != actionMap.end()) {
-            (this->*it->second)(toggleInfo.second); // Call the function pointer for the action
-        }
-        else {
-            ofLogNotice() << "Unhandled toggle action: " << toggleInfo.first;
-        }
+    // Action names from config.json are hashed at compile time, no string is compared
+    switch (change.actionKey) {
+    case guiHash("toggleMute"):
+        onToggleChanged(state);
+        break;
+    case guiHash("onFreqToggle1"):
+        onFreqToggle1(state);
+        break;
+    case guiHash("onFreqToggle2"):
+        onFreqToggle2(state);
+        break;
+    case guiHash("onFreqToggle3"):
+        onFreqToggle3(state);
+        break;
+    case guiHash("setFrequency"):
+        // Notified at most 30 times per second while the slider is dragged, see "max_rate"
+        setFrequency(change.asFloat());
+        break;
+    default:
+        break;
     }
 }
 
@@ -71,14 +95,16 @@ void ofApp::onButtonPressed() {
 
 
 void ofApp::update() {
-    // Check if mouseYFrequency interaction is enabled
-    if (guiManager.getConfig()["interaction"].value("enable", false) &&
-        guiManager.getConfig()["interaction"]["type"] == "mouseYFrequency") {
+    const GuiSettings& guiSettings = guiManager.getSettings();
+
+    // Check if mouseYFrequency interaction is enabled, the frequency slider takes over until a range is picked
+    if (!sliderDrivesFrequency && guiSettings.interaction.enable &&
+        guiSettings.interaction.type == "mouseYFrequency") {
         int currentMouseY = ofGetMouseY();
-        if (abs(currentMouseY - oldMouseY) > guiManager.getConfig()["audio_settings"]["sensitivity"].get<int>()) {
+        if (abs(currentMouseY - oldMouseY) > guiSettings.audio.sensitivity) {
             frequency = ofMap(currentMouseY, 0, ofGetHeight(),
-                guiManager.getConfig()["audio_settings"]["minFrequency"].get<int>(),
-                guiManager.getConfig()["audio_settings"]["maxFrequency"].get<int>(), true); //move out of gui manager
+                guiSettings.audio.minFrequency,
+                guiSettings.audio.maxFrequency, true); //move out of gui manager
             oldMouseY = currentMouseY;
         }
     }
@@ -92,23 +118,12 @@ void ofApp::update() {
         waveLine.getVertices().erase(waveLine.getVertices().begin());
     }
 
-    std::map<std::string, std::string> labelUpdates;
-
-    // Check for specific conditions or retrieve data, then prepare label text
-    if (guiManager.getConfig()["interaction"].value("enable", false)) {
-        int mouseX = ofGetMouseX();
-        int mouseY = ofGetMouseY();
-        labelUpdates["cursorLabel"] = "Cursor: X=" + std::to_string(mouseX) + " Y=" + std::to_string(mouseY);
-
-        double currentFrequency = frequency;
-        labelUpdates["frequencyLabel"] = "Frequency: " + std::to_string(currentFrequency);
-    }
-
-    if (frequencyMin != frequencyMax) {
+    if (!sliderDrivesFrequency && frequencyMin != frequencyMax) {
         frequency = ofMap(ofGetMouseY(), 0, ofGetHeight(), frequencyMin, frequencyMax, true);
     }
-    // Pass updates to ofxGuiJson
-    guiManager.updateGuiLabels(labelUpdates);
+    if (frequencyParam) {
+        frequencyParam->publish(frequency);  // Hand the frequency to the audio thread
+    }
 }
 
 void ofApp::draw() {
@@ -118,9 +133,7 @@ void ofApp::draw() {
     glGenTextures(1, &defaultTexture);
     glBindTexture(GL_TEXTURE_2D, defaultTexture);
 
-    for (auto& panel : guiManager.getPanels()) {
-        panel->draw();
-    }
+    guiManager.draw();
 
     glBindTexture(GL_TEXTURE_2D, 0); // Unbind the default texture
     glDeleteTextures(1, &defaultTexture); // Clean up the texture
@@ -128,9 +141,12 @@ void ofApp::draw() {
 
 
 void ofApp::audioOut(ofSoundBuffer& buffer) {
+    // Only the lock-free bridge parameters are shared with the main thread
+    bool muted = mutedParam && mutedParam->get() > 0.5f;
     for (size_t i = 0; i < buffer.getNumFrames(); ++i) {
-        if (!isMuted) {
-            double wave = myOsc.sinewave(frequency); // Use the dynamically updated frequency
+        double currentFrequency = frequencyParam ? frequencyParam->next() : 440;
+        if (!muted) {
+            double wave = myOsc.sinewave(currentFrequency); // Use the smoothed frequency from the bridge
             buffer[i * buffer.getNumChannels()] = wave;
             if (buffer.getNumChannels() > 1) {
                 buffer[i * buffer.getNumChannels() + 1] = wave;
@@ -140,7 +156,7 @@ void ofApp::audioOut(ofSoundBuffer& buffer) {
 }
 
 void ofApp::exit() {
-    ofRemoveListener(guiManager.onToggleEvent, this, &ofApp::handleGuiJsonToggle);
+    ofRemoveListener(guiManager.onChange, this, &ofApp::handleGuiJsonToggle);
 
     soundStream.close();  // Close any audio streams or other cleanup needed
 }
@@ -188,7 +204,7 @@ void ofApp::onFreqToggle3(bool& state) {
 }
 
 void ofApp::updateToggleState(const std::string& toggleId, bool newState) {
-    auto toggle = std::dynamic_pointer_cast<ofxToggle>(guiManager.getGuiElement(toggleId));
+    auto toggle = dynamic_cast<ofxToggle*>(guiManager.getGuiWidget(toggleId));
     if (toggle) {
         ofParameter<bool>& param = toggle->getParameter().cast<bool>();
         param.set(newState);
@@ -199,10 +215,16 @@ void ofApp::setFrequencyRange(int minFreq, int maxFreq) {
     ofLogNotice() << "Setting frequency range: " << minFreq << " to " << maxFreq;
     frequencyMin = minFreq;
     frequencyMax = maxFreq;
+    sliderDrivesFrequency = false;  // The mouse drives the frequency within the new range
     frequency = (frequencyMin + frequencyMax) / 2;
     ofLogNotice() << "Current frequency set to: " << frequency;
 }
 
+void ofApp::setFrequency(double hz) {
+    frequency = hz;
+    sliderDrivesFrequency = true;  // Stops the mouse from driving the frequency
+}
+
 void ofApp::keyPressed(int key) {
     ofLogNotice() << "Key pressed: " << key;  // Log the ASCII value of the key
 
@@ -215,5 +237,19 @@ void ofApp::keyPressed(int key) {
         guiManager.removeLastToggle();
         ofLogNotice("ofApp::keyPressed") << "Key 'x' pressed, removing last toggle.";
     }
+
+    if (key == 'd' || key == 'D') {
+        // Simulate a discovery round adding a hundred devices to the list
+        for (int i = 0; i < 100; i++) {
+            VectorListSource::Item device;
+            device.text = "Device " + ofToString(devices.items.size() + 1);
+            devices.items.push_back(device);
+        }
+        ofxGuiJsonVirtualList* deviceList = guiManager.getVirtualList("deviceList");
+        if (deviceList) {
+            deviceList->refresh();
+            guiManager.markElementDirty("deviceList");
+        }
+    }
 }
 
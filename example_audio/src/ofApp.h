@@ -31,8 +31,6 @@ using json = nlohmann::json;
  */
 class ofApp : public ofBaseApp {
 public:
-    using ToggleAction = void (ofApp::*)(bool&);
-
     /*!
      *  @brief Sets up the application, including GUI and audio settings.
      */
@@ -111,6 +109,13 @@ public:
      */
     void setFrequencyRange(int minFreq, int maxFreq);
 
+    /*!
+     *  @brief Sets the frequency of the oscillator and stops the mouse from changing it
+     *         until a frequency range is picked.
+     *  @param hz The frequency.
+     */
+    void setFrequency(double hz);
+
     /*!
      *  @brief Updates the state of a toggle based on its ID.
      *  @param toggleId The ID of the toggle.
@@ -125,25 +130,27 @@ public:
     void keyPressed(int key) override;
 
     /*!
-     *  @brief Handles GUI JSON toggle events.
-     *  @param toggleInfo The toggle information containing the ID and state.
+     *  @brief Handles GUI JSON changes, dispatching on the action of the element.
+     *  @param change The change with the interned ID, action and value.
      */
-    void handleGuiJsonToggle(std::pair<std::string, bool>& toggleInfo);
+    void handleGuiJsonToggle(GuiEvent& change);
 
     ofxPanel gui;                               //!< The main GUI panel.
     ofPolyline waveLine;                        //!< The polyline for visualizing the waveform.
     maxiOsc myOsc;                              //!< The oscillator for generating sound.
     ofSoundStream soundStream;                  //!< The sound stream for audio output.
-    double frequency = 440;                     //!< The current frequency of the oscillator.
-    bool isMuted = false;                       //!< Flag indicating if the sound is muted.
+    double frequency = 440;                     //!< The current frequency of the oscillator, main thread only.
+    bool isMuted = false;                       //!< Flag indicating if the sound is muted, main thread only.
     bool isMousePressed = false;                //!< Flag indicating if the mouse is pressed.
     int oldMouseY = 0;                          //!< The previous y-coordinate of the mouse.
 
-    std::map<std::string, ToggleAction> actionMap;  //!< A map linking toggle IDs to their corresponding actions.
-
     ofxGuiJson guiManager;                      //!< The GUI manager for handling JSON-based GUI elements.
+    AudioParameter* mutedParam = nullptr;       //!< Mute state fed by the mute toggle, read by the audio thread.
+    AudioParameter* frequencyParam = nullptr;   //!< Frequency published to the audio thread.
+    VectorListSource devices;                   //!< Discovered devices shown by the device list.
 
 private:
     int frequencyMin = 220;                     //!< The minimum frequency range.
     int frequencyMax = 440;                     //!< The maximum frequency range.
+    bool sliderDrivesFrequency = false;         //!< Whether the frequency slider, not the mouse, sets the frequency.
 };
@@ -0,0 +1,38 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofApp.h"
+
+//========================================================================
+int main(int argc, char* argv[]) {
+	BenchmarkOptions options;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string flag = argv[i];
+		std::string value = argv[i + 1];
+		if (flag == "--sizes") {
+			options.sizes.clear();
+			std::stringstream list(value);
+			std::string size;
+			while (std::getline(list, size, ',')) {
+				options.sizes.push_back(std::stoul(size));
+			}
+		}
+		else if (flag == "--panels") {
+			options.panels = std::stoul(value);
+		}
+		else if (flag == "--repeats") {
+			options.repeats = std::stoul(value);
+		}
+		else if (flag == "--out") {
+			options.outputPath = value;
+		}
+		else {
+			std::cerr << "Unknown option " << flag << std::endl;
+			std::cerr << "Usage: example_benchmark [--sizes 10,100,1000] [--panels 10] [--repeats 5] [--out benchmark_results]" << std::endl;
+			return 1;
+		}
+	}
+
+	// No window and no GL context: everything that renders is skipped
+	ofSetupOpenGL(new ofAppNoWindow(), 1024, 768, OF_WINDOW);
+	ofRunApp(new ofApp(options));
+}
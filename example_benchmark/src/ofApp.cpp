@@ -0,0 +1,333 @@
+#include "ofApp.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double microsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    }
+
+    std::string toggleId(size_t index) { return "toggle" + std::to_string(index); }
+    std::string labelId(size_t index) { return "label" + std::to_string(index); }
+}
+
+void ofApp::setup() {
+    ofLogToConsole();
+    ofSetLogLevel(OF_LOG_WARNING); // Keep per-element notices out of the console
+
+    for (size_t elements : options.sizes) {
+        runSize(elements);
+    }
+
+    std::string basePath = ofToDataPath(options.outputPath, true);
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(basePath).parent_path(), error);
+    writeJson(basePath + ".json");
+    writeCsv(basePath + ".csv");
+    std::cout << "Results written to " << basePath << ".json and " << basePath << ".csv" << std::endl;
+
+    ofExit(0);
+}
+
+void ofApp::writeConfig(const std::string& path, size_t elements, size_t panels) {
+    json config;
+    config["background_color"] = { 0, 0, 0 };
+    json& panelList = config["panels"];
+    panelList = json::array();
+
+    size_t perPanel = (elements + panels - 1) / panels;
+    for (size_t p = 0; p < panels; p++) {
+        json panel;
+        panel["gui"] = {
+            { "title", "Panel " + std::to_string(p) },
+            { "width", 300 },
+            { "height", 30 },
+            { "position", { { "x", 310 * (p % 4) }, { "y", 0 } } }
+        };
+        json& elementList = panel["elements"];
+        elementList = json::array();
+        for (size_t i = p * perPanel; i < std::min(elements, (p + 1) * perPanel); i++) {
+            bool isToggle = i % 2 == 0;
+            elementList.push_back({
+                { "type", isToggle ? "toggle" : "label" },
+                { "id", isToggle ? toggleId(i) : labelId(i) },
+                { "label", (isToggle ? "Toggle " : "Label ") + std::to_string(i) },
+                { "default", false },
+                { "position", { { "x", 0 }, { "y", 30 * (i - p * perPanel) } } },
+                { "size", { { "width", 300 }, { "height", 30 } } }
+            });
+        }
+        panelList.push_back(panel);
+    }
+
+    std::ofstream file(path);
+    file << config.dump();
+}
+
+void ofApp::runSize(size_t elements) {
+    size_t panels = std::max<size_t>(1, std::min(options.panels, elements));
+    std::string configPath = (std::filesystem::temp_directory_path() / ("ofxGuiJson_benchmark_" + std::to_string(elements) + ".json")).string();
+    writeConfig(configPath, elements, panels);
+    std::cout << "Benchmarking " << elements << " elements across " << panels << " panels" << std::endl;
+
+    std::vector<double> samples;
+
+    // Configuration load: map, parse and compile into the model
+    for (size_t r = 0; r < options.repeats; r++) {
+        ofxGuiJson gui;
+        gui.setBinaryCache(false);
+        auto start = Clock::now();
+        gui.loadJson(configPath);
+        samples.push_back(microsSince(start));
+    }
+    addResult("load_json", elements, panels, samples, options.repeats);
+
+    // Same load from the binary cache, built by the first untimed load
+    std::string cachePath = GuiModelLoader::cachePath(configPath);
+    {
+        ofxGuiJson gui;
+        gui.loadJson(configPath);
+    }
+    for (size_t r = 0; r < options.repeats; r++) {
+        ofxGuiJson gui;
+        auto start = Clock::now();
+        gui.loadJson(configPath);
+        samples.push_back(microsSince(start));
+    }
+    addResult("load_json_cached", elements, panels, samples, options.repeats);
+
+    // Widget construction from the loaded model, with panels planned on the calling thread only
+    for (size_t r = 0; r < options.repeats; r++) {
+        ofxGuiJson serialGui;
+        serialGui.setBuildThreads(1);
+        serialGui.loadJson(configPath);
+        auto start = Clock::now();
+        serialGui.parseGuiElements();
+        samples.push_back(microsSince(start));
+    }
+    addResult("parse_gui_elements_serial", elements, panels, samples, options.repeats);
+
+    // Widget construction from the loaded model
+    std::unique_ptr<ofxGuiJson> gui;
+    for (size_t r = 0; r < options.repeats; r++) {
+        gui = std::make_unique<ofxGuiJson>();
+        gui->loadJson(configPath);
+        auto start = Clock::now();
+        gui->parseGuiElements();
+        samples.push_back(microsSince(start));
+    }
+    addResult("parse_gui_elements", elements, panels, samples, options.repeats);
+
+    // Same construction and dispatch without ofxGui widgets, isolating the cost of the core
+    {
+        std::unique_ptr<ofxGuiJson> headlessGui;
+        for (size_t r = 0; r < options.repeats; r++) {
+            headlessGui = std::make_unique<ofxGuiJson>(std::make_unique<GuiHeadlessBackend>());
+            headlessGui->loadJson(configPath);
+            auto start = Clock::now();
+            headlessGui->parseGuiElements();
+            samples.push_back(microsSince(start));
+        }
+        addResult("parse_gui_elements_headless", elements, panels, samples, options.repeats);
+
+        std::vector<GuiId> toggleIds;
+        for (size_t i = 0; i < elements; i += 2) {
+            toggleIds.push_back(headlessGui->getGuiId(toggleId(i)));
+        }
+        size_t headlessReceived = 0;
+        ofEventListener headlessListener = headlessGui->onChange.newListener([&headlessReceived](GuiEvent&) {
+            headlessReceived++;
+        });
+        if (!toggleIds.empty()) {
+            size_t flips = std::min<size_t>(toggleIds.size() * 2, 100000);
+            for (size_t f = 0; f < flips; f++) {
+                GuiId id = toggleIds[f % toggleIds.size()];
+                auto start = Clock::now();
+                headlessGui->setElementValue(id, headlessGui->getElementValue(id) == 0 ? 1 : 0);
+                samples.push_back(microsSince(start));
+            }
+            addResult("toggle_dispatch_headless", elements, panels, samples, flips);
+            if (headlessReceived != flips) {
+                ofLogError() << "Headless toggle dispatch delivered " << headlessReceived << " of " << flips << " events.";
+            }
+        }
+        headlessListener.unsubscribe();
+    }
+
+    // Toggle dispatch: parameter change to onChange
+    std::vector<ofParameter<bool>*> toggles;
+    std::vector<size_t> labels;
+    for (size_t i = 0; i < elements; i++) {
+        if (i % 2 == 0) {
+            auto toggle = dynamic_cast<ofxToggle*>(gui->getGuiWidget(toggleId(i)));
+            if (toggle) {
+                toggles.push_back(&toggle->getParameter().cast<bool>());
+            }
+        }
+        else {
+            labels.push_back(i);
+        }
+    }
+    size_t received = 0;
+    ofEventListener toggleListener = gui->onChange.newListener([&received](GuiEvent&) {
+        received++;
+    });
+    if (!toggles.empty()) {
+        size_t flips = std::min<size_t>(toggles.size() * 2, 100000);
+        for (size_t f = 0; f < flips; f++) {
+            ofParameter<bool>& param = *toggles[f % toggles.size()];
+            auto start = Clock::now();
+            param.set(!param.get());
+            samples.push_back(microsSince(start));
+        }
+        addResult("toggle_dispatch", elements, panels, samples, flips);
+        if (received != flips) {
+            ofLogError() << "Toggle dispatch delivered " << received << " of " << flips << " events.";
+        }
+
+        // Bulk path: every toggle flips once per frame, then the frame's changes are drained
+        const size_t frames = 20;
+        size_t drained = 0;
+        gui->setEventQueue(true, toggles.size());
+        for (size_t frame = 0; frame < frames; frame++) {
+            auto start = Clock::now();
+            for (auto* param : toggles) {
+                param->set(!param->get());
+            }
+            drained += gui->drainEvents().size();
+            samples.push_back(microsSince(start));
+        }
+        gui->setEventQueue(false);
+        addResult("toggle_drain", elements, panels, samples, drained);
+    }
+
+    // Label updates by ID, then through resolved handles
+    if (!labels.empty()) {
+        const size_t frames = 20;
+        std::map<std::string, std::string> labelUpdates[2];
+        for (size_t i : labels) {
+            labelUpdates[0][labelId(i)] = "value " + std::to_string(i);
+            labelUpdates[1][labelId(i)] = "value " + std::to_string(i + 1);
+        }
+        for (size_t frame = 0; frame < frames; frame++) {
+            auto start = Clock::now();
+            gui->updateGuiLabels(labelUpdates[frame % 2]);
+            samples.push_back(microsSince(start));
+        }
+        addResult("update_gui_labels", elements, panels, samples, frames * labels.size());
+
+        std::vector<ofxGuiJson::LabelHandle> handles;
+        for (size_t i : labels) {
+            handles.push_back(gui->getLabelHandle(labelId(i)));
+        }
+        for (size_t frame = 0; frame < frames; frame++) {
+            auto start = Clock::now();
+            for (auto handle : handles) {
+                gui->setLabelTextf(handle, "value %zu", frame);
+            }
+            gui->commitLabelUpdates();
+            samples.push_back(microsSince(start));
+        }
+        addResult("label_handles", elements, panels, samples, frames * handles.size());
+    }
+
+    // Dynamic toggles created and removed one at a time
+    const size_t cycles = 1000;
+    for (size_t c = 0; c < cycles; c++) {
+        auto start = Clock::now();
+        gui->createAndAddToggle("Dynamic", "dynamic");
+        gui->removeLastToggle();
+        samples.push_back(microsSince(start));
+    }
+    addResult("toggle_add_remove", elements, panels, samples, cycles);
+
+    // Rebuild of the main panel holding dynamic toggles
+    const size_t dynamicToggles = 100;
+    const size_t rebuilds = 100;
+    for (size_t t = 0; t < dynamicToggles; t++) {
+        gui->createAndAddToggle("Dynamic", "dynamic");
+    }
+    for (size_t r = 0; r < rebuilds; r++) {
+        auto start = Clock::now();
+        gui->rebuildGui();
+        samples.push_back(microsSince(start));
+    }
+    addResult("rebuild_gui", elements, panels, samples, rebuilds);
+
+    toggleListener.unsubscribe();
+    gui.reset();
+    std::error_code error;
+    std::filesystem::remove(configPath, error);
+    std::filesystem::remove(cachePath, error);
+}
+
+void ofApp::addResult(const std::string& name, size_t elements, size_t panels, std::vector<double>& samples, size_t operations) {
+    BenchmarkResult result;
+    result.name = name;
+    result.elements = elements;
+    result.panels = panels;
+    result.iterations = samples.size();
+    result.operations = operations;
+    if (!samples.empty()) {
+        std::sort(samples.begin(), samples.end());
+        double total = 0;
+        for (double sample : samples) {
+            total += sample;
+        }
+        result.totalMillis = total / 1000.0;
+        result.meanMicros = total / samples.size();
+        result.medianMicros = samples[samples.size() / 2];
+        result.p99Micros = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+        result.opsPerSecond = total > 0 ? operations / (total / 1e6) : 0;
+    }
+    samples.clear();
+
+    std::cout << "  " << name << ": mean " << result.meanMicros << " us, p99 " << result.p99Micros << " us, "
+        << result.opsPerSecond << " ops/s" << std::endl;
+    results.push_back(result);
+}
+
+void ofApp::writeJson(const std::string& path) const {
+    json report;
+    report["format_version"] = 1;
+    report["timestamp"] = ofGetTimestampString();
+    report["panels"] = options.panels;
+    report["repeats"] = options.repeats;
+#ifdef NDEBUG
+    report["build"] = "release";
+#else
+    report["build"] = "debug";
+#endif
+    json& list = report["results"];
+    list = json::array();
+    for (const auto& result : results) {
+        list.push_back({
+            { "name", result.name },
+            { "elements", result.elements },
+            { "panels", result.panels },
+            { "iterations", result.iterations },
+            { "operations", result.operations },
+            { "total_ms", result.totalMillis },
+            { "mean_us", result.meanMicros },
+            { "median_us", result.medianMicros },
+            { "p99_us", result.p99Micros },
+            { "ops_per_sec", result.opsPerSecond }
+        });
+    }
+    std::ofstream file(path);
+    file << report.dump(4) << std::endl;
+}
+
+void ofApp::writeCsv(const std::string& path) const {
+    std::ofstream file(path);
+    file << "name,elements,panels,iterations,operations,total_ms,mean_us,median_us,p99_us,ops_per_sec\n";
+    for (const auto& result : results) {
+        file << result.name << ',' << result.elements << ',' << result.panels << ',' << result.iterations << ','
+            << result.operations << ',' << result.totalMillis << ',' << result.meanMicros << ',' << result.medianMicros << ','
+            << result.p99Micros << ',' << result.opsPerSecond << '\n';
+    }
+}
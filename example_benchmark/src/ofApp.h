@@ -0,0 +1,115 @@
+/**************************************************************************/
+/*!
+    @file     ofApp.h
+
+    @brief    This file defines the ofApp class of the benchmark example. It
+              generates synthetic configurations, measures the load, build,
+              dispatch and label update paths of ofxGuiJson without a window
+              and writes the results as JSON and CSV.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxGui.h"
+#include "ofxGuiJson.h"
+#include <string>
+#include <vector>
+
+/*!
+ *  @struct BenchmarkOptions
+ *  @brief Options of a benchmark run, set from the command line.
+ */
+struct BenchmarkOptions {
+    std::vector<size_t> sizes = { 10, 100, 1000, 10000, 100000 };  //!< Element counts of the generated configurations.
+    size_t panels = 10;                                             //!< Number of panels the elements are spread across.
+    size_t repeats = 5;                                             //!< Repetitions of the load and build measurements.
+    std::string outputPath = "benchmark_results";                   //!< Results path without extension, relative to the data folder.
+};
+
+/*!
+ *  @struct BenchmarkResult
+ *  @brief Timings of one benchmarked path at one configuration size.
+ */
+struct BenchmarkResult {
+    std::string name;           //!< The benchmarked path.
+    size_t elements = 0;        //!< Number of elements in the configuration.
+    size_t panels = 0;          //!< Number of panels in the configuration.
+    size_t iterations = 0;      //!< Number of timed samples.
+    size_t operations = 0;      //!< Number of operations across all samples.
+    double totalMillis = 0;     //!< Sum of all samples.
+    double meanMicros = 0;      //!< Mean sample time.
+    double medianMicros = 0;    //!< Median sample time.
+    double p99Micros = 0;       //!< 99th percentile sample time.
+    double opsPerSecond = 0;    //!< Operations per second over all samples.
+};
+
+/*!
+ *  @class ofApp
+ *  @brief Headless benchmark of ofxGuiJson. Runs once from setup() and exits.
+ *
+ *  Drawing and the cached render mode need a GL context and are not measured. Results ending
+ *  in _headless run on GuiHeadlessBackend, without ofxGui widgets.
+ */
+class ofApp : public ofBaseApp {
+public:
+    /*!
+     *  @brief Creates the benchmark.
+     *  @param runOptions The options of the run.
+     */
+    explicit ofApp(const BenchmarkOptions& runOptions) : options(runOptions) {}
+
+    /*!
+     *  @brief Runs all benchmarks, writes the results and exits.
+     */
+    void setup();
+
+private:
+    /*!
+     *  @brief Writes a synthetic configuration with alternating toggles and labels.
+     *  @param path The path of the file to write.
+     *  @param elements The number of elements.
+     *  @param panels The number of panels.
+     */
+    void writeConfig(const std::string& path, size_t elements, size_t panels);
+
+    /*!
+     *  @brief Runs all benchmarks for one configuration size.
+     *  @param elements The number of elements.
+     */
+    void runSize(size_t elements);
+
+    /*!
+     *  @brief Summarizes timed samples into a result.
+     *  @param name The benchmarked path.
+     *  @param elements The number of elements in the configuration.
+     *  @param panels The number of panels in the configuration.
+     *  @param samples The sample times in microseconds.
+     *  @param operations The number of operations across all samples.
+     */
+    void addResult(const std::string& name, size_t elements, size_t panels, std::vector<double>& samples, size_t operations);
+
+    /*!
+     *  @brief Writes the results as JSON.
+     *  @param path The path of the file to write.
+     */
+    void writeJson(const std::string& path) const;
+
+    /*!
+     *  @brief Writes the results as CSV, one row per result.
+     *  @param path The path of the file to write.
+     */
+    void writeCsv(const std::string& path) const;
+
+    BenchmarkOptions options;               //!< The options of the run.
+    std::vector<BenchmarkResult> results;   //!< The results, in the order they were measured.
+};
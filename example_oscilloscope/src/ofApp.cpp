@@ -4,8 +4,9 @@ void ofApp::setup() {
     ofLogToConsole(); 
     ofSetLogLevel(OF_LOG_VERBOSE);
 
-    // Set up the GUI manager with the configuration file
-    guiManager.setup("config.json");
+    // Load the configuration on a worker thread, the panels appear once it is parsed
+    guiManager.setupAsync("config.json");
+    guiManager.setCachedRendering(true); // Redraw a panel only when one of its widgets changes
 
 }
 
@@ -17,9 +18,7 @@ void ofApp::draw() {
     glGenTextures(1, &defaultTexture);
     glBindTexture(GL_TEXTURE_2D, defaultTexture);
 
-    for (auto& panel : guiManager.getPanels()) {
-        panel->draw();
-    }
+    guiManager.draw();
 
     glBindTexture(GL_TEXTURE_2D, 0); // Unbind the default texture
     glDeleteTextures(1, &defaultTexture); // Clean up the texture
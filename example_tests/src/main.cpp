@@ -0,0 +1,739 @@
+#include "ofMain.h"
+#include "ofxGuiJson.h"
+#include "ofxGuiJsonHeadlessBackend.h"
+#include "ofxGuiJsonLoader.h"
+#include "ofxGuiJsonPool.h"
+#include "ofxGuiJsonRemote.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+//========================================================================
+// Behavior checks of ofxGuiJson, run without a window. Prints every failed
+// check and returns 1 if any failed.
+
+static int failures = 0;
+
+static void check(bool passed, const std::string& what) {
+	if (!passed) {
+		std::cerr << "FAILED: " << what << std::endl;
+		failures++;
+	}
+}
+
+// Writes a file in the temporary directory and returns its path
+static std::string writeTemp(const std::string& name, const std::string& text) {
+	std::string path = (std::filesystem::temp_directory_path() / name).string();
+	std::ofstream(path, std::ios::binary) << text;
+	return path;
+}
+
+static const char* RemoteConfig = R"({
+	"panels": [{
+		"gui": { "title": "Remote" },
+		"elements": [
+			{ "type": "slider", "id": "gain", "label": "Gain", "default": 1, "min": 0, "max": 10 },
+			{ "type": "toggle", "id": "mute", "label": "Mute", "default": false }
+		]
+	}]
+})";
+
+static const char* CacheConfig = R"({
+	"panels": [{
+		"gui": { "title": "Cache", "layout": "column" },
+		"elements": [
+			{ "type": "label", "id": "status", "label": "A label long enough to need a two byte string head" },
+			{ "type": "slider", "id": "gain", "label": "Gain", "default": 0.25, "min": -1, "max": 1, "size": { "width": 120 } },
+			{ "type": "dropdown", "id": "mode", "label": "Mode", "options": ["a", "b", "c"], "default": "b" }
+		]
+	}]
+})";
+
+static const char* BindingConfig = R"({
+	"panels": [{
+		"gui": { "title": "Bindings" },
+		"elements": [
+			{ "type": "label", "id": "frequency", "label": "Frequency", "bind": "audio.frequency", "format": "{:.1f} Hz" },
+			{ "type": "label", "id": "cursor", "label": "Cursor", "bind": ["mouse.x", "mouse.y"], "format": "{{{1:d}, {0}}}" },
+			{ "type": "label", "id": "broken", "label": "Broken", "bind": "audio.frequency", "format": "{1}" }
+		]
+	}]
+})";
+
+//--------------------------------------------------------------
+// Renders a format with one value into a buffer of a given size
+static std::string renderFormat(const std::string& format, GuiValueSample sample, size_t capacity) {
+	GuiLabelFormat compiled;
+	std::string error;
+	if (!compiled.compile(format, 1, error)) {
+		return "error: " + error;
+	}
+	std::vector<char> out(capacity);
+	size_t length = compiled.render(&sample, out.data(), capacity);
+	return std::string(out.data(), length);
+}
+
+//--------------------------------------------------------------
+// Pooled widgets are found through their handles, and a handle of a destroyed widget stays stale
+// when its slot is reused
+static void testPool() {
+	struct Widget {
+		int value = 7;
+	};
+	WidgetPool<Widget> pool;
+	pool.reserve(WidgetPool<Widget>::BlockSize + 1);
+	check(pool.capacity() == 2 * WidgetPool<Widget>::BlockSize, "pool: reserve rounds up to whole blocks");
+
+	WidgetHandle first = pool.create();
+	check(first.index == 0 && pool.get(first) && pool.get(first)->value == 7, "pool: hands out low indices first");
+	pool.destroy(first);
+	WidgetHandle reused = pool.create();
+	check(reused.index == first.index && reused.generation != first.generation, "pool: a reused slot gets a new generation");
+	check(pool.get(first) == nullptr && pool.get(reused) != nullptr, "pool: a stale handle finds nothing");
+	pool.destroy(first);
+	check(pool.size() == 1, "pool: destroying a stale handle is ignored");
+
+	// Past the reserved capacity the pool grows by whole blocks, earlier widgets do not move
+	Widget* reusedWidget = pool.get(reused);
+	std::vector<WidgetHandle> handles;
+	for (size_t i = 0; i < 3 * WidgetPool<Widget>::BlockSize; i++) {
+		handles.push_back(pool.create());
+		pool.get(handles.back())->value = static_cast<int>(i);
+	}
+	bool found = true;
+	for (size_t i = 0; i < handles.size(); i++) {
+		found = found && pool.get(handles[i]) && pool.get(handles[i])->value == static_cast<int>(i);
+	}
+	check(found && pool.get(reused) == reusedWidget, "pool: handles find their widgets across blocks");
+	check(pool.capacity() % WidgetPool<Widget>::BlockSize == 0 && pool.size() == handles.size() + 1, "pool: grows by whole blocks");
+	pool.clear();
+	check(pool.size() == 0 && pool.get(handles.back()) == nullptr, "pool: clear destroys every widget");
+}
+
+//--------------------------------------------------------------
+// A virtual list keeps its rows and shows a window of its source that scrolling moves
+static void testVirtualList() {
+	VectorListSource source;
+	for (int i = 0; i < 100; i++) {
+		VectorListSource::Item item;
+		item.text = "Device " + ofToString(i);
+		source.items.push_back(item);
+	}
+	ofxGuiJsonVirtualList list;
+	list.setup("Devices", GuiElementType::Label, 5, 200, 20);
+	list.setSource(&source);
+	auto rowText = [&](size_t row) {
+		ofxBaseGui* control = list.getControl(row);
+		return control ? control->getName() : std::string();
+	};
+	check(list.getVisibleRows() == 5 && list.getNumControls() == 5, "virtual list: only the visible rows exist");
+	check(rowText(0) == "Device 0" && rowText(4) == "Device 4", "virtual list: rows show the start of the source");
+	check(list.getName() == "Devices (1-5 of 100)", "virtual list: the title shows the window");
+
+	list.scrollTo(40);
+	check(list.getFirstVisible() == 40 && rowText(0) == "Device 40" && rowText(4) == "Device 44", "virtual list: scrolling rebinds the rows");
+	list.scrollTo(1000);
+	check(list.getFirstVisible() == 95 && rowText(4) == "Device 99", "virtual list: scrolling stops at the last full page");
+	list.scrollBy(-10);
+	check(list.getFirstVisible() == 85, "virtual list: scrolls by rows");
+	list.scrollBy(-1000);
+	check(list.getFirstVisible() == 0, "virtual list: scrolling stops at the first item");
+
+	list.scrollTo(95);
+	source.items.resize(7);
+	list.refresh();
+	check(list.getFirstVisible() == 2 && rowText(4) == "Device 6", "virtual list: the window moves up when items are removed");
+	source.items.resize(3);
+	list.refresh();
+	check(list.getFirstVisible() == 0 && rowText(2) == "Device 2" && rowText(3).empty(), "virtual list: rows past the source are empty");
+	check(list.getName() == "Devices", "virtual list: the title has no range when every item is shown");
+	list.setSource(nullptr);
+}
+
+static const char* AudioConfig = R"({
+	"audio_settings": { "sampleRate": 1000 },
+	"panels": [{
+		"gui": { "title": "Audio" },
+		"elements": [
+			{ "type": "slider", "id": "gain", "label": "Gain", "default": 0, "min": 0, "max": 1, "audio_parameter": "gain", "smoothing_ms": 10 }
+		]
+	}]
+})";
+
+//--------------------------------------------------------------
+// Audio parameters smooth towards the published value with a time constant that follows the sample rate
+static void testAudioParameters() {
+	AudioParameter parameter;
+	parameter.reset(0);
+	parameter.setSmoothing(10, 1000);
+	parameter.publish(1);
+	float value = 0;
+	for (int i = 0; i < 10; i++) {
+		value = parameter.next();
+	}
+	check(parameter.get() == 1 && std::abs(value - (1 - std::exp(-1.f))) < 0.01f, "audio: reaches 63% of a step after one time constant");
+	parameter.setSmoothing(0, 1000);
+	check(parameter.next() == 1, "audio: no smoothing jumps to the published value");
+
+	std::string path = writeTemp("ofxGuiJson_tests_audio.json", AudioConfig);
+	ofxGuiJson gui(std::make_unique<GuiHeadlessBackend>());
+	gui.setBinaryCache(false);
+	gui.setup(path);
+	AudioParameter* gain = gui.getAudioBridge().find("gain");
+	check(gain && std::abs(gain->getCoefficient() - (1 - std::exp(-1.f / 10))) < 1e-6f, "audio: smoothing_ms is converted at the configured sample rate");
+
+	std::string reloaded = AudioConfig;
+	reloaded.replace(reloaded.find("1000"), 4, "4000");
+	std::ofstream(path, std::ios::binary) << reloaded;
+	check(gui.reloadConfig() && gui.getAudioBridge().getSampleRate() == 4000, "audio: a reload changes the sample rate");
+	check(gain && gui.getAudioBridge().find("gain") == gain && std::abs(gain->getCoefficient() - (1 - std::exp(-1.f / 40))) < 1e-6f,
+		"audio: a new sample rate keeps the smoothing time of the parameters");
+}
+
+//--------------------------------------------------------------
+// Label formats report their errors, render without overflowing and update bound labels
+static void testBindings() {
+	GuiValueSample number{ GuiValueType::Double, 440.126 };
+	check(renderFormat("{:.2f} Hz", number, 64) == "440.13 Hz", "format: fixed precision");
+	check(renderFormat("{:d}", number, 64) == "440", "format: integer presentation");
+	check(renderFormat("{{{}}}", GuiValueSample{ GuiValueType::Bool, 1 }, 64) == "{true}", "format: escaped braces and booleans");
+	check(renderFormat("{}", GuiValueSample{ GuiValueType::Int, -7 }, 64) == "-7", "format: integers by type");
+	check(renderFormat("Frequency {:.3f}", number, 14) == "Frequency 440", "format: truncated at the end of the buffer");
+	check(renderFormat("{}", number, 1).empty(), "format: a one byte buffer only holds the terminator");
+
+	GuiLabelFormat format;
+	std::string error;
+	check(!format.compile("{", 1, error) && error.find("unterminated") != std::string::npos, "format: unterminated placeholder");
+	check(!format.compile("}", 1, error) && error.find("unmatched") != std::string::npos, "format: unmatched brace");
+	check(!format.compile("{1}", 1, error) && error.find("1 is bound") != std::string::npos, "format: value index out of range");
+	check(!format.compile("{:.2d}", 1, error) && error.find("precision") != std::string::npos, "format: precision on an integer");
+	check(!format.compile("{:x}", 1, error) && error.find("unsupported") != std::string::npos, "format: unsupported presentation");
+
+	auto backend = std::make_unique<GuiHeadlessBackend>();
+	GuiHeadlessBackend& headless = *backend;
+	ofxGuiJson gui(std::move(backend));
+	gui.setBinaryCache(false);
+	gui.setup(writeTemp("ofxGuiJson_tests_bindings.json", BindingConfig));
+	double frequency = 440;
+	int x = 4;
+	gui.registerValue("audio.frequency", &frequency);
+	gui.registerValue("mouse.x", &x);
+	gui.registerValue("mouse.y", [] { return 2.5; });
+	check(gui.updateBindings() == 2, "bindings: every valid bound label renders");
+	check(headless.getLabel(gui.findElement("frequency")) == "440.0 Hz", "bindings: the label shows its format");
+	check(headless.getLabel(gui.findElement("cursor")) == "{3, 4}", "bindings: values by index");
+	check(headless.getLabel(gui.findElement("broken")) == "Broken", "bindings: an invalid format keeps the label text");
+	check(gui.updateBindings() == 0, "bindings: unchanged values render nothing");
+	frequency = 440.01;
+	check(gui.updateBindings() == 0, "bindings: a change hidden by the format renders nothing");
+	frequency = 512;
+	check(gui.updateBindings() == 1 && headless.getLabel(gui.findElement("frequency")) == "512.0 Hz", "bindings: a changed value renders");
+}
+
+//--------------------------------------------------------------
+// Returns the index of an element in a model, or the size of the model
+static size_t findElement(const GuiModel& model, const std::string& id) {
+	for (size_t i = 0; i < model.size(); i++) {
+		if (model.ids[i] < model.idNames.size() && model.idNames[model.ids[i]] == id) {
+			return i;
+		}
+	}
+	return model.size();
+}
+
+//--------------------------------------------------------------
+// Includes, templates and repeats expand before the configuration is compiled
+static void testComposition() {
+	writeTemp("ofxGuiJson_tests_part.json", R"([{ "type": "button", "id": "play", "label": "Play" }])");
+	std::string path = writeTemp("ofxGuiJson_tests_compose.json", R"({
+		"$templates": { "knob": { "type": "slider", "id": "${name}", "label": "Knob ${name}", "min": 0, "max": "${max}" } },
+		"panels": [{ "gui": { "title": "Mixer" }, "elements": [
+			{ "$include": "ofxGuiJson_tests_part.json" },
+			{ "$template": "knob", "name": "gain", "max": 2 },
+			{ "repeat": { "count": 3, "id_pattern": "mute${i}", "layout": "column" }, "type": "toggle", "label": "Mute ${i}",
+			  "position": { "x": 10, "y": 100 }, "size": { "width": 120, "height": 20 } }
+		]}]
+	})");
+	GuiModelLoader loader;
+	GuiModel model;
+	check(loader.load(path, model) && model.size() == 5, "compose: the configuration expands");
+	check(loader.getDependencies().size() == 1, "compose: the included file is recorded");
+	size_t play = findElement(model, "play");
+	check(play == 0 && model.labels[play] == "Play", "compose: an included array is spliced in place");
+	size_t gain = findElement(model, "gain");
+	check(gain < model.size() && model.labels[gain] == "Knob gain" && model.maxs[gain] == 2,
+		"compose: parameters are substituted, with their type when alone in a string");
+	size_t mute = findElement(model, "mute2");
+	check(mute < model.size() && model.labels[mute] == "Mute 2" && model.rects[mute].y == 140, "compose: repeats are numbered and offset");
+
+	// Errors leave nothing half loaded
+	writeTemp("ofxGuiJson_tests_cycle_a.json", R"({ "panels": [{ "gui": { "title": "A" }, "elements": [{ "$include": "ofxGuiJson_tests_cycle_b.json" }] }] })");
+	writeTemp("ofxGuiJson_tests_cycle_b.json", R"({ "$include": "ofxGuiJson_tests_cycle_a.json" })");
+	std::string cycle = (std::filesystem::temp_directory_path() / "ofxGuiJson_tests_cycle_a.json").string();
+	check(!loader.load(cycle, model) && model.size() == 0, "compose: an include cycle is an error");
+	std::string missing = writeTemp("ofxGuiJson_tests_missing.json", R"({
+		"$templates": { "knob": { "type": "slider", "id": "${name}", "max": "${max}" } },
+		"panels": [{ "gui": { "title": "Mixer" }, "elements": [{ "$template": "knob", "name": "gain" }] }]
+	})");
+	check(!loader.load(missing, model) && model.size() == 0, "compose: a parameter without a value is an error");
+	std::string huge = writeTemp("ofxGuiJson_tests_huge.json", R"({
+		"panels": [{ "gui": { "title": "Mixer" }, "elements": [{ "repeat": { "count": 1000000000 }, "type": "toggle", "label": "Mute" }] }]
+	})");
+	check(!loader.load(huge, model) && model.size() == 0, "compose: a repeat count over the limit is an error");
+	std::string nested = writeTemp("ofxGuiJson_tests_nested.json", R"({
+		"$templates": { "row": [{ "repeat": { "count": 1000 }, "type": "toggle", "label": "Mute" }] },
+		"panels": [{ "gui": { "title": "Mixer" }, "elements": [{ "repeat": { "count": 1000 }, "$template": "row" }] }]
+	})");
+	check(!loader.load(nested, model) && model.size() == 0, "compose: nested repeats share the limit");
+
+	// Only keys select the composition stage, not string values that look like them
+	auto uses = [](const std::string& text) { return GuiConfigComposer::usesComposition(text.data(), text.size()); };
+	check(uses(R"({ "repeat" : { "count": 2 } })") && uses(R"({ "$templates": {} })") && uses(R"({"$include":"a.json"})"),
+		"compose: composition keys are found");
+	check(!uses(R"({ "label": "repeat", "action": "$include" })") && !uses(R"({ "label": "\"repeat\": 2" })") && !uses(R"({ "repeats": 2 })"),
+		"compose: values and other keys are not composition keys");
+}
+
+static const char* InvalidConfig = R"({
+	"panels": [
+		{ "gui": { "title": "Broken" }, "elements": [
+			{ "type": "toggle", "id": "mute", "defualt": true },
+			{ "type": "sliderr", "id": "gain" },
+			{ "type": "slider", "id": "level", "min": "low" }
+		]},
+		{ "elements": [] }
+	]
+})";
+
+//--------------------------------------------------------------
+// Returns whether an error was reported at a JSON pointer
+static bool hasSchemaError(const std::vector<GuiSchemaError>& errors, const std::string& pointer) {
+	return std::any_of(errors.begin(), errors.end(), [&](const GuiSchemaError& error) { return error.pointer == pointer; });
+}
+
+//--------------------------------------------------------------
+// Schema errors point at the offending value, whether the text is streamed or parsed into a DOM
+static void testSchema() {
+	std::string path = writeTemp("ofxGuiJson_tests_invalid.json", InvalidConfig);
+	std::filesystem::remove(GuiModelLoader::cachePath(path));
+	GuiModelLoader loader;
+	loader.setUseCache(true);
+	for (bool dom : { false, true }) {
+		std::string what = dom ? "schema (DOM): " : "schema (SAX): ";
+		GuiModel model;
+		json config;
+		check(!loader.load(path, model, dom ? &config : nullptr) && model.size() == 0, what + "an invalid configuration does not load");
+		const std::vector<GuiSchemaError>& errors = loader.getSchemaErrors();
+		check(errors.size() == 4, what + "every error is reported");
+		check(hasSchemaError(errors, "/panels/0/elements/0/defualt"), what + "unknown key");
+		check(hasSchemaError(errors, "/panels/0/elements/1/type"), what + "value outside the enumeration");
+		check(hasSchemaError(errors, "/panels/0/elements/2/min"), what + "value of the wrong type");
+		check(hasSchemaError(errors, "/panels/1"), what + "missing required key");
+	}
+	check(!std::filesystem::exists(GuiModelLoader::cachePath(path)), "schema: an invalid configuration is not cached");
+}
+
+//--------------------------------------------------------------
+// A cache miss compiles the text with the SAX handler and writes the cache from the same pass
+static void testCache() {
+	std::string path = writeTemp("ofxGuiJson_tests_cache.json", CacheConfig);
+	std::filesystem::remove(GuiModelLoader::cachePath(path));
+	GuiModelLoader loader;
+	loader.setUseCache(true);
+	GuiModel parsed;
+	check(loader.load(path, parsed) && !loader.getStats().fromCache, "cache: the text loads");
+	check(std::filesystem::exists(GuiModelLoader::cachePath(path)), "cache: a miss writes the cache");
+
+	GuiModel cached;
+	check(loader.load(path, cached) && loader.getStats().fromCache, "cache: the next load reads the cache");
+	check(cached.size() == 3 && cached.labels == parsed.labels && cached.defaults == parsed.defaults &&
+		cached.options == parsed.options && cached.fixedSizes == parsed.fixedSizes, "cache: the cache compiles to the same model");
+
+	json config;
+	GuiModel retained;
+	check(loader.load(path, retained, &config) && loader.getStats().fromCache && config["panels"][0]["elements"].size() == 3,
+		"cache: the cache decodes into a DOM");
+
+	GuiModelLoader unvalidated;
+	unvalidated.setUseCache(true);
+	unvalidated.setValidate(false);
+	std::filesystem::remove(GuiModelLoader::cachePath(path));
+	check(unvalidated.load(path, parsed) && !std::filesystem::exists(GuiModelLoader::cachePath(path)),
+		"cache: not written without validation");
+}
+
+static const char* ElementKeysConfig = R"({
+	"panels": [{
+		"gui": { "title": "Keys", "layout": "grid", "columns": 2 },
+		"elements": [
+			{ "type": "label", "id": "status", "label": "Status", "size": { "width": "wide", "height": 20 }, "bind": "audio.level" },
+			{ "type": "dropdown", "id": "mode", "label": "Mode", "options": ["a", 2, "c"], "default": "c", "position": { "x": 5, "y": 7 } },
+			{ "type": "group", "layout": "row", "size": { "width": 90 }, "elements": [
+				{ "type": "int_slider", "id": "count", "min": 10, "max": 0, "default": 4, "max_rate": 20 }
+			]}
+		]
+	}]
+})";
+
+//--------------------------------------------------------------
+// The DOM compiler and the SAX loader read element keys through the same setter
+static void testElementKeys() {
+	std::string path = writeTemp("ofxGuiJson_tests_keys.json", ElementKeysConfig);
+	GuiModelLoader loader;
+	loader.setValidate(false);
+	GuiModel streamed;
+	GuiModel compiled;
+	json config;
+	check(loader.load(path, streamed), "keys: the SAX loader compiles the configuration");
+	check(loader.load(path, compiled, &config), "keys: the DOM compiler compiles the configuration");
+	check(streamed.size() == 3 && streamed.fixedSizes == compiled.fixedSizes && streamed.rects == compiled.rects &&
+		streamed.defaults == compiled.defaults && streamed.options == compiled.options && streamed.binds == compiled.binds &&
+		streamed.mins == compiled.mins && streamed.maxRates == compiled.maxRates, "keys: both paths compile the same elements");
+	check(streamed.size() == 3 && streamed.fixedSizes[0] == GuiFixedHeight, "keys: a size that is not a number is not fixed");
+	check(streamed.groups.size() == 1 && compiled.groups.size() == 1 && streamed.groups[0].fixedSize == GuiFixedWidth &&
+		compiled.groups[0].fixedSize == GuiFixedWidth && compiled.groups[0].layout.type == GuiLayoutType::Row, "keys: groups read the same keys");
+}
+
+//--------------------------------------------------------------
+// Binary snapshots read back what was written and reject damaged files
+static void testSnapshot() {
+	GuiSnapshot saved;
+	GuiSnapshot::Entry toggle;
+	toggle.id = "mute";
+	toggle.value.toggle = true;
+	GuiSnapshot::Entry slider;
+	slider.id = "gain";
+	slider.type = GuiEventType::Float;
+	slider.value.number = 0.75f;
+	GuiSnapshot::Entry choice;
+	choice.id = "mode";
+	choice.type = GuiEventType::Choice;
+	choice.value.integer = 2;
+	saved.entries = { toggle, slider, choice };
+
+	std::string bytes = saved.toBinary();
+	GuiSnapshot loaded;
+	check(loaded.fromBinary(bytes.data(), bytes.size()) && loaded.entries.size() == 3, "snapshot: the binary format reads back");
+	const GuiSnapshot::Entry* found = loaded.find("gain");
+	check(found && found->type == GuiEventType::Float && found->value.number == 0.75f, "snapshot: values keep their type");
+	found = loaded.find("mode");
+	check(found && found->type == GuiEventType::Choice && found->value.integer == 2, "snapshot: choices keep their index");
+
+	std::string damaged = bytes;
+	damaged[damaged.size() - 1] ^= 0x5A;
+	check(!loaded.fromBinary(damaged.data(), damaged.size()) && loaded.entries.size() == 3, "snapshot: a damaged payload is rejected");
+	check(!loaded.fromBinary(bytes.data(), bytes.size() - 1), "snapshot: a truncated file is rejected");
+
+	// The entry count is outside the hashed payload, so a forged count must not reserve memory for it
+	GuiSnapshotHeader header;
+	std::memcpy(&header, bytes.data(), sizeof(header));
+	header.entryCount = UINT64_MAX / 2;
+	std::string forged = bytes;
+	std::memcpy(&forged[0], &header, sizeof(header));
+	check(!loaded.fromBinary(forged.data(), forged.size()), "snapshot: an entry count larger than the payload is rejected");
+}
+
+static const char* HeadlessConfig = R"({
+	"panels": [
+		{ "gui": { "title": "Audio" }, "elements": [
+			{ "type": "toggle", "id": "mute", "label": "Mute", "action": "toggleMute" },
+			{ "type": "slider", "id": "gain", "label": "Gain", "default": 1, "min": 0, "max": 10 }
+		]},
+		{ "gui": { "title": "Transport" }, "elements": [
+			{ "type": "button", "id": "play", "label": "Play" },
+			{ "type": "dropdown", "id": "mode", "label": "Mode", "options": ["a", "b", "c"], "default": "b" }
+		]}
+	]
+})";
+
+//--------------------------------------------------------------
+// Changes are dispatched and redraw only their panel without any widget
+static void testHeadless() {
+	auto backend = std::make_unique<GuiHeadlessBackend>();
+	GuiHeadlessBackend& headless = *backend;
+	ofxGuiJson gui(std::move(backend));
+	gui.setBinaryCache(false);
+	gui.setup(writeTemp("ofxGuiJson_tests_headless.json", HeadlessConfig));
+	check(headless.getPanelCount() == 2 && headless.getElementCount() == 4, "headless: every element is created");
+	check(gui.getElementValue("gain") == 1 && gui.getElementValue("mode") == 1, "headless: defaults are applied");
+
+	std::vector<GuiEvent> events;
+	ofEventListener listener = gui.onChange.newListener([&](GuiEvent& event) { events.push_back(event); });
+	gui.setCachedRendering(true);
+	gui.draw();
+	check(!gui.getDirtyTracker().isDirty(0) && !gui.getDirtyTracker().isDirty(1), "headless: a cached draw() renders every panel");
+
+	check(gui.setElementValue("mute", 1) && events.size() == 1, "headless: a toggle is notified at once");
+	if (events.size() == 1) {
+		check(gui.getName(events[0].id) == "mute" && events[0].actionKey == guiHash("toggleMute") && events[0].asBool(),
+			"headless: the event carries the ID, action and value");
+	}
+	check(gui.getDirtyTracker().isDirty(0) && !gui.getDirtyTracker().isDirty(1), "headless: only the panel of the change is dirty");
+
+	check(gui.setElementValue("gain", 4) && gui.setElementValue("gain", 5) && events.size() == 1, "headless: slider changes are coalesced");
+	check(gui.flushChanges() == 1 && events.size() == 2 && events.back().asFloat() == 5, "headless: the latest slider value is notified once");
+	check(gui.setElementValue("play", 0) && events.size() == 3 && events.back().type == GuiEventType::Trigger, "headless: a button is clicked");
+	check(!gui.setElementValue("missing", 1), "headless: an unknown ID is rejected");
+
+	// Widget accessors return placeholders of this instance that nothing is kept in
+	ofxGuiJson other(std::make_unique<GuiHeadlessBackend>());
+	gui.getPanels().push_back(std::make_shared<ofxPanel>());
+	check(gui.getPanels().empty() && &gui.getGui() != &other.getGui(), "headless: widget accessors return placeholders of the instance");
+}
+
+static const char* LayoutConfig = R"({
+	"panels": [{
+		"gui": { "title": "Layout", "width": 400, "layout": "column", "gap": 6, "padding": 10 },
+		"elements": [
+			{ "type": "toggle", "id": "enable", "label": "Enable", "size": { "height": 20 } },
+			{ "type": "slider", "id": "gain", "label": "Gain", "size": { "width": 120, "height": 30 } },
+			{ "type": "group", "layout": "row", "gap": 4, "elements": [
+				{ "type": "button", "id": "scan", "label": "Scan", "size": { "width": 50, "height": 20 } },
+				{ "type": "label", "id": "status", "label": "Idle", "size": { "height": 20 } },
+				{ "type": "button", "id": "stop", "label": "Stop", "size": { "width": 50, "height": 20 } }
+			]},
+			{ "type": "group", "layout": "grid", "columns": 2, "gap": 0, "size": { "width": 200 }, "elements": [
+				{ "type": "toggle", "id": "cell0", "label": "0", "size": { "height": 20 } },
+				{ "type": "toggle", "id": "cell1", "label": "1", "size": { "height": 20 } },
+				{ "type": "toggle", "id": "cell2", "label": "2", "size": { "height": 20 } }
+			]}
+		]
+	}]
+})";
+
+//--------------------------------------------------------------
+// Column, row and grid layouts place the elements, and a label that grows moves only what follows it
+static void testLayout() {
+	auto backend = std::make_unique<GuiHeadlessBackend>();
+	GuiHeadlessBackend& headless = *backend;
+	ofxGuiJson gui(std::move(backend));
+	gui.setBinaryCache(false);
+	gui.setup(writeTemp("ofxGuiJson_tests_layout.json", LayoutConfig));
+	auto rect = [&](const std::string& id) {
+		const GuiHeadlessBackend::Element* element = headless.getElement(gui.findElement(id));
+		return element ? element->rect : ofRectangle();
+	};
+
+	check(rect("enable") == ofRectangle(10, 10, 380, 20), "layout: a column places at its padding and stretches to its width");
+	check(rect("gain") == ofRectangle(10, 36, 120, 30), "layout: a column stacks with its gap and keeps a fixed width");
+	check(rect("scan") == ofRectangle(10, 72, 50, 20), "layout: a group is placed like an element");
+	check(rect("status").x == 64 && rect("stop").x == rect("status").getRight() + 4, "layout: a row places side by side");
+	check(rect("cell0") == ofRectangle(10, 98, 100, 20) && rect("cell1") == ofRectangle(110, 98, 100, 20) &&
+		rect("cell2") == ofRectangle(10, 118, 100, 20), "layout: a grid fills rows of equal cells");
+
+	ofRectangle status = rect("status");
+	ofRectangle cell = rect("cell0");
+	ofxGuiJson::LabelHandle handle = gui.getLabelHandle("status");
+	gui.setLabelText(handle, "Scanning for devices on every port");
+	check(gui.commitLabelUpdates() == 1 && rect("status").width > status.width, "layout: a longer label is measured again");
+	check(rect("stop").x == rect("status").getRight() + 4 && rect("scan").x == 10, "layout: only the elements after a grown label move");
+	check(rect("cell0") == cell, "layout: other groups keep their place");
+}
+
+//--------------------------------------------------------------
+// The ofxGui backend keeps the layout rects instead of stacking the widgets, also after a reload
+static void testWidgetLayout() {
+	std::string path = writeTemp("ofxGuiJson_tests_widget_layout.json", LayoutConfig);
+	ofxGuiJson gui;
+	gui.setBinaryCache(false);
+	gui.setup(path);
+	auto shape = [&](const std::string& id) {
+		ofxBaseGui* widget = gui.getGuiWidget(id);
+		return widget ? widget->getShape() : ofRectangle();
+	};
+	auto checkShapes = [&](float gap, const std::string& when) {
+		ofRectangle enable = shape("enable");
+		ofRectangle gain = shape("gain");
+		check(enable.width == 380 && enable.height == 20, "widget layout: a column stretches its element " + when);
+		check(gain.x == enable.x && gain.y == enable.getBottom() + gap && gain.width == 120, "widget layout: a column stacks with its gap " + when);
+		check(shape("status").x == shape("scan").getRight() + 4 && shape("status").y == shape("scan").y, "widget layout: a row places side by side " + when);
+		check(shape("cell1").x == shape("cell0").x + 100 && shape("cell2").y == shape("cell0").getBottom(), "widget layout: a grid fills rows " + when);
+		check(gui.getPanels()[0]->getShape().getBottom() > shape("cell2").getBottom(), "widget layout: the panel encloses its elements " + when);
+	};
+	checkShapes(6, "after setup");
+
+	std::string reloaded = LayoutConfig;
+	reloaded.replace(reloaded.find("\"gap\": 6"), 8, "\"gap\": 9");
+	std::ofstream(path, std::ios::binary) << reloaded;
+	check(gui.reloadConfig(), "widget layout: reloads");
+	checkShapes(9, "after a reload");
+}
+
+//--------------------------------------------------------------
+// Removing a dynamic toggle moves the toggles below it up by one row, once
+static void testDynamicToggles() {
+	ofxGuiJson gui;
+	gui.setBinaryCache(false);
+	gui.setup(writeTemp("ofxGuiJson_tests_toggles.json", RemoteConfig));
+	gui.getGui().setup("Toggles");
+	WidgetHandle first = gui.createAndAddToggle("First", "dynamic");
+	WidgetHandle middle = gui.createAndAddToggle("Middle", "dynamic");
+	gui.createAndAddToggle("Last", "dynamic");
+	auto shape = [&](const std::string& id) {
+		ofxBaseGui* widget = gui.getGuiWidget(id);
+		return widget ? widget->getShape() : ofRectangle();
+	};
+	ofRectangle firstShape = shape("dynamic0");
+	ofRectangle middleShape = shape("dynamic1");
+	check(first.isValid() && middleShape.y == firstShape.getBottom() + 10, "toggles: stack in a column");
+
+	check(gui.removeDynamicToggle(middle), "toggles: a middle toggle is removed");
+	check(gui.getGuiWidget("dynamic1") == nullptr, "toggles: the removed toggle is released");
+	check(shape("dynamic0") == firstShape, "toggles: rows above stay");
+	check(shape("dynamic2") == middleShape, "toggles: rows below move up by one row");
+	check(gui.getGui().getShape().getBottom() < middleShape.getBottom() + 20, "toggles: the panel shrinks");
+}
+
+//--------------------------------------------------------------
+// Names are interned once, and element IDs stay the same across a reload
+static void testIds() {
+	static_assert(guiHash("toggleMute") == guiHash("toggleMute", 10), "guiHash is a constant expression");
+	GuiStringTable table;
+	GuiId mute = table.intern("mute");
+	GuiId gain = table.intern("gain");
+	check(mute.isValid() && mute != gain && table.intern("mute") == mute && table.size() == 2, "ids: a name is interned once");
+	check(table.find("gain") == gain && !table.find("missing").isValid() && table.size() == 2, "ids: find does not intern");
+	check(table.name(gain) == "gain" && table.name(GuiId()).empty(), "ids: an ID returns its name");
+	check(table.hash(mute) == guiHash("mute") && table.hash(GuiId()) == 0, "ids: an ID returns the hash of its name");
+
+	std::string path = writeTemp("ofxGuiJson_tests_ids.json", HeadlessConfig);
+	ofxGuiJson gui(std::make_unique<GuiHeadlessBackend>());
+	gui.setBinaryCache(false);
+	gui.setup(path);
+	GuiId before = gui.getGuiId("gain");
+	std::string renamed = HeadlessConfig;
+	renamed.replace(renamed.find("\"title\": \"Audio\""), 16, "\"title\": \"Mixer\"");
+	std::ofstream(path, std::ios::binary) << renamed;
+	check(gui.reloadConfig(), "ids: reloads");
+	check(before.isValid() && gui.getGuiId("gain") == before && gui.getName(before) == "gain", "ids: an element keeps its ID across a reload");
+	check(!gui.getGuiId("missing").isValid(), "ids: looking up an unknown ID does not intern it");
+}
+
+//--------------------------------------------------------------
+// The profiler times and counts the work of a frame, and exports the recorded scopes as a Chrome trace
+static void testProfiler() {
+	ofxGuiJson gui(std::make_unique<GuiHeadlessBackend>());
+	gui.setBinaryCache(false);
+	gui.setup(writeTemp("ofxGuiJson_tests_profiler.json", HeadlessConfig));
+	GuiProfiler& profiler = gui.getProfiler();
+	gui.setProfiling(true, 4);
+	profiler.setTracing(true);
+
+	gui.setElementValue("mute", 1);
+	gui.setElementValue("play", 0);
+	check(profiler.getCurrentFrame().getCount(GuiCounter::EventsFired) == 2, "profiler: counts the events of the frame");
+	profiler.endFrame();
+	const GuiFrameStats& frame = profiler.getLastFrame();
+	check(frame.getCount(GuiCounter::EventsFired) == 2 && frame.calls[static_cast<size_t>(GuiProfileScope::Dispatch)] == 2,
+		"profiler: a completed frame keeps its counters and scopes");
+	check(profiler.getCurrentFrame().getCount(GuiCounter::EventsFired) == 0, "profiler: the next frame starts from zero");
+	for (int i = 0; i < 6; i++) {
+		profiler.endFrame();
+	}
+	check(profiler.getHistorySize() == 4, "profiler: keeps the requested number of frames");
+
+	std::string path = (std::filesystem::temp_directory_path() / "ofxGuiJson_tests_trace.json").string();
+	check(profiler.writeChromeTrace(path), "profiler: writes the trace");
+	json trace = json::parse(std::ifstream(path), nullptr, false);
+	size_t dispatches = 0;
+	size_t counters = 0;
+	if (!trace.is_discarded() && trace["traceEvents"].is_array()) {
+		for (const auto& event : trace["traceEvents"]) {
+			dispatches += event["name"] == "dispatch" && event["ph"] == "X";
+			counters += event["name"] == "counters" && event["ph"] == "C";
+		}
+	}
+	check(dispatches == 2, "profiler: the trace has one complete event per timed scope");
+	check(counters == 7 && trace["traceEvents"][2]["args"]["events"] == 2, "profiler: the trace has the counters of every frame");
+
+	gui.setProfiling(false);
+	gui.setElementValue("mute", 0);
+	check(profiler.getCurrentFrame().getCount(GuiCounter::EventsFired) == 0, "profiler: counts nothing while disabled");
+}
+
+//--------------------------------------------------------------
+// Handles the datagrams waiting at the app, then collects the replies of the client
+static void pumpRemote(ofxGuiJson& gui, GuiRemoteClient& client, std::vector<GuiRemoteMessage>& replies, std::vector<std::string>& ids) {
+	for (int attempt = 0; attempt < 50 && replies.empty(); attempt++) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		gui.updateRemote();
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		client.receive([&](const GuiRemoteMessage& message) {
+			replies.push_back(message);
+			ids.emplace_back(message.id);
+		});
+	}
+}
+
+//--------------------------------------------------------------
+static void testRemote() {
+	ofxGuiJson gui(std::make_unique<GuiHeadlessBackend>());
+	gui.setBinaryCache(false);
+	gui.setup(writeTemp("ofxGuiJson_tests_remote.json", RemoteConfig));
+	check(gui.setRemoteControl(true, 0), "remote: starts on a free port");
+	GuiRemoteClient client;
+	check(client.connect(gui.getRemoteEndpoint()->getPort()), "remote: client connects");
+
+	// Set then get in one datagram: the value is answered and the sequence echoed
+	client.set("gain", 4.f);
+	client.get("gain");
+	client.get("missing");
+	uint32_t sequence = client.getSequence();
+	check(client.send(), "remote: client sends");
+	std::vector<GuiRemoteMessage> replies;
+	std::vector<std::string> ids;
+	pumpRemote(gui, client, replies, ids);
+	check(replies.size() == 2, "remote: one reply per get");
+	if (replies.size() == 2) {
+		check(replies[0].op == GuiRemoteOp::Value && ids[0] == "gain" && replies[0].asFloat() == 4.f, "remote: get reads the set value");
+		check(replies[1].op == GuiRemoteOp::Error && ids[1] == "missing", "remote: get of an unknown ID is an error");
+	}
+	check(client.getReplySequence() == sequence, "remote: reply echoes the sequence of its datagram");
+	check(gui.getElementValue("gain") == 4.f, "remote: set changes the element");
+
+	// Two datagrams handled in one frame: the queued replies echo the later one
+	client.get("mute");
+	check(client.send(), "remote: client sends the first datagram");
+	client.set("mute", true);
+	client.get("mute");
+	sequence = client.getSequence();
+	check(client.send(), "remote: client sends the second datagram");
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	replies.clear();
+	ids.clear();
+	pumpRemote(gui, client, replies, ids);
+	check(replies.size() == 2 && replies.back().asFloat() == 1, "remote: replies of both datagrams arrive in order");
+	check(client.getReplySequence() == sequence, "remote: replies echo the latest datagram");
+}
+
+//--------------------------------------------------------------
+int main() {
+	ofSetLogLevel(OF_LOG_ERROR);
+	testPool();
+	testVirtualList();
+	testAudioParameters();
+	testBindings();
+	testComposition();
+	testElementKeys();
+	testSchema();
+	testCache();
+	testSnapshot();
+	testHeadless();
+	testIds();
+	testProfiler();
+	testLayout();
+	testWidgetLayout();
+	testDynamicToggles();
+	testRemote();
+
+	if (failures > 0) {
+		std::cerr << failures << " checks failed" << std::endl;
+		return 1;
+	}
+	std::cout << "All checks passed" << std::endl;
+	return 0;
+}
@@ -1,215 +1,1388 @@
 
 #include "ofxGuiJson.h"
 
-void ofxGuiJson::setup(const std::string& path) {
+// Minimum time between notifications of a coalesced element, 0 to notify once per frame
+static uint64_t rateToIntervalMillis(float maxRate) {
+    return maxRate > 0 ? static_cast<uint64_t>(1000.f / maxRate) : 0;
+}
+
+ofxGuiJson::ofxGuiJson() : ofxGuiJson(std::make_unique<GuiWidgetBackend>()) {
+}
+
+ofxGuiJson::ofxGuiJson(std::unique_ptr<GuiBackend> guiBackend) : backend(std::move(guiBackend)) {
+    widgets = dynamic_cast<GuiWidgetBackend*>(backend.get());
+}
+
+ofxGuiJson::~ofxGuiJson() {
+    if (!traceFile.empty()) {
+        writeChromeTrace(traceFile);
+    }
+    if (pendingSave.valid()) {
+        pendingSave.get();
+    }
+    if (!autosavePath.empty() && stateChanged) {
+        state->save(autosavePath, GuiSnapshot::formatOf(autosavePath));  // Last changes before exit
+    }
+    clearGui();
+}
+
+void ofxGuiJson::setup(const std::string& path, bool watchConfig) {
+    GuiProfiler::ScopedTimer timer(profiler, GuiProfileScope::Setup);
     std::string fullPath = ofToDataPath(path, true);  // Resolve the full path here
     loadJson(fullPath);  // Pass the full path to loadJson
+    finishSetup(fullPath, watchConfig);
+}
+
+void ofxGuiJson::setupAsync(const std::string& path, bool watchConfig) {
+    if (asyncLoad.valid()) {
+        ofLogError() << "setupAsync called while a previous setup is still loading.";
+        return;
+    }
+    std::string fullPath = ofToDataPath(path, true);
+    bool retain = retainConfig;
+    bool useCache = binaryCache;
+    bool validate = schemaValidation;
+    asyncWatchConfig = watchConfig;
+    asyncPath = fullPath;
+    setupComplete = false;
+
+    // File I/O and parsing happen on the worker, widgets are created on the main thread
+    asyncLoad = std::async(std::launch::async, [fullPath, retain, useCache, validate]() {
+        AsyncLoad result;
+        GuiModelLoader loader;
+        loader.setUseCache(useCache);
+        loader.setValidate(validate);
+        loader.setIncludeCache(&result.includes);
+        result.loaded = loader.load(fullPath, result.model, retain ? &result.config : nullptr);
+        result.stats = loader.getStats();
+        result.dependencies = loader.getDependencies();
+        return result;
+    });
+    asyncListener = ofEvents().update.newListener(this, &ofxGuiJson::checkAsyncSetup);
+}
+
+void ofxGuiJson::checkAsyncSetup(ofEventArgs&) {
+    if (!asyncLoad.valid() || asyncLoad.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+    AsyncLoad result = asyncLoad.get();
+    asyncListener.unsubscribe();
+
+    model = std::move(result.model);
+    config = std::move(result.config);
+    loadStats = result.stats;
+    includeCache = std::move(result.includes);
+    configDependencies = std::move(result.dependencies);
+    if (result.loaded) {
+        finishLoad(asyncPath);
+    }
+    finishSetup(asyncPath, asyncWatchConfig);
+
+    bool loaded = result.loaded;
+    ofNotifyEvent(onSetupComplete, loaded, this);
+}
+
+void ofxGuiJson::finishSetup(const std::string& fullPath, bool watchConfig) {
+    applyProfilerSettings();
     setBackgroundColor();  // Set background color based on JSON config
     parseGuiElements();
+    configPath = fullPath;
+    setWatchConfig(watchConfig);
+    setupComplete = true;
 }
 
-void ofxGuiJson::loadJson(const std::string& fullPath) {
-    std::ifstream i(fullPath);
-    if (!i.is_open()) {
-        ofLogError() << "Failed to open JSON config file: " << fullPath;
+void ofxGuiJson::setWatchConfig(bool watch, uint64_t intervalMillis) {
+    watchInterval = intervalMillis;
+    if (!watch) {
+        watchListener.unsubscribe();
+        watchedFiles.clear();
         return;
     }
+    watchConfigFiles();
+    lastWatchCheck = ofGetElapsedTimeMillis();
+    watchListener = ofEvents().update.newListener(this, &ofxGuiJson::checkConfigChanged);
+}
 
-    try {
-        i >> config;
-        ofLogNotice() << "JSON loaded successfully from: " << fullPath;
-        ofLogVerbose() << "JSON Content: " << config.dump(4); // Dump JSON content with indentation for easier reading
+void ofxGuiJson::watchConfigFiles() {
+    std::error_code error;
+    watchedFiles.clear();
+    watchedFiles.push_back({ configPath, std::filesystem::last_write_time(configPath, error) });
+    for (const auto& dependency : configDependencies) {
+        watchedFiles.push_back({ dependency.path, std::filesystem::last_write_time(dependency.path, error) });
+    }
+}
+
+void ofxGuiJson::checkConfigChanged(ofEventArgs&) {
+    uint64_t now = ofGetElapsedTimeMillis();
+    if (now - lastWatchCheck < watchInterval) {
+        return;
+    }
+    lastWatchCheck = now;
+
+    // The configuration and the files it includes; only the changed files are parsed again
+    const std::string* changedPath = nullptr;
+    for (auto& file : watchedFiles) {
+        std::error_code error;
+        auto writeTime = std::filesystem::last_write_time(file.path, error);
+        if (!error && writeTime != file.writeTime) {
+            file.writeTime = writeTime;
+            changedPath = &file.path;
+        }
+    }
+    if (!changedPath) {
+        return;
+    }
+    ofLogNotice() << "Config file changed, reloading: " << *changedPath;
+    reloadConfig();
+}
+
+bool ofxGuiJson::reloadConfig() {
+    GuiModel nextModel;
+    json nextConfig;
+    GuiModelLoader loader;
+    loader.setUseCache(binaryCache);
+    loader.setValidate(schemaValidation);
+    loader.setIncludeCache(&includeCache);
+    bool loaded;
+    {
+        GuiProfiler::ScopedTimer timer(profiler, GuiProfileScope::LoadJson);
+        loaded = loader.load(configPath, nextModel, retainConfig ? &nextConfig : nullptr);
+    }
+    if (!loaded) {
+        ofLogError() << "Reload failed, keeping the current GUI.";
+        return false;
+    }
+    loadStats = loader.getStats();
+    configDependencies = loader.getDependencies();
+    if (!watchedFiles.empty()) {
+        watchConfigFiles();  // The configuration may include other files now
+    }
+    config = std::move(nextConfig);
+    if (nextModel.settings.audio.sampleRate > 0) {
+        audioBridge.setSampleRate(static_cast<float>(nextModel.settings.audio.sampleRate));
+    }
+
+    reconcile(nextModel);
+    setBackgroundColor();
+    applyProfilerSettings();
+    return true;
+}
+
+void ofxGuiJson::reconcile(GuiModel& nextModel) {
+    GuiModel previousModel = std::move(model);
+    model = std::move(nextModel);
+    internModel();
+    modelElements.assign(model.size(), GuiElementRef());
+
+    std::unordered_map<GuiId, size_t> previousIndices;
+    for (size_t i = 0; i < previousModel.size(); i++) {
+        if (previousModel.ids[i] != GuiModel::NoId) {
+            previousIndices[strings.intern(previousModel.idOf(i))] = i;
+        }
+    }
+
+    size_t created = 0;
+    size_t updated = 0;
+    size_t removed = 0;
+    std::unordered_set<GuiId> reusedIds;
+    std::vector<std::vector<GuiElementRef>> nextElements(model.panels.size());
+    reserveElements();
+
+    size_t previousPanelCount = backend->getPanelCount();
+    if (previousPanelCount < model.panels.size()) {
+        backend->setPanelCount(model.panels.size());
+    }
+    for (size_t p = 0; p < model.panels.size(); p++) {
+        const GuiPanelModel& panelModel = model.panels[p];
+        const GuiPanelModel* previousPanel = p < previousModel.panels.size() && p < previousPanelCount ? &previousModel.panels[p] : nullptr;
+        if (panelModel.valid && (!previousPanel || !previousPanel->valid)) {
+            backend->setupPanel(p, panelModel);
+        }
+        else if (panelModel.valid) {
+            backend->updatePanel(p, *previousPanel, panelModel);
+        }
+
+        for (size_t i = panelModel.firstElement; i < panelModel.firstElement + panelModel.elementCount; i++) {
+            GuiId id = strings.find(model.idOf(i));
+            auto previous = !id.isValid() ? previousIndices.end() : previousIndices.find(id);
+            auto existing = !id.isValid() ? guiElementsMap.end() : guiElementsMap.find(id);
+
+            if (previous != previousIndices.end() && existing != guiElementsMap.end() &&
+                canReuseWidget(previousModel, previous->second, i) && reusedIds.insert(id).second) {
+                // Same element as before: keep the widget, its state and listeners
+                if (updateGuiElement(existing->second, previousModel, previous->second, i)) {
+                    updated++;
+                }
+                modelElements[i] = existing->second;
+                nextElements[p].push_back(existing->second);
+                setElementPanel(id, p);  // The element may have moved to another panel
+                continue;
+            }
+
+            if (existing != guiElementsMap.end() && !reusedIds.count(id)) {
+                removeGuiElement(id);  // The element changed type, replace it
+                removed++;
+            }
+            GuiElementRef guiElement = createGuiElement(i, resolveElementRect(model, i));
+            if (guiElement.isValid()) {
+                nextElements[p].push_back(guiElement);
+                setElementPanel(id, p);
+                reusedIds.insert(id);
+                created++;
+            }
+        }
+    }
+
+    // Elements that are not in the new configuration
+    for (const auto& previous : previousIndices) {
+        if (!reusedIds.count(previous.first) && guiElementsMap.count(previous.first)) {
+            removeGuiElement(previous.first);
+            removed++;
+        }
+    }
+
+    // Only panels whose element list changed are re-attached, existing widgets are reused as they are
+    std::set<GuiElementRef> keptElements;
+    for (size_t p = 0; p < model.panels.size(); p++) {
+        for (const auto& guiElement : nextElements[p]) {
+            keptElements.insert(guiElement);
+        }
+        if (p < panelElements.size() && panelElements[p] == nextElements[p]) {
+            continue;
+        }
+        backend->setPanelElements(p, nextElements[p]);
+        placePanelElements(p);
+    }
+    backend->setPanelCount(model.panels.size());
+
+    // Release the elements that were dropped, including elements without an ID
+    for (const auto& previousElements : panelElements) {
+        for (const auto& guiElement : previousElements) {
+            if (!keptElements.count(guiElement)) {
+                backend->destroyElement(guiElement);
+                profiler.count(GuiCounter::WidgetsDestroyed);
+            }
+        }
+    }
+    panelElements = std::move(nextElements);
+    buildLayout();
+    refreshLabelSlots();
+    buildBoundLabels();
+    dirtyTracker.resize(backend->getPanelCount());
+    dirtyTracker.markAllDirty();
+
+    ofLogNotice() << "Reconciled GUI: " << created << " created, " << updated << " updated, " << removed << " removed.";
+}
+
+bool ofxGuiJson::updateGuiElement(const GuiElementRef& guiElement, const GuiModel& previousModel, size_t previousIndex, size_t index) {
+    bool changed = false;
+    if (previousModel.labels[previousIndex] != model.labels[index]) {
+        backend->setLabel(guiElement, model.labels[index]);
+        changed = true;
+    }
+    ofRectangle previousRect = resolveElementRect(previousModel, previousIndex);
+    ofRectangle rect = resolveElementRect(model, index);
+    if (previousRect.x != rect.x || previousRect.y != rect.y ||
+        previousRect.width != rect.width || previousRect.height != rect.height) {
+        backend->setRect(guiElement, rect);
+        changed = true;
+    }
+    AudioParameter* audioParameter = audioBridge.find(model.audioParameters[index]);
+    if (audioParameter && previousModel.smoothingMillis[previousIndex] != model.smoothingMillis[index]) {
+        audioParameter->setSmoothing(model.smoothingMillis[index], audioBridge.getSampleRate());
+        changed = true;
+    }
+    if (previousModel.actions[previousIndex] != model.actions[index] ||
+        previousModel.maxRates[previousIndex] != model.maxRates[index]) {
+        // The listener stays, only the payload and the rate of its record change
+        auto binding = bindings.find(strings.find(model.idOf(index)));
+        if (binding != bindings.end()) {
+            GuiId action = strings.find(model.actions[index]);
+            binding->second->event.action = action;
+            binding->second->event.actionKey = strings.hash(action);
+            binding->second->minIntervalMillis = rateToIntervalMillis(model.maxRates[index]);
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+bool ofxGuiJson::canReuseWidget(const GuiModel& previousModel, size_t previousIndex, size_t index) const {
+    if (previousModel.types[previousIndex] != model.types[index] ||
+        previousModel.audioParameters[previousIndex] != model.audioParameters[index]) {
+        return false;
+    }
+    if (model.types[index] == GuiElementType::VirtualList) {
+        // The rows are created by setup(), a list with other rows is a new widget
+        return previousModel.rowTypes[previousIndex] == model.rowTypes[index] &&
+            previousModel.visibleRows[previousIndex] == model.visibleRows[index] &&
+            previousModel.rects[previousIndex].width == model.rects[index].width &&
+            previousModel.rects[previousIndex].height == model.rects[index].height;
+    }
+    switch (model.types[index]) {
+    case GuiElementType::Slider:
+    case GuiElementType::IntSlider:
+    case GuiElementType::FloatField:
+    case GuiElementType::IntField:
+        // The range is set by setup()
+        return previousModel.mins[previousIndex] == model.mins[index] &&
+            previousModel.maxs[previousIndex] == model.maxs[index];
+    case GuiElementType::Dropdown:
+        // The rows and the header are created by setup()
+        return previousModel.options[previousIndex] == model.options[index] &&
+            previousModel.labels[previousIndex] == model.labels[index];
+    default:
+        return true;
+    }
+}
+
+void ofxGuiJson::removeGuiElement(GuiId id) {
+    unbindElement(id);
+    auto it = guiElementsMap.find(id);
+    if (it != guiElementsMap.end()) {
+        backend->destroyElement(it->second);
+        profiler.count(GuiCounter::WidgetsDestroyed);
+        guiElementsMap.erase(it);
+    }
+    elementPanels.erase(id);
+}
+
+void ofxGuiJson::reserveElements() {
+    GuiTypeCounts counts = {};
+    counts[static_cast<size_t>(GuiElementType::Toggle)] = dynamicToggles.size();
+    for (GuiElementType type : model.types) {
+        counts[static_cast<size_t>(type)]++;
+    }
+    backend->reserve(counts);
+}
+
+void ofxGuiJson::clearGui() {
+    if (!stateLookup.empty()) {
+        for (auto& entry : editState().entries) {
+            entry.active = false;
+        }
     }
-    catch (const nlohmann::json::parse_error& e) {
-        ofLogError() << "JSON parse error at byte " << e.byte << ": " << e.what();
+    size_t elementCount = dynamicToggles.size();
+    for (const auto& elements : panelElements) {
+        elementCount += elements.size();
     }
-    catch (const std::exception& e) {
-        ofLogError() << "Exception parsing JSON: " << e.what();
+    profiler.count(GuiCounter::WidgetsDestroyed, elementCount);
+
+    pendingBindings.clear();
+    std::fill(flushingBindings.begin(), flushingBindings.end(), nullptr);
+    bindings.clear();
+    toggleIdMap.clear();
+    panelElements.clear();
+    guiElementsMap.clear();
+    elementPanels.clear();
+    staticToggles.clear();
+    dynamicToggles.clear();
+    dynamicToggleIds.clear();
+    dynamicToggleSlots.clear();
+    modelElements.clear();
+    layout.clear();
+    toggleLayout.clear();
+    toggleColumn = GuiLayout::NoNode;
+    boundLabels.clear();
+
+    // The backend releases every element at once instead of one at a time
+    backend->clear();
+    refreshLabelSlots();
+
+    dirtyTracker.resize(0);
+    pressedPanel = GuiDirtyTracker::NoPanel;
+}
+
+void ofxGuiJson::refreshLabelSlots() {
+    for (const auto& entry : labelSlotLookup) {
+        LabelSlot& slot = labelSlots[entry.second];
+        auto it = guiElementsMap.find(entry.first);
+        bool isLabel = it != guiElementsMap.end() && it->second.type == GuiElementType::Label;
+        slot.element = isLabel ? it->second : GuiElementRef();
+        slot.panel = panelOf(entry.first);
+        slot.layoutNode = isLabel ? layout.findElement(model.findId(strings.name(entry.first))) : GuiLayout::NoNode;
+        if (slot.element.isValid()) {
+            slot.committed = backend->getLabel(slot.element);
+        }
+    }
+}
+
+void ofxGuiJson::loadJson(const std::string& fullPath) {
+    GuiProfiler::ScopedTimer timer(profiler, GuiProfileScope::LoadJson);
+    config = json();
+    GuiModelLoader loader;
+    loader.setUseCache(binaryCache);
+    loader.setValidate(schemaValidation);
+    loader.setIncludeCache(&includeCache);
+    bool loaded = loader.load(fullPath, model, retainConfig ? &config : nullptr);
+    loadStats = loader.getStats();
+    configDependencies = loader.getDependencies();
+    if (loaded) {
+        finishLoad(fullPath);
     }
 }
 
+void ofxGuiJson::finishLoad(const std::string& fullPath) {
+    internModel();
+    if (model.settings.audio.sampleRate > 0) {
+        audioBridge.setSampleRate(static_cast<float>(model.settings.audio.sampleRate));
+    }
+
+    ofLogNotice() << "JSON loaded successfully from: " << fullPath;
+    ofLogNotice() << "Loaded " << loadStats.elementCount << " elements from " << loadStats.fileBytes << " bytes in "
+        << loadStats.totalMillis << " ms (map " << loadStats.mapMillis << " ms, parse " << loadStats.parseMillis << " ms"
+        << (loadStats.fromCache ? ", binary cache)" : ")");
+    if (retainConfig && ofGetLogLevel() <= OF_LOG_VERBOSE) {
+        ofLogVerbose() << "JSON Content: " << config.dump(4); // Dump JSON content with indentation for easier reading
+    }
+}
+
+void ofxGuiJson::internModel() {
+    for (const auto& id : model.idNames) {
+        strings.intern(id);
+    }
+    for (const auto& action : model.actions) {
+        if (!action.empty()) {
+            strings.intern(action);
+        }
+    }
+}
 
 void ofxGuiJson::parseGuiElements() {
-    if (config.is_null()) {
-        ofLogError() << "JSON config is null, cannot parse GUI elements.";
+    GuiProfiler::ScopedTimer timer(profiler, GuiProfileScope::ParseGuiElements);
+    if (model.panels.empty()) {
+        ofLogError() << "GUI model is empty, cannot parse GUI elements.";
         return;
     }
+    modelElements.assign(model.size(), GuiElementRef());
 
-    json panelsConfig = config["panels"];
-    if (panelsConfig.is_null() || !panelsConfig.is_array()) {
-        ofLogError() << "Invalid or missing 'panels' configuration.";
-        return;
+    // Panels are planned concurrently, each into its own slot; the backend is only called below
+    std::vector<PanelPlan> plans(model.panels.size());
+    size_t threads = model.size() < MinParallelElements ? 1 : resolveThreadCount(buildThreads);
+    parallelFor(plans.size(), threads, [this, &plans](size_t p) {
+        planPanel(model, model.panels[p], plans[p]);
+    });
+
+    // One block per widget type, sized from the plans
+    GuiTypeCounts counts = {};
+    counts[static_cast<size_t>(GuiElementType::Toggle)] = dynamicToggles.size();
+    for (const auto& plan : plans) {
+        for (size_t t = 0; t < counts.size(); t++) {
+            counts[t] += plan.counts[t];
+        }
     }
+    backend->reserve(counts);
 
-    for (auto& panelConfig : panelsConfig) {
-        auto panel = std::make_shared<ofxPanel>();
-        setupPanel(*panel, panelConfig);
-        panels.push_back(panel);
+    // Elements are created in configuration order, so handles and panels match a single-threaded build
+    backend->setPanelCount(model.panels.size());
+    for (size_t p = 0; p < model.panels.size(); p++) {
+        buildPanel(p, plans[p]);
     }
+    buildLayout();
+    buildBoundLabels();
+    dirtyTracker.resize(backend->getPanelCount());
+    ofLogNotice() << "Built " << backend->getPanelCount() << " panels, planned on " << std::min(threads, plans.size()) << " threads.";
 }
 
-void ofxGuiJson::setupPanel(ofxPanel& panel, const json& panelConfig) {
-    if (panelConfig.is_null() || !panelConfig.contains("gui") || !panelConfig["gui"].is_object()) {
-        ofLogError() << "Invalid 'gui' configuration for panel.";
+void ofxGuiJson::setupPanel(ofxPanel& panel, const GuiPanelModel& panelModel) {
+    if (!widgets) {
+        ofLogError() << "setupPanel needs the ofxGui backend.";
         return;
     }
-    auto& guiConfig = panelConfig["gui"];
-    panel.setup(guiConfig.value("title", "Default Panel"), "", guiConfig.value("width", 400), guiConfig.value("height", 300));
-    panel.setPosition(guiConfig["position"].value("x", 0), guiConfig["position"].value("y", 0));
+    PanelPlan plan;
+    planPanel(model, panelModel, plan);
+    if (!panelModel.valid) {
+        return;  // Already reported while compiling the model
+    }
+    panel.setup(panelModel.title, panelModel.settingsFile, panelModel.width, panelModel.height);
+    panel.setPosition(panelModel.x, panelModel.y);
 
-    auto elementsConfig = panelConfig["elements"];
-    if (elementsConfig.is_array()) {
-        for (auto& elementConfig : elementsConfig) {
-            addGuiElement(panel, elementConfig);
+    for (size_t e = 0; e < plan.elements.size(); e++) {
+        GuiElementRef guiElement = createGuiElement(plan.elements[e], plan.rects[e]);
+        if (guiElement.isValid()) {
+            panel.add(widgets->getWidget(guiElement));
         }
     }
 }
 
+void ofxGuiJson::planPanel(const GuiModel& model, const GuiPanelModel& panelModel, PanelPlan& plan) {
+    if (!panelModel.valid) {
+        return;
+    }
+    plan.elements.reserve(panelModel.elementCount);
+    plan.rects.reserve(panelModel.elementCount);
 
-void ofxGuiJson::addGuiElement(ofxPanel& panel, const json& elementConfig) {
-    std::string type = elementConfig.value("type", "");
-    std::string label = elementConfig.value("label", "");
-    std::string id = elementConfig.value("id", "");
-    float posX = elementConfig["position"].value("x", 0);
-    float posY = elementConfig["position"].value("y", 0);
-    float width = elementConfig["size"].value("width", 300);
-    float height = elementConfig["size"].value("height", 30);
-
-    std::shared_ptr<ofxBaseGui> guiElement;
+    for (size_t i = panelModel.firstElement; i < panelModel.firstElement + panelModel.elementCount; i++) {
+        if (model.types[i] == GuiElementType::Unknown) {
+            continue;  // Reported while compiling the model
+        }
+        plan.counts[static_cast<size_t>(model.types[i])]++;
+        plan.elements.push_back(static_cast<uint32_t>(i));
+        plan.rects.push_back(resolveElementRect(model, i));
+    }
+}
 
-    if (type == "toggle") {
-        auto toggle = std::make_shared<ofxToggle>();
-        toggle->setup(label, elementConfig.value("default", false), width, height);
-        toggle->setPosition(posX, posY);
-        panel.add(toggle.get());
-        guiElement = toggle;
+ofRectangle ofxGuiJson::resolveElementRect(const GuiModel& model, size_t index) {
+    ofRectangle rect = model.rects[index];
+    if (rect.width <= 0) {
+        rect.width = model.panels[model.panelIndices[index]].width;
+    }
+    if (rect.height <= 0) {
+        rect.height = GuiElementDesc().rect.height;
+    }
+    return rect;
+}
 
-        // Map the ofParameter to the toggle ID
-        toggleIdMap[&toggle->getParameter().cast<bool>()] = id;
+void ofxGuiJson::buildPanel(size_t panel, const PanelPlan& plan) {
+    const GuiPanelModel& panelModel = model.panels[panel];
+    if (!panelModel.valid) {
+        return;  // Already reported while compiling the model
+    }
+    backend->setupPanel(panel, panelModel);
 
-        // Bind the listener to track the state changes
-        toggle->getParameter().cast<bool>().addListener(this, &ofxGuiJson::onToggleAction);
+    if (panelElements.size() <= panel) {
+        panelElements.resize(panel + 1);
+    }
+    for (size_t e = 0; e < plan.elements.size(); e++) {
+        GuiElementRef guiElement = createGuiElement(plan.elements[e], plan.rects[e]);
+        if (guiElement.isValid()) {
+            panelElements[panel].push_back(guiElement);
+            setElementPanel(strings.find(model.idOf(plan.elements[e])), panel);
+        }
     }
+    backend->setPanelElements(panel, panelElements[panel]);
+    placePanelElements(panel);
+}
 
-    else if (type == "label") {
-        auto labelControl = std::make_shared<ofxLabel>();
-        labelControl->setup(label, width, height);
-        labelControl->setPosition(posX, posY);
-        guiElement = labelControl;
-        panel.add(guiElement.get());
+void ofxGuiJson::placePanelElements(size_t panel) {
+    const GuiPanelModel& panelModel = model.panels[panel];
+    if (!panelModel.valid || !panelModel.hasLayout()) {
+        return;  // The panel stacks its elements
+    }
+    for (size_t i = panelModel.firstElement; i < panelModel.firstElement + panelModel.elementCount; i++) {
+        if (modelElements[i].isValid()) {
+            backend->setRect(modelElements[i], resolveElementRect(model, i));
+        }
     }
+}
+
 
+GuiElementRef ofxGuiJson::createGuiElement(size_t index, const ofRectangle& rect) {
+    GuiElementRef guiElement = backend->createElement(model, index, rect);
+    GuiId id = strings.find(model.idOf(index));
+    if (guiElement.isValid()) {
+        profiler.count(GuiCounter::WidgetsCreated);
+    }
+    if (index < modelElements.size()) {
+        modelElements[index] = guiElement;
+    }
 
-    if (guiElement) {
+    // Resolve the dispatch record once and bind the listener to it
+    if (guiElement.isValid() && id.isValid()) {
         guiElementsMap[id] = guiElement;
+        bindModelElement(guiElement, id, index);
     }
+    return guiElement;
 }
 
 
 
+AudioParameter* ofxGuiJson::declareAudioParameter(size_t index) {
+    const std::string& name = model.audioParameters[index];
+    if (name.empty()) {
+        return nullptr;
+    }
+    AudioParameter* parameter = audioBridge.declare(name, model.defaults[index]);
+    parameter->setSmoothing(model.smoothingMillis[index], audioBridge.getSampleRate());
+    return parameter;
+}
+
 std::vector<std::shared_ptr<ofxPanel>>& ofxGuiJson::getPanels() {
-    return panels;
-}
-
-
-void ofxGuiJson::onToggleAction(bool& state) {
-    // Find the ID associated with the parameter that triggered this action
-    for (const auto& pair : toggleIdMap) {
-        if (&pair.first->get() == &state) {
-            std::string id = pair.second;
-            ofLogNotice() << "onToggleAction called for toggle ID: " << id << " with state: " << state;
-
-            // Process the toggle action using the ID
-            auto guiElement = getGuiElement(id);
-            if (guiElement) {
-                std::string action = "";
-                for (const auto& el : config["panels"][0]["elements"]) {
-                    if (el.contains("id") && el["id"].get<std::string>() == id) {
-                        action = el.value("id", "");
-                        break;
-                    }
-                }
-                if (!action.empty()) {
-                    std::pair<std::string, bool> eventParam = make_pair(action, state);
-                    ofNotifyEvent(onToggleEvent, eventParam, this);
-                }
-            }
-            return; // Exit after processing the correct toggle
+    if (widgets) {
+        return widgets->getPanels();
+    }
+    ofLogError() << "getPanels() needs the ofxGui backend, returning no panels.";
+    detachedPanels.clear();  // Whatever was added through an earlier call is not kept
+    return detachedPanels;
+}
+
+ofxPanel& ofxGuiJson::getGui() {
+    if (widgets) {
+        return widgets->getMainPanel();
+    }
+    ofLogError() << "getGui() needs the ofxGui backend, returning a panel that is never drawn.";
+    if (!detachedGui) {
+        detachedGui = std::make_unique<ofxPanel>();
+    }
+    return *detachedGui;
+}
+
+GuiElementRef ofxGuiJson::findElement(GuiId id) const {
+    auto it = guiElementsMap.find(id);
+    return it != guiElementsMap.end() ? it->second : GuiElementRef();
+}
+
+bool ofxGuiJson::setElementValue(GuiId id, float value) {
+    GuiElementRef guiElement = findElement(id);
+    if (!hasElementValue(guiElement.type)) {
+        return false;
+    }
+    // The backend notifies the binding, so the change is dispatched like one made by the user
+    return backend->setValue(guiElement, toElementValue(guiElement.type, value));
+}
+
+float ofxGuiJson::getElementValue(GuiId id) const {
+    GuiElementRef guiElement = findElement(id);
+    if (!hasElementValue(guiElement.type)) {
+        return 0;
+    }
+    GuiEvent event;
+    event.type = toEventType(guiElement.type);
+    event.value = backend->getValue(guiElement);
+    return event.asFloat();
+}
+
+bool ofxGuiJson::saveSnapshot(const std::string& path) const {
+    std::string fullPath = ofToDataPath(path, true);
+    return state->save(fullPath, GuiSnapshot::formatOf(fullPath));
+}
+
+bool ofxGuiJson::loadSnapshot(const std::string& path) {
+    GuiSnapshot snapshot;
+    if (!snapshot.load(ofToDataPath(path, true))) {
+        return false;
+    }
+    size_t applied = applySnapshot(snapshot);
+    ofLogNotice() << "Restored " << applied << " of " << snapshot.entries.size() << " values from " << path;
+    return true;
+}
+
+size_t ofxGuiJson::applySnapshot(const GuiSnapshot& snapshot) {
+    size_t applied = 0;
+    for (const auto& entry : snapshot.entries) {
+        if (!entry.active) {
+            continue;
+        }
+        GuiElementRef guiElement = findElement(strings.find(entry.id));
+        if (!hasElementValue(guiElement.type) || toEventType(guiElement.type) != entry.type) {
+            ofLogNotice() << "Skipping saved value of '" << entry.id << "', no element of that type.";
+            continue;
         }
+        applied += backend->setValue(guiElement, entry.value);
     }
+    return applied;
+}
 
-    ofLogError() << "No ID found for the given parameter!";
+void ofxGuiJson::setAutosave(bool enable, const std::string& path, uint64_t intervalMillis) {
+    autosaveListener.unsubscribe();
+    if (!enable) {
+        autosavePath.clear();
+        return;
+    }
+    autosavePath = ofToDataPath(path, true);
+    autosaveInterval = intervalMillis;
+    lastAutosave = ofGetElapsedTimeMillis();
+    autosaveListener = ofEvents().update.newListener(this, &ofxGuiJson::onUpdateAutosave);
 }
 
+void ofxGuiJson::onUpdateAutosave(ofEventArgs&) {
+    uint64_t now = ofGetElapsedTimeMillis();
+    if (!stateChanged || now - lastAutosave < autosaveInterval) {
+        return;
+    }
+    if (pendingSave.valid()) {
+        if (pendingSave.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;  // The previous save is still writing, the next one starts when it is done
+        }
+        pendingSave.get();
+    }
+    lastAutosave = now;
+    stateChanged = false;
 
+    // Sharing the snapshot freezes it: the next change on this thread copies it first
+    std::shared_ptr<const GuiSnapshot> snapshot = state;
+    std::string path = autosavePath;
+    pendingSave = std::async(std::launch::async, [snapshot, path]() {
+        return snapshot->save(path, GuiSnapshot::formatOf(path));
+    });
+}
 
+bool ofxGuiJson::setRemoteControl(bool enable, uint16_t port) {
+    remoteListener.unsubscribe();
+    remote.reset();
+    if (!enable) {
+        return true;
+    }
+    auto endpoint = std::make_unique<GuiRemoteEndpoint>();
+    if (!endpoint->start(port)) {
+        return false;
+    }
+    ofLogNotice() << "Remote control listening on 127.0.0.1:" << endpoint->getPort();
+    remote = std::move(endpoint);
+    remoteListener = ofEvents().update.newListener(this, &ofxGuiJson::onUpdateRemote);
+    return true;
+}
 
-std::shared_ptr<ofxBaseGui> ofxGuiJson::getGuiElement(const std::string& id) {
-    auto it = guiElementsMap.find(id);
-    if (it != guiElementsMap.end() && it->second) {
-        return it->second;
+size_t ofxGuiJson::updateRemote() {
+    if (!remote) {
+        return 0;
+    }
+    size_t handled = remote->poll([this](const GuiRemoteMessage& message, const GuiRemotePeer& peer) {
+        handleRemoteMessage(message, peer);
+    });
+    remote->flush();
+    return handled;
+}
+
+void ofxGuiJson::onUpdateRemote(ofEventArgs&) {
+    updateRemote();
+}
+
+void ofxGuiJson::handleRemoteMessage(const GuiRemoteMessage& message, const GuiRemotePeer& peer) {
+    GuiElementRef guiElement = findElement(strings.find(message.id));
+    if (!hasElementValue(guiElement.type)) {
+        remote->reply(peer, GuiRemoteOp::Error, message.id);
+        return;
+    }
+    GuiEventType type = toEventType(guiElement.type);
+    switch (message.op) {
+    case GuiRemoteOp::Set: {
+        // Clients may send any numeric type, converted as setElementValue() does
+        GuiEvent::Value value = message.type == type ? message.value : toElementValue(guiElement.type, message.asFloat());
+        if (!backend->setValue(guiElement, value)) {
+            remote->reply(peer, GuiRemoteOp::Error, message.id);
+        }
+        break;
+    }
+    case GuiRemoteOp::Get:
+        if (type == GuiEventType::Trigger) {
+            remote->reply(peer, GuiRemoteOp::Error, message.id);  // Buttons have no value
+        }
+        else {
+            remote->reply(peer, GuiRemoteOp::Value, message.id, type, backend->getValue(guiElement));
+        }
+        break;
+    default:
+        remote->reply(peer, GuiRemoteOp::Error, message.id);
+        break;
+    }
+}
+
+GuiSnapshot& ofxGuiJson::editState() {
+    if (state.use_count() > 1) {
+        state = std::make_shared<GuiSnapshot>(*state);  // Still read elsewhere, e.g. by the autosave thread
+        profiler.count(GuiCounter::Allocations);
+    }
+    stateChanged = true;
+    return *state;
+}
+
+void ofxGuiJson::trackState(ElementBinding& binding) {
+    GuiSnapshot& snapshot = editState();
+    auto found = stateLookup.find(binding.id);
+    if (found == stateLookup.end()) {
+        found = stateLookup.emplace(binding.id, static_cast<uint32_t>(snapshot.entries.size())).first;
+        snapshot.entries.emplace_back();
+        snapshot.entries.back().id = strings.name(binding.id);
+    }
+    GuiSnapshot::Entry& entry = snapshot.entries[found->second];
+    entry.type = binding.event.type;
+    entry.value = binding.event.value;
+    entry.active = true;
+    binding.stateIndex = found->second;
+}
+
+void ofxGuiJson::draw() {
+    {
+        GuiProfiler::ScopedTimer timer(profiler, GuiProfileScope::Draw);
+        uint64_t renders = dirtyTracker.getRenderCount();
+        backend->draw(dirtyTracker, cachedRendering);
+        profiler.count(GuiCounter::PanelsRendered, cachedRendering ? dirtyTracker.getRenderCount() - renders : backend->getPanelCount());
+    }
+    if (profilerOverlay && widgets) {
+        profiler.drawOverlay(profilerOverlayX, profilerOverlayY);
+    }
+}
+
+void ofxGuiJson::setProfiling(bool enable, size_t historyFrames) {
+    profiler.setEnabled(enable, historyFrames);
+    if (enable) {
+        profileListener = ofEvents().update.newListener(this, &ofxGuiJson::onUpdateProfile);
     }
     else {
+        profileListener.unsubscribe();
+    }
+}
+
+void ofxGuiJson::setProfilerOverlay(bool show, float x, float y) {
+    profilerOverlay = show;
+    profilerOverlayX = x;
+    profilerOverlayY = y;
+}
+
+void ofxGuiJson::applyProfilerSettings() {
+    const GuiProfilerSettings& settings = model.settings.profiler;
+    if (!settings.enable) {
+        return;
+    }
+    if (!profiler.isEnabled()) {
+        setProfiling(true, static_cast<size_t>(std::max(1, settings.historyFrames)));
+    }
+    setProfilerOverlay(settings.overlay, settings.x, settings.y);
+    if (!settings.traceFile.empty() && !profiler.isTracing()) {
+        profiler.setTracing(true);
+    }
+    traceFile = settings.traceFile;
+}
+
+void ofxGuiJson::onUpdateProfile(ofEventArgs&) {
+    profiler.endFrame();
+}
+
+void ofxGuiJson::setCachedRendering(bool cached) {
+    cachedRendering = cached;
+    mouseListeners.unsubscribeAll();
+    pressedPanel = GuiDirtyTracker::NoPanel;
+    if (!cached) {
+        return;
+    }
+
+    dirtyTracker.resize(backend->getPanelCount());
+    dirtyTracker.markAllDirty();
+    mouseListeners.push(ofEvents().mouseMoved.newListener(this, &ofxGuiJson::onMouseEvent));
+    mouseListeners.push(ofEvents().mouseDragged.newListener(this, &ofxGuiJson::onMouseEvent));
+    mouseListeners.push(ofEvents().mousePressed.newListener(this, &ofxGuiJson::onMouseEvent));
+    mouseListeners.push(ofEvents().mouseReleased.newListener(this, &ofxGuiJson::onMouseEvent));
+    mouseListeners.push(ofEvents().mouseScrolled.newListener(this, &ofxGuiJson::onMouseEvent));
+}
+
+void ofxGuiJson::onMouseEvent(ofMouseEventArgs& args) {
+    size_t hovered = backend->findPanelAt(args.x, args.y);
+    dirtyTracker.setHoveredPanel(hovered);
+
+    switch (args.type) {
+    case ofMouseEventArgs::Pressed:
+        pressedPanel = hovered;
+        dirtyTracker.markDirty(hovered);
+        break;
+    case ofMouseEventArgs::Dragged:
+    case ofMouseEventArgs::Scrolled:
+        dirtyTracker.markDirty(pressedPanel);
+        dirtyTracker.markDirty(hovered);
+        break;
+    case ofMouseEventArgs::Released:
+        dirtyTracker.markDirty(pressedPanel);
+        dirtyTracker.markDirty(hovered);
+        pressedPanel = GuiDirtyTracker::NoPanel;
+        break;
+    default:
+        break;
+    }
+}
+
+void ofxGuiJson::markElementDirty(const std::string& id) {
+    dirtyTracker.markDirty(panelOf(strings.find(id)));  // Ignored for NoPanel
+}
+
+size_t ofxGuiJson::panelOf(GuiId id) const {
+    auto it = elementPanels.find(id);
+    return it != elementPanels.end() ? it->second : GuiDirtyTracker::NoPanel;
+}
+
+void ofxGuiJson::setElementPanel(GuiId id, size_t panel) {
+    if (!id.isValid()) {
+        return;
+    }
+    elementPanels[id] = panel;
+    auto binding = bindings.find(id);
+    if (binding != bindings.end()) {
+        binding->second->panel = panel;
+    }
+}
+
+
+ofxGuiJson::ElementBinding& ofxGuiJson::bindElement(const GuiElementRef& guiElement, GuiId id, GuiId action, AudioParameter* audioParameter) {
+    unbindElement(id);
+
+    auto binding = std::make_unique<ElementBinding>();
+    binding->id = id;
+    binding->event.type = toEventType(guiElement.type);
+    binding->event.id = id;
+    binding->event.action = action;
+    binding->event.actionKey = strings.hash(action);
+    binding->event.value = backend->getValue(guiElement);
+    binding->elementEvent = &elementEvents[id];
+    binding->audioParameter = audioParameter;
+    binding->element = guiElement;
+    binding->panel = panelOf(id);
+
+    if (guiElement.type == GuiElementType::Toggle) {
+        binding->eventParam.first = strings.name(id);
+        if (widgets) {
+            // Map the ofParameter to the toggle ID
+            binding->parameter = &widgets->getWidget(guiElement)->getParameter().cast<bool>();
+            toggleIdMap[binding->parameter] = id;
+        }
+    }
+
+    // Capture the record itself so dispatch never has to look the element up
+    ElementBinding* record = binding.get();
+    binding->listener = backend->listen(guiElement, [this, record](const GuiEvent::Value& value) {
+        onElementChanged(*record, value);
+    });
+
+    bool coalesced = record->event.type == GuiEventType::Float || record->event.type == GuiEventType::Int;
+    if (coalesced && !flushSubscribed) {
+        flushListener = ofEvents().update.newListener(this, &ofxGuiJson::onUpdateFlush);
+        flushSubscribed = true;
+    }
+    if (audioParameter) {
+        audioParameter->publish(record->event.asFloat());  // Match the state of the new element
+    }
+    if (record->event.type != GuiEventType::Trigger) {
+        trackState(*record);
+    }
+    bindings[id] = std::move(binding);
+    profiler.count(GuiCounter::Allocations);  // The dispatch record
+    return *record;
+}
+
+void ofxGuiJson::bindModelElement(const GuiElementRef& guiElement, GuiId id, size_t index) {
+    if (!hasElementValue(guiElement.type)) {
+        return;  // Labels and lists have no value
+    }
+    ElementBinding& binding = bindElement(guiElement, id, strings.find(model.actions[index]), declareAudioParameter(index));
+    binding.minIntervalMillis = rateToIntervalMillis(model.maxRates[index]);
+}
+
+void ofxGuiJson::onElementChanged(ElementBinding& binding, const GuiEvent::Value& value) {
+    if (binding.stateIndex != UINT32_MAX) {
+        editState().entries[binding.stateIndex].value = value;
+    }
+    switch (binding.event.type) {
+    case GuiEventType::Toggle:
+        onToggleAction(binding, value.toggle);
+        break;
+    case GuiEventType::Float:
+    case GuiEventType::Int:
+        // Only the latest value is kept, dragging notifies once per flush instead of once per mouse event
+        binding.event.value = value;
+        queueChange(binding);
+        break;
+    default:
+        // A click or a pick is a discrete event, it is never coalesced
+        binding.event.value = value;
+        notifyChange(binding);
+        break;
+    }
+}
+
+void ofxGuiJson::unbindElement(GuiId id) {
+    auto it = bindings.find(id);
+    if (it != bindings.end()) {
+        ElementBinding* binding = it->second.get();
+        if (binding->pending) {
+            pendingBindings.erase(std::remove(pendingBindings.begin(), pendingBindings.end(), binding), pendingBindings.end());
+        }
+        std::replace(flushingBindings.begin(), flushingBindings.end(), binding, static_cast<ElementBinding*>(nullptr));
+        if (binding->parameter) {
+            toggleIdMap.erase(binding->parameter);
+        }
+        if (binding->stateIndex != UINT32_MAX) {
+            editState().entries[binding->stateIndex].active = false;  // Not saved until the element returns
+        }
+        bindings.erase(it);  // Destroying the listener unsubscribes it
+    }
+}
+
+void ofxGuiJson::onToggleAction(bool& checked) {
+    // Find the toggle whose parameter holds the state
+    for (const auto& entry : toggleIdMap) {
+        if (&entry.first->get() != &checked) {
+            continue;
+        }
+        auto binding = bindings.find(entry.second);
+        if (binding != bindings.end()) {
+            onToggleAction(*binding->second, checked);
+        }
+        return;
+    }
+    ofLogWarning() << "onToggleAction called with a state that belongs to no toggle.";
+}
+
+void ofxGuiJson::onToggleAction(ElementBinding& binding, bool checked) {
+    if (ofGetLogLevel() <= OF_LOG_VERBOSE) {
+        ofLogVerbose() << "onToggleAction called for toggle ID: " << strings.name(binding.id) << " with state: " << checked;
+    }
+
+    // The payloads already hold the ID, only the state changes between dispatches
+    binding.event.value.toggle = checked;
+    notifyChange(binding);
+    binding.eventParam.second = checked;
+    ofNotifyEvent(onToggleEvent, binding.eventParam, this);
+}
+
+void ofxGuiJson::queueChange(ElementBinding& binding) {
+    if (!binding.pending) {
+        binding.pending = true;
+        size_t capacity = pendingBindings.capacity();
+        pendingBindings.push_back(&binding);
+        profiler.count(GuiCounter::Allocations, pendingBindings.capacity() != capacity);
+    }
+    if (cachedRendering) {
+        dirtyTracker.markDirty(binding.panel);  // The widget shows the value right away
+    }
+}
+
+void ofxGuiJson::notifyChange(ElementBinding& binding) {
+    if (binding.audioParameter) {
+        binding.audioParameter->publish(binding.event.asFloat());
+    }
+    dispatchEvent(binding.event, *binding.elementEvent);
+
+    if (cachedRendering) {
+        dirtyTracker.markDirty(binding.panel);
+    }
+}
+
+size_t ofxGuiJson::flushChanges() {
+    if (pendingBindings.empty()) {
+        return 0;
+    }
+    uint64_t now = ofGetElapsedTimeMillis();
+    size_t notified = 0;
+
+    // Listeners may change other elements, which queue into the emptied pendingBindings
+    flushingBindings.swap(pendingBindings);
+    for (ElementBinding* binding : flushingBindings) {
+        if (!binding) {
+            continue;  // Removed by a listener during this flush
+        }
+        if (binding->minIntervalMillis > 0 && now - binding->lastNotifyMillis < binding->minIntervalMillis) {
+            pendingBindings.push_back(binding);  // Not due yet, the latest value waits for a later frame
+            continue;
+        }
+        binding->pending = false;
+        binding->lastNotifyMillis = now;
+        notifyChange(*binding);
+        notified++;
+    }
+    flushingBindings.clear();
+    return notified;
+}
+
+void ofxGuiJson::onUpdateFlush(ofEventArgs&) {
+    flushChanges();
+}
+
+
+
+
+void ofxGuiJson::dispatchEvent(GuiEvent& event, ofEvent<GuiEvent>& elementEvent) {
+    GuiProfiler::ScopedTimer timer(profiler, GuiProfileScope::Dispatch);
+    profiler.count(GuiCounter::EventsFired);
+    size_t capacity = eventQueue.capacity();
+    eventQueue.push(event);
+    profiler.count(GuiCounter::Allocations, eventQueue.capacity() != capacity);
+    ofNotifyEvent(elementEvent, event, this);
+    ofNotifyEvent(onChange, event, this);
+    if (remote) {
+        remote->notify(event, strings.name(event.id));
+    }
+}
+
+
+ofxBaseGui* ofxGuiJson::getGuiWidget(const std::string& id) {
+    GuiId guiId = strings.find(id);
+    if (!guiId.isValid()) {
         ofLogError() << "GUI element with ID '" << id << "' not found or is null.";
-        return nullptr; // Return nullptr explicitly if not found or null
+        return nullptr;
+    }
+    return getGuiWidget(guiId);
+}
+
+ofxBaseGui* ofxGuiJson::getGuiWidget(GuiId id) {
+    auto it = guiElementsMap.find(id);
+    ofxBaseGui* widget = it != guiElementsMap.end() ? backend->getWidget(it->second) : nullptr;
+    if (!widget) {
+        ofLogError() << "GUI element with ID '" << strings.name(id) << "' not found or is null.";
     }
+    return widget;
 }
 
 
-void ofxGuiJson::updateGuiLabels(const std::map<std::string, std::string>& labelUpdates) { // potentially only have string string instead of map
+ofxGuiJsonVirtualList* ofxGuiJson::getVirtualList(const std::string& id) {
+    auto it = guiElementsMap.find(strings.find(id));
+    if (it == guiElementsMap.end() || it->second.type != GuiElementType::VirtualList) {
+        return nullptr;
+    }
+    return static_cast<ofxGuiJsonVirtualList*>(backend->getWidget(it->second));
+}
+
+void ofxGuiJson::updateGuiLabels(const std::map<std::string, std::string>& labelUpdates) {
+    GuiProfiler::ScopedTimer timer(profiler, GuiProfileScope::UpdateGuiLabels);
     for (const auto& update : labelUpdates) {
-        auto labelElement = std::dynamic_pointer_cast<ofxLabel>(getGuiElement(update.first));
-        if (labelElement) {
-            labelElement->setName(update.second);
+        LabelHandle handle = getLabelHandle(update.first);
+        if (handle.isValid()) {
+            setLabelText(handle, update.second);
         }
         else {
             ofLogError() << "Label with ID '" << update.first << "' not found for update.";
         }
     }
+    commitLabelUpdates();
 }
 
-void ofxGuiJson::createAndAddToggle(const std::string& label, const std::string& baseId) {
-    static int toggleCount = 0; // Static counter to ensure unique IDs
-    std::string id = baseId + std::to_string(toggleCount++); // Generate unique ID
+ofxGuiJson::LabelHandle ofxGuiJson::getLabelHandle(const std::string& id) {
+    LabelHandle handle;
+    GuiId guiId = strings.find(id);
+    auto found = labelSlotLookup.find(guiId);
+    if (found != labelSlotLookup.end()) {
+        handle.index = found->second;
+        return handle;
+    }
 
-    auto toggle = std::make_shared<ofxToggle>();
-    float width = 100; // Default width
-    float height = 20; // Default height
-    float posX = 50;   // Default x position
-    float posY = 50 + (toggleCount * (height + 10)); // Stack toggles vertically
+    auto it = guiElementsMap.find(guiId);
+    if (it == guiElementsMap.end() || it->second.type != GuiElementType::Label) {
+        return handle;
+    }
+    LabelSlot slot;
+    slot.element = it->second;
+    slot.panel = panelOf(guiId);
+    slot.layoutNode = layout.findElement(model.findId(id));
+    slot.committed = backend->getLabel(slot.element);
+    slot.committed.reserve(LabelCapacity);
+    handle.index = static_cast<uint32_t>(labelSlots.size());
+    labelSlots.push_back(std::move(slot));
+    labelSlotLookup[guiId] = handle.index;
+    dirtyLabels.reserve(labelSlots.size());
+    profiler.count(GuiCounter::Allocations);  // The slot and its text buffer
+    return handle;
+}
+
+void ofxGuiJson::setLabelText(LabelHandle handle, const char* text, size_t length) {
+    if (!handle.isValid() || handle.index >= labelSlots.size()) {
+        return;
+    }
+    LabelSlot& slot = labelSlots[handle.index];
+    slot.pendingLength = std::min(length, LabelCapacity - 1);
+    std::memcpy(slot.pending, text, slot.pendingLength);
+    slot.pending[slot.pendingLength] = '\0';
+    markLabelDirty(handle.index);
+}
+
+void ofxGuiJson::setLabelTextf(LabelHandle handle, const char* format, ...) {
+    if (!handle.isValid() || handle.index >= labelSlots.size()) {
+        return;
+    }
+    LabelSlot& slot = labelSlots[handle.index];
+    va_list args;
+    va_start(args, format);
+    int written = std::vsnprintf(slot.pending, LabelCapacity, format, args);
+    va_end(args);
+    if (written < 0) {
+        return;
+    }
+    slot.pendingLength = std::min(static_cast<size_t>(written), LabelCapacity - 1);
+    markLabelDirty(handle.index);
+}
+
+void ofxGuiJson::markLabelDirty(uint32_t index) {
+    if (!labelSlots[index].dirty) {
+        labelSlots[index].dirty = true;
+        dirtyLabels.push_back(index);
+    }
+}
 
-    toggle->setup(label, false, width, height);
-    toggle->setPosition(posX, posY);
-    gui.add(toggle.get());
-    guiElementsMap[id] = toggle;
-    dynamicToggles.insert(id); // Maintain a set of dynamically added toggles
+size_t ofxGuiJson::commitLabelUpdates() {
+    GuiProfiler::ScopedTimer timer(profiler, GuiProfileScope::CommitLabels);
+    size_t changed = 0;
+    for (uint32_t index : dirtyLabels) {
+        LabelSlot& slot = labelSlots[index];
+        slot.dirty = false;
+        if (!slot.element.isValid()) {
+            continue;  // The label was removed by a config reload
+        }
+        if (slot.committed.size() == slot.pendingLength &&
+            std::memcmp(slot.committed.data(), slot.pending, slot.pendingLength) == 0) {
+            continue;  // Text did not change, leave the widget alone
+        }
+        slot.committed.assign(slot.pending, slot.pendingLength);
+        backend->setLabel(slot.element, slot.committed);
+        dirtyTracker.markDirty(slot.panel);
+        if (slot.layoutNode != GuiLayout::NoNode) {
+            layout.setContentWidth(slot.layoutNode, GuiLayout::measureElementWidth(GuiElementType::Label, slot.committed));
+        }
+        changed++;
+    }
+    dirtyLabels.clear();
+    profiler.count(GuiCounter::LabelsChanged, changed);
+    if (changed > 0) {
+        applyLayout();  // Only labels whose new width moves their siblings cost more than the text
+    }
+    return changed;
+}
 
-    // Adjust GUI size or enable scrolling as needed
-    if (posY + height > gui.getHeight()) {
-        gui.setSize(gui.getWidth(), posY + height + 20);
+void ofxGuiJson::buildBoundLabels() {
+    boundLabels.clear();
+    for (size_t i = 0; i < model.size(); i++) {
+        if (model.binds[i].empty() || !modelElements[i].isValid()) {
+            continue;
+        }
+        if (model.ids[i] == GuiModel::NoId) {
+            ofLogWarning() << "Ignoring 'bind' of a label without an 'id'.";
+            continue;
+        }
+        BoundLabel bound;
+        bound.label = getLabelHandle(model.idOf(i));
+        bound.element = i;
+        if (!bound.label.isValid()) {
+            continue;
+        }
+        std::string error;
+        if (!bound.format.compile(model.formats[i], model.binds[i].size(), error)) {
+            ofLogError() << "Invalid 'format' for label '" << model.idOf(i) << "': " << error;
+            continue;
+        }
+        bound.values.assign(model.binds[i].size(), GuiValueRegistry::NoValue);
+        bound.samples.resize(model.binds[i].size());
+        bound.intervalMillis = rateToIntervalMillis(model.maxRates[i]);
+        boundLabels.push_back(std::move(bound));
     }
+    resolveBoundLabels();
 
-    ofLogNotice() << "New toggle added: " << label << " with ID: " << id;
+    if (!boundLabels.empty() && !bindingSubscribed) {
+        bindingListener = ofEvents().update.newListener(this, &ofxGuiJson::onUpdateBindings);
+        bindingSubscribed = true;
+    }
 }
 
+void ofxGuiJson::resolveBoundLabels() {
+    for (BoundLabel& bound : boundLabels) {
+        const std::vector<std::string>& names = model.binds[bound.element];
+        for (size_t v = 0; v < names.size(); v++) {
+            bound.values[v] = values.find(names[v]);
+        }
+    }
+}
 
-void ofxGuiJson::removeLastToggle() {
-    if (!guiElementsMap.empty()) {
-        auto it = guiElementsMap.end();
-        do {
-            if (it == guiElementsMap.begin()) {
-                ofLogError() << "No dynamic toggles to remove.";
-                return;  // Exit if there are no dynamic toggles or if we've checked all toggles
+size_t ofxGuiJson::updateBindings() {
+    if (boundLabels.empty()) {
+        return 0;
+    }
+    GuiProfiler::ScopedTimer timer(profiler, GuiProfileScope::UpdateBindings);
+    uint64_t now = ofGetElapsedTimeMillis();
+    for (BoundLabel& bound : boundLabels) {
+        if (bound.rendered && bound.intervalMillis > 0 && now - bound.lastSampleMillis < bound.intervalMillis) {
+            continue;
+        }
+        bound.lastSampleMillis = now;
+
+        // Values that did not change render the same text, so the label is not formatted again
+        bool changed = !bound.rendered;
+        bool registered = true;
+        for (size_t v = 0; v < bound.values.size(); v++) {
+            GuiValueSample sample = values.sample(bound.values[v]);
+            registered = registered && sample.type != GuiValueType::None;
+            if (sample != bound.samples[v]) {
+                bound.samples[v] = sample;
+                changed = true;
             }
-            --it;  // Move to the previous element
-        } while (dynamicToggles.find(it->first) == dynamicToggles.end());  // Continue while the toggle is not dynamic
+        }
+        if (!changed || !registered) {
+            continue;
+        }
+        LabelSlot& slot = labelSlots[bound.label.index];
+        slot.pendingLength = bound.format.render(bound.samples.data(), slot.pending, LabelCapacity);
+        markLabelDirty(bound.label.index);
+        bound.rendered = true;
+    }
+    return commitLabelUpdates();
+}
 
-        // Remove the toggle from the dynamicToggles set and guiElementsMap
-        dynamicToggles.erase(it->first);
-        guiElementsMap.erase(it);
+void ofxGuiJson::onUpdateBindings(ofEventArgs&) {
+    updateBindings();
+}
+
+void ofxGuiJson::buildLayout() {
+    layout.build(model);
+    for (const auto& entry : labelSlotLookup) {
+        labelSlots[entry.second].layoutNode = layout.findElement(model.findId(strings.name(entry.first)));
+    }
+}
+
+void ofxGuiJson::applyLayout() {
+    if (!layout.update()) {
+        return;
+    }
+    for (uint32_t node : layout.getMoved()) {
+        uint32_t index = layout.getSlot(node);
+        ofRectangle rect = GuiLayout::toElementRect(model, index, layout.getRect(node));
+        model.rects[index] = rect;  // A reload compares against the rects shown
+        if (modelElements[index].isValid()) {
+            backend->setRect(modelElements[index], rect);
+            dirtyTracker.markDirty(model.panelIndices[index]);
+        }
+    }
+    profiler.count(GuiCounter::ElementsMoved, layout.getStats().moved);
+}
+
+void ofxGuiJson::applyToggleLayout() {
+    if (!toggleLayout.update()) {
+        return;
+    }
+    for (uint32_t node : toggleLayout.getMoved()) {
+        auto entry = dynamicToggleSlots.find(toggleLayout.getSlot(node));
+        if (entry != dynamicToggleSlots.end()) {
+            backend->setRect(entry->second->element, toggleLayout.getRect(node));
+        }
+    }
+    profiler.count(GuiCounter::ElementsMoved, toggleLayout.getStats().moved);
+}
+
+WidgetHandle ofxGuiJson::createAndAddToggle(const std::string& label, const std::string& baseId) {
+    std::string name = baseId + std::to_string(dynamicToggleCount++); // Generate an ID unique to this instance
+    GuiId id = strings.intern(name);
+    if (guiElementsMap.count(id)) {
+        ofLogError() << "Cannot add toggle, ID '" << name << "' is already in use.";
+        return WidgetHandle();
+    }
+
+    float width = 100; // Default width
+    float height = 20; // Default height
+    if (toggleColumn == GuiLayout::NoNode) {
+        GuiLayoutSpec column;
+        column.type = GuiLayoutType::Column;
+        column.gap = 10;
+        toggleColumn = toggleLayout.addGroup(GuiLayout::NoNode, column, ofRectangle(0, 0, 0, 0), 0);
+    }
+
+    // Appended to the column, only the new toggle is placed
+    uint32_t layoutNode = toggleLayout.addItem(toggleColumn, ofRectangle(0, 0, width, height),
+        GuiFixedWidth | GuiFixedHeight, width, height, GuiLayout::NoNode);
+    toggleLayout.update();
+    GuiElementRef guiElement = backend->createToggle(label, false, toggleLayout.getRect(layoutNode));
+    toggleLayout.setSlot(layoutNode, guiElement.handle.index);
+    profiler.count(GuiCounter::WidgetsCreated);
+    backend->addToMainPanel(guiElement);
+    backend->setRect(guiElement, toggleLayout.getRect(layoutNode));  // Placed once the main panel holds it
+    guiElementsMap[id] = guiElement;
+    bindElement(guiElement, id);
 
-        // Rebuild the GUI
-        rebuildGui();
+    // Register in insertion order, with lookups for removal by ID or handle
+    dynamicToggles.push_back({ id, guiElement, layoutNode });
+    auto entry = std::prev(dynamicToggles.end());
+    dynamicToggleIds[id] = entry;
+    dynamicToggleSlots[guiElement.handle.index] = entry;
+
+    ofLogNotice() << "New toggle added: " << label << " with ID: " << name;
+    return guiElement.handle;
+}
+
+
+void ofxGuiJson::removeLastToggle() {
+    if (!dynamicToggles.empty()) {
+        eraseDynamicToggle(std::prev(dynamicToggles.end()));
         ofLogNotice() << "Dynamic toggle removed.";
     }
     else {
@@ -217,35 +1390,54 @@ void ofxGuiJson::removeLastToggle() {
     }
 }
 
+bool ofxGuiJson::removeDynamicToggle(WidgetHandle handle) {
+    auto it = dynamicToggleSlots.find(handle.index);
+    if (it == dynamicToggleSlots.end() || it->second->element.handle.generation != handle.generation) {
+        return false;  // Stale handle, the slot was reused
+    }
+    eraseDynamicToggle(it->second);
+    return true;
+}
+
+bool ofxGuiJson::removeDynamicToggle(const std::string& id) {
+    auto it = dynamicToggleIds.find(strings.find(id));
+    if (it == dynamicToggleIds.end()) {
+        return false;
+    }
+    eraseDynamicToggle(it->second);
+    return true;
+}
+
+void ofxGuiJson::eraseDynamicToggle(std::list<DynamicToggle>::iterator entry) {
+    GuiId id = entry->id;
+    backend->removeFromMainPanel(entry->element);  // Nothing moves yet, the toggle layout places the rows below
+    toggleLayout.remove(entry->layoutNode);
+    dynamicToggleIds.erase(id);
+    dynamicToggleSlots.erase(entry->element.handle.index);
+    dynamicToggles.erase(entry);
+    removeGuiElement(id);
+    applyToggleLayout();
+}
+
 void ofxGuiJson::rebuildGui() {
-    gui.clear();
+    backend->clearMainPanel();
     for (const auto& id : staticToggles) { 
-        if (guiElementsMap.find(id) != guiElementsMap.end()) {
-            gui.add(guiElementsMap[id].get());
+        auto it = guiElementsMap.find(strings.find(id));
+        if (it != guiElementsMap.end()) {
+            backend->addToMainPanel(it->second);
         }
     }
-    for (const auto& id : dynamicToggles) {  // Ensure dynamic elements are added after static ones.
-        if (guiElementsMap.find(id) != guiElementsMap.end()) {
-            gui.add(guiElementsMap[id].get());
-        }
+    for (const auto& dynamicToggle : dynamicToggles) {  // Ensure dynamic elements are added after static ones, in insertion order.
+        backend->addToMainPanel(dynamicToggle.element);
     }
 }
 
 void ofxGuiJson::setBackgroundColor() {
-    if (config.contains("background_color") && config["background_color"].is_array()) {
-        auto bgColor = config["background_color"];
-        if (bgColor.size() == 3) {
-            int r = bgColor[0];
-            int g = bgColor[1];
-            int b = bgColor[2];
-            ofSetBackgroundColor(r, g, b);
-        }
-        else {
-            ofLogError() << "Invalid 'background_color' format. Expected an array of 3 integers.";
-        }
+    const GuiSettings& settings = model.settings;
+    if (settings.hasBackgroundColor) {
+        ofSetBackgroundColor(settings.backgroundColor[0], settings.backgroundColor[1], settings.backgroundColor[2]);
     }
     else {
         ofLogWarning() << "'background_color' not specified or in incorrect format. Using default background color.";
     }
 }
-
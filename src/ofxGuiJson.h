@@ -19,13 +19,36 @@
 
 #include "ofMain.h"
 #include "ofxGui.h"
+#include "ofxGuiJsonModel.h"
+#include "ofxGuiJsonLoader.h"
+#include "ofxGuiJsonAudioBridge.h"
+#include "ofxGuiJsonDirtyTracker.h"
+#include "ofxGuiJsonBackend.h"
+#include "ofxGuiJsonWidgetBackend.h"
+#include "ofxGuiJsonHeadlessBackend.h"
+#include "ofxGuiJsonParallel.h"
+#include "ofxGuiJsonId.h"
+#include "ofxGuiJsonEvent.h"
+#include "ofxGuiJsonProfiler.h"
+#include "ofxGuiJsonSnapshot.h"
+#include "ofxGuiJsonRemote.h"
+#include "ofxGuiJsonLayout.h"
+#include "ofxGuiJsonBinding.h"
 #include <json.hpp>
 #include <fstream>
 #include <memory> 
 #include <map>   
 #include <string>
 #include <set>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
+#include <filesystem>
+#include <future>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
 
 using json = nlohmann::json;
 
@@ -35,24 +58,134 @@ using json = nlohmann::json;
  */
 class ofxGuiJson {
 public:
+    /*!
+     *  @brief Creates a GUI shown with ofxGui widgets.
+     */
+    ofxGuiJson();
+
+    /*!
+     *  @brief Creates a GUI shown through another backend, e.g. a GuiHeadlessBackend in tests.
+     *  @param backend The backend. Widget accessors such as getGuiWidget() return nullptr
+     *                 unless it is a GuiWidgetBackend.
+     */
+    explicit ofxGuiJson(std::unique_ptr<GuiBackend> backend);
+
+    /*!
+     *  @brief Detaches the listeners from the elements before the backend destroys them.
+     */
+    ~ofxGuiJson();
+
     /*!
      *  @brief Sets up the GUI from a configuration file.
      *  @param configFile The path to the JSON configuration file.
+     *  @param watchConfig If true, the file is watched and changes are applied with reloadConfig().
+     */
+    void setup(const std::string& configFile, bool watchConfig = false);
+
+    /*!
+     *  @brief Sets up the GUI without blocking: the file is read and parsed on a worker thread,
+     *         and only the widgets are created on the main thread, during the first update after
+     *         the worker finishes. onSetupComplete is notified when the GUI is ready.
+     *  @param configFile The path to the JSON configuration file.
+     *  @param watchConfig If true, the file is watched once setup completes.
+     */
+    void setupAsync(const std::string& configFile, bool watchConfig = false);
+
+    /*!
+     *  @brief Returns true once setup() has run or setupAsync() has completed.
      */
-    void setup(const std::string& configFile);
+    bool isSetupComplete() const { return setupComplete; }
 
     /*!
-     *  @brief Loads JSON configuration from a file.
+     *  @brief Event notified on the main thread when setupAsync() completes. The argument is
+     *         true if the configuration was loaded.
+     */
+    ofEvent<bool> onSetupComplete;
+
+    /*!
+     *  @brief Enables or disables watching the configuration file passed to setup() and the files it includes.
+     *  @param watch True to reload the GUI when one of the files changes.
+     *  @param intervalMillis How often the modification time of the file is checked.
+     */
+    void setWatchConfig(bool watch, uint64_t intervalMillis = 500);
+
+    /*!
+     *  @brief Reloads the configuration file and reconciles the GUI with it. Elements are matched
+     *         by ID; only elements that were added, removed or changed are touched, so toggle
+     *         state and listeners of untouched elements survive the reload.
+     *  @return True if the file was loaded, false if it could not be read (the current GUI is kept).
+     */
+    bool reloadConfig();
+
+    /*!
+     *  @brief Loads JSON configuration from a file and compiles it into the GUI model.
+     *         The file is memory mapped and streamed into the model without building a
+     *         JSON DOM, unless setRetainConfig(true) was called.
      *  @param path The path to the JSON file.
      */
     void loadJson(const std::string& path);
 
     /*!
      *  @brief Returns the current JSON configuration.
-     *  @return A reference to the JSON configuration.
+     *  @return A reference to the JSON configuration. Null unless setRetainConfig(true) was called before loading.
      */
     const json& getConfig() const { return config; }
 
+    /*!
+     *  @brief Sets whether loadJson also keeps the full JSON DOM available through getConfig().
+     *  @param retain True to build and keep the DOM, false to stream straight into the model.
+     */
+    void setRetainConfig(bool retain) { retainConfig = retain; }
+
+    /*!
+     *  @brief Sets whether loads go through the binary cache written next to the configuration
+     *         (config.json.cache). The cache is used only while the hash of the text matches, and
+     *         rewritten after the text is parsed. On by default.
+     *  @param enable True to use the cache, false to always parse the text.
+     */
+    void setBinaryCache(bool enable) { binaryCache = enable; }
+
+    /*!
+     *  @brief Sets whether loads check the configuration against the schema (GuiSchema::builtin())
+     *         while parsing it. A configuration with errors is not loaded: every error is logged with
+     *         its JSON pointer, e.g. "config.json#/panels/0/elements/3/type", and a reload keeps the
+     *         current GUI. On by default.
+     *  @param enable True to validate, false to load whatever the configuration contains.
+     */
+    void setSchemaValidation(bool enable) { schemaValidation = enable; }
+
+    /*!
+     *  @brief Sets the number of threads preparing panels in parseGuiElements(). Widgets are still
+     *         created and attached on the calling thread in configuration order, so the GUI is the
+     *         same for any thread count.
+     *  @param threads The thread count, 0 for one per hardware thread, 1 to run on the calling thread only.
+     */
+    void setBuildThreads(size_t threads) { buildThreads = threads; }
+
+    /*!
+     *  @brief Returns the timings of the last configuration load.
+     *  @return A reference to the load statistics.
+     */
+    const GuiLoadStats& getLoadStats() const { return loadStats; }
+
+    /*!
+     *  @brief Returns the layout of the panels with a "layout" or groups, e.g. for the work done
+     *         by the last relayout.
+     */
+    const GuiLayout& getLayout() const { return layout; }
+
+    /*!
+     *  @brief Returns the compiled GUI model. Prefer this over getConfig() in per-frame code.
+     *  @return A reference to the compiled GUI model.
+     */
+    const GuiModel& getModel() const { return model; }
+
+    /*!
+     *  @brief Returns the typed settings block of the compiled GUI model.
+     *  @return A reference to the settings.
+     */
+    const GuiSettings& getSettings() const { return model.settings; }
+
     /*!
      *  @brief Updates the labels of the GUI elements.
      *  @param labelUpdates A map of label updates where the key is the old label and the value is the new label.
@@ -60,39 +193,341 @@ public:
     void updateGuiLabels(const std::map<std::string, std::string>& labelUpdates);
 
     /*!
-     *  @brief Creates and adds a toggle button to the GUI.
+     *  @brief Maximum length of a label text written through a LabelHandle, including the terminator.
+     */
+    static constexpr size_t LabelCapacity = 128;
+
+    /*!
+     *  @struct LabelHandle
+     *  @brief Stable handle to a label, resolved once with getLabelHandle().
+     */
+    struct LabelHandle {
+        uint32_t index = UINT32_MAX;    //!< Index of the label slot.
+
+        /*!
+         *  @brief Returns true if the handle refers to a label.
+         */
+        bool isValid() const { return index != UINT32_MAX; }
+    };
+
+    /*!
+     *  @brief Resolves a label ID to a handle. Call once, not per frame.
+     *  @param id The ID of the label.
+     *  @return The handle, invalid if no label with this ID exists.
+     */
+    LabelHandle getLabelHandle(const std::string& id);
+
+    /*!
+     *  @brief Writes the text of a label into its pending buffer. Takes effect on commitLabelUpdates().
+     *         Text longer than LabelCapacity - 1 is truncated.
+     *  @param handle The handle of the label.
+     *  @param text The new text.
+     *  @param length The length of the text.
+     */
+    void setLabelText(LabelHandle handle, const char* text, size_t length);
+
+    /*!
+     *  @brief Writes the text of a label into its pending buffer.
+     *  @param handle The handle of the label.
+     *  @param text The new text.
+     */
+    void setLabelText(LabelHandle handle, const std::string& text) { setLabelText(handle, text.data(), text.size()); }
+
+    /*!
+     *  @brief Formats the text of a label printf-style directly into its pending buffer.
+     *  @param handle The handle of the label.
+     *  @param format The printf format string.
+     */
+    void setLabelTextf(LabelHandle handle, const char* format, ...);
+
+    /*!
+     *  @brief Applies all pending label texts, touching only the labels whose text changed.
+     *  @return The number of labels that were updated.
+     */
+    size_t commitLabelUpdates();
+
+    /*!
+     *  @brief Registers an application value that labels declared with "bind" show, replacing any
+     *         value with the same name. Labels bound to a name that is not registered keep their text.
+     *  @param name The name used by "bind", e.g. "audio.frequency".
+     *  @param value A const float*, double*, int* or bool* that outlives its registration, or a
+     *               callable returning a double, e.g. a lambda reading a value of another thread.
+     */
+    template<typename T>
+    void registerValue(const std::string& name, T value) {
+        values.add(name, std::move(value));
+        resolveBoundLabels();
+    }
+
+    /*!
+     *  @brief Unregisters an application value. Labels bound to it keep their last text.
+     *  @param name The name of the value.
+     *  @return True if the name was registered.
+     */
+    bool unregisterValue(const std::string& name) { return values.remove(name); }
+
+    /*!
+     *  @brief Samples the values of the bound labels that are due, no faster than their "max_rate",
+     *         renders the labels whose values changed and commits them. Called on every update;
+     *         call it directly in apps that do not run the update loop.
+     *  @return The number of labels that were updated.
+     */
+    size_t updateBindings();
+
+    /*!
+     *  @brief Creates and adds a toggle button to the GUI, below the previous ones.
      *  @param label The label for the toggle button.
-     *  @param id The identifier for the toggle button.
+     *  @param id The identifier for the toggle button. A counter owned by this instance is
+     *            appended to make it unique.
+     *  @return The handle of the toggle, invalid if the generated ID is already taken.
      */
-    void createAndAddToggle(const std::string& label, const std::string& id);
+    WidgetHandle createAndAddToggle(const std::string& label, const std::string& id);
 
     /*!
-     *  @brief Removes the last added toggle from the GUI.
+     *  @brief Removes the most recently added toggle from the GUI.
      */
     void removeLastToggle();
 
+    /*!
+     *  @brief Removes a dynamic toggle. Only its widget is detached, the rows below it move up.
+     *  @param handle The handle returned by createAndAddToggle().
+     *  @return True if the toggle was removed, false for stale handles.
+     */
+    bool removeDynamicToggle(WidgetHandle handle);
+
+    /*!
+     *  @brief Removes a dynamic toggle by its generated ID, as carried by onToggleEvent.
+     *  @param id The ID of the toggle.
+     *  @return True if the toggle was removed.
+     */
+    bool removeDynamicToggle(const std::string& id);
+
+    /*!
+     *  @brief Returns the interned ID of an element ID or action name.
+     *  @param name The name.
+     *  @return The ID, invalid if no loaded element uses the name.
+     */
+    GuiId getGuiId(const std::string& name) const { return strings.find(name); }
+
+    /*!
+     *  @brief Returns the name of an interned ID.
+     *  @param id The ID.
+     *  @return The name, empty for invalid IDs.
+     */
+    const std::string& getName(GuiId id) const { return strings.name(id); }
+
     /*!
      *  @brief Rebuilds the entire GUI.
      */
     void rebuildGui();
 
     /*!
-     *  @brief Parses the GUI elements from the JSON configuration.
+     *  @brief Creates the GUI panels and elements from the compiled GUI model.
      */
     void parseGuiElements();
 
+    /*!
+     *  @brief Destroys all panels and widgets at once. The model is kept, so parseGuiElements()
+     *         can build the GUI again.
+     */
+    void clearGui();
+
     /*!
      *  @brief Returns a reference to the vector of shared pointers to panels.
-     *  @return A reference to the vector of shared pointers to panels.
+     *  @return A reference to the vector of shared pointers to panels. Without the ofxGui backend an
+     *          error is logged and an empty vector owned by this instance is returned; it is emptied
+     *          again on every call, so panels added to it are never shown.
      */
     std::vector<std::shared_ptr<ofxPanel>>& getPanels();
 
     /*!
-     *  @brief Sets up a GUI panel based on the JSON configuration.
+     *  @brief Returns the backend showing the elements.
+     */
+    GuiBackend& getBackend() { return *backend; }
+
+    /*!
+     *  @brief Returns the element of an ID, to pass to the backend.
+     *  @param id The ID of the element.
+     *  @return The element, invalid if no element has this ID.
+     */
+    GuiElementRef findElement(GuiId id) const;
+
+    /*!
+     *  @brief Returns the element of an ID, to pass to the backend.
+     *  @param id The ID of the element.
+     */
+    GuiElementRef findElement(const std::string& id) const { return findElement(strings.find(id)); }
+
+    /*!
+     *  @brief Sets the value of an element as if the user changed it: its events are notified,
+     *         coalesced elements on the next flushChanges(). A button is clicked whatever the value.
+     *  @param id The ID of the element.
+     *  @param value The value: non-zero for toggles, rounded for integers and dropdown options.
+     *  @return False if no element with a value has this ID.
+     */
+    bool setElementValue(GuiId id, float value);
+
+    /*!
+     *  @brief Sets the value of an element as if the user changed it.
+     *  @param id The ID of the element.
+     *  @param value The value.
+     */
+    bool setElementValue(const std::string& id, float value) { return setElementValue(strings.find(id), value); }
+
+    /*!
+     *  @brief Returns the value of an element: 1 or 0 for toggles, the index of the option for dropdowns.
+     *  @param id The ID of the element.
+     *  @return The value, 0 if no element with a value has this ID.
+     */
+    float getElementValue(GuiId id) const;
+
+    /*!
+     *  @brief Returns the value of an element.
+     *  @param id The ID of the element.
+     */
+    float getElementValue(const std::string& id) const { return getElementValue(strings.find(id)); }
+
+    /*!
+     *  @brief Returns the values of all elements. The snapshot is never changed once returned,
+     *         the next change copies it first, so it can be kept or read on another thread.
+     */
+    std::shared_ptr<const GuiSnapshot> getSnapshot() const { return state; }
+
+    /*!
+     *  @brief Saves the values of all elements, blocking until the file is written.
+     *  @param path The path of the file, relative to the data folder. Files ending in .json or .xml
+     *              are written for people to read, any other is written in the binary format.
+     *  @return False if the file could not be written.
+     */
+    bool saveSnapshot(const std::string& path) const;
+
+    /*!
+     *  @brief Restores the values saved by saveSnapshot() or by the autosave, in any format.
+     *         Each restored element notifies its listeners as if the user changed it.
+     *  @param path The path of the file, relative to the data folder.
+     *  @return False if the file could not be read.
+     */
+    bool loadSnapshot(const std::string& path);
+
+    /*!
+     *  @brief Sets the elements to the values of a snapshot. Elements that do not exist or whose
+     *         type changed since the snapshot was taken are skipped.
+     *  @param snapshot The values.
+     *  @return The number of elements set.
+     */
+    size_t applySnapshot(const GuiSnapshot& snapshot);
+
+    /*!
+     *  @brief Enables or disables saving the values on a background thread whenever they changed,
+     *         so the frame never waits for the disk. A last save runs when the GUI is destroyed.
+     *  @param enable True to autosave.
+     *  @param path The path of the file, relative to the data folder. The format follows the extension
+     *              as in saveSnapshot(); use the binary format for short intervals.
+     *  @param intervalMillis Minimum time between saves.
+     */
+    void setAutosave(bool enable, const std::string& path = "gui_state.bin", uint64_t intervalMillis = 500);
+
+    /*!
+     *  @brief Enables or disables remote control: other processes on this machine can set and get
+     *         the value of every element by ID, and subscribe to its changes, by sending batches of
+     *         messages to a UDP port on 127.0.0.1 (see GuiRemoteClient). The messages are applied
+     *         on the main thread by updateRemote(), once per frame.
+     *  @param enable True to open the endpoint.
+     *  @param port The port on 127.0.0.1, 0 for any free port (see getRemoteEndpoint()).
+     *  @return False if the port could not be opened.
+     */
+    bool setRemoteControl(bool enable, uint16_t port = 9100);
+
+    /*!
+     *  @brief Returns the remote control endpoint, for its port and traffic counters.
+     *  @return The endpoint, nullptr while remote control is disabled.
+     */
+    const GuiRemoteEndpoint* getRemoteEndpoint() const { return remote.get(); }
+
+    /*!
+     *  @brief Applies the waiting remote messages, then sends the replies and the changes to the
+     *         subscribers. Called on every update while remote control is enabled; call it directly
+     *         in apps that do not run the update loop.
+     *  @return The number of messages applied.
+     */
+    size_t updateRemote();
+
+    /*!
+     *  @brief Draws all panels. In cached mode, only panels marked dirty are rendered again,
+     *         the others are drawn from their offscreen buffers.
+     */
+    void draw();
+
+    /*!
+     *  @brief Enables or disables the cached render mode. Off by default.
+     *         Each panel is rendered into its own FBO, re-rendered only when one of its
+     *         widgets changed (label text, toggle state, pointer interaction) or its size changed.
+     *  @param cached True to render panels through their FBO caches.
+     */
+    void setCachedRendering(bool cached);
+
+    /*!
+     *  @brief Returns true if the cached render mode is enabled.
+     */
+    bool isCachedRendering() const { return cachedRendering; }
+
+    /*!
+     *  @brief Forces a panel to be rendered again on the next draw().
+     *  @param index The index of the panel in getPanels().
+     */
+    void markPanelDirty(size_t index) { dirtyTracker.markDirty(index); }
+
+    /*!
+     *  @brief Forces the panel holding an element to be rendered again on the next draw().
+     *         Call it after changing a widget directly through getGuiWidget().
+     *  @param id The ID of the element.
+     */
+    void markElementDirty(const std::string& id);
+
+    /*!
+     *  @brief Returns the dirty state of the panels in cached mode.
+     */
+    const GuiDirtyTracker& getDirtyTracker() const { return dirtyTracker; }
+
+    /*!
+     *  @brief Enables or disables timing and counting the GUI work of each frame. Off by default,
+     *         or on when the configuration has "profiler": { "enable": true }. Frames end on every update.
+     *  @param enable True to profile.
+     *  @param historyFrames Number of frames kept for getProfiler().getAverage().
+     */
+    void setProfiling(bool enable, size_t historyFrames = 120);
+
+    /*!
+     *  @brief Returns the timings and counters of the last completed frame.
+     */
+    const GuiFrameStats& getFrameStats() const { return profiler.getLastFrame(); }
+
+    /*!
+     *  @brief Returns the profiler, for the frame history and tracing.
+     */
+    GuiProfiler& getProfiler() { return profiler; }
+
+    /*!
+     *  @brief Shows or hides the profiler stats drawn by draw() over the panels. Needs the ofxGui backend.
+     *  @param show True to draw the stats.
+     *  @param x The left edge of the overlay.
+     *  @param y The baseline of its first line.
+     */
+    void setProfilerOverlay(bool show, float x = 10, float y = 20);
+
+    /*!
+     *  @brief Writes the scopes recorded since getProfiler().setTracing(true) as a Chrome trace.
+     *  @param path The path of the file, relative to the data folder.
+     *  @return False if the file could not be written.
+     */
+    bool writeChromeTrace(const std::string& path) const { return profiler.writeChromeTrace(ofToDataPath(path, true)); }
+
+    /*!
+     *  @brief Sets up a GUI panel based on its compiled model. Needs the ofxGui backend.
      *  @param panel The panel to be set up.
-     *  @param panelConfig The JSON configuration for the panel.
+     *  @param panelModel The compiled model of the panel.
      */
-    void setupPanel(ofxPanel& panel, const json& panelConfig);
+    void setupPanel(ofxPanel& panel, const GuiPanelModel& panelModel);
 
     /*!
      *  @brief Sets the background color of the GUI.
@@ -100,70 +535,840 @@ public:
     void setBackgroundColor();
 
     /*!
-     *  @brief Event triggered when a toggle action occurs.
+     *  @brief Event triggered when a toggle action occurs, with the ID and the new state.
+     *         Kept for existing listeners, prefer onChange.
      */
     ofEvent<std::pair<std::string, bool>> onToggleEvent;
 
+    /*!
+     *  @brief Event triggered when any element changes, with a typed value and interned IDs.
+     */
+    ofEvent<GuiEvent> onChange;
+
+    /*!
+     *  @brief Returns the event notified when one element changes. The event belongs to the ID,
+     *         not to the widget, so listeners stay subscribed across reloads and can be added
+     *         before the element exists.
+     *  @param id The ID of the element.
+     */
+    ofEvent<GuiEvent>& getElementEvent(GuiId id) { return elementEvents[id]; }
+
+    /*!
+     *  @brief Returns the event notified when one element changes.
+     *  @param id The ID of the element.
+     */
+    ofEvent<GuiEvent>& getElementEvent(const std::string& id) { return elementEvents[strings.intern(id)]; }
+
+    /*!
+     *  @brief Enables or disables collecting changes for drainEvents(). Off by default.
+     *  @param enable True to collect changes. Call drainEvents() every frame while enabled.
+     *  @param capacity Number of changes per frame held without allocating.
+     */
+    void setEventQueue(bool enable, size_t capacity = 256) { eventQueue.setEnabled(enable, capacity); }
+
+    /*!
+     *  @brief Returns all changes since the previous call, in the order they happened.
+     *  @return The changes, valid until the next call.
+     */
+    const std::vector<GuiEvent>& drainEvents() { return eventQueue.drain(); }
+
+    /*!
+     *  @brief Notifies the coalesced changes of sliders and fields that are due: the latest value of
+     *         each, at most once per call and no faster than its "max_rate". Called on every update;
+     *         call it directly in apps that do not run the update loop.
+     *  @return The number of changes notified.
+     */
+    size_t flushChanges();
+
     /*!
      *  @brief Handles the action triggered by a toggle.
-     *  @param state The state of the toggle (true or false).
+     *  @deprecated Toggle changes are dispatched by ofxGuiJson itself, listen to onChange or
+     *              onToggleEvent instead. Kept for code that forwarded toggle parameters here.
+     *  @param checked The state of the toggle (true or false), the value of one of its toggle parameters.
+     */
+    [[deprecated("Toggle changes are dispatched by ofxGuiJson, listen to onChange or onToggleEvent")]]
+    void onToggleAction(bool& checked);
+
+    /*!
+     *  @brief Returns the audio parameters declared with "audio_parameter" in the configuration.
+     *         Resolve parameters on the main thread, then read them from the audio callback
+     *         without locks or allocations. The application can declare its own parameters too.
+     *  @return A reference to the audio parameter bridge.
      */
-    void onToggleAction(bool& state);
+    AudioParameterBridge& getAudioBridge() { return audioBridge; }
 
     /*!
      *  @brief Returns a reference to the main GUI panel.
-     *  @return A reference to the main GUI panel.
+     *  @return A reference to the main GUI panel. Without the ofxGui backend an error is logged and
+     *          a placeholder panel owned by this instance is returned, which is never drawn.
      */
-    ofxPanel& getGui() { return gui; }
+    ofxPanel& getGui();
 
     /*!
-     *  @brief Gets a GUI element by its label.
-     *  @param label The label of the GUI element.
-     *  @return A shared pointer to the GUI element.
+     *  @brief Gets the widget of a GUI element by its ID.
+     *  @param id The ID of the GUI element.
+     *  @return The widget, or nullptr if the ID is unknown or the backend has no widgets. Widgets
+     *          live in pools owned by the backend: the pointer is valid until the element is
+     *          removed or the GUI is rebuilt, and must not be deleted.
      */
-    std::shared_ptr<ofxBaseGui> getGuiElement(const std::string& label);
+    ofxBaseGui* getGuiWidget(const std::string& id);
 
     /*!
-     *  @brief Map linking toggle parameters to their IDs.
+     *  @brief Gets the widget of a GUI element by its interned ID, as carried by onChange.
+     *  @param id The ID of the GUI element.
+     *  @return The widget, or nullptr. Valid until the element is removed or the GUI is rebuilt.
      */
-    std::map<ofParameter<bool>*, std::string> toggleIdMap;
+    ofxBaseGui* getGuiWidget(GuiId id);
 
     /*!
-     *  @brief A set of dynamically created toggles.
+     *  @brief Gets a "virtual_list" element, to set its data source and refresh it.
+     *  @param id The ID of the list.
+     *  @return The list, or nullptr if there is no list with this ID. Valid until the element is removed;
+     *          a reload that changes its row type or count creates a new list without a source.
      */
-    std::set<std::string> dynamicToggles;
+    ofxGuiJsonVirtualList* getVirtualList(const std::string& id);
 
     /*!
-     *  @brief A set of static toggles.
+     *  @brief Map linking toggle parameters to their IDs, filled with the ofxGui backend only.
      */
-    std::set<std::string> staticToggles;
+    std::unordered_map<ofParameter<bool>*, GuiId> toggleIdMap;
 
     /*!
-    *  @brief A vector of shared pointers to GUI panels.
-    */
-    std::vector<std::shared_ptr<ofxPanel>> panels;
+     *  @brief A set of static toggles.
+     */
+    std::set<std::string> staticToggles;
 
     /*!
      *  @brief Current JSON configuration.
      */
     json config;
 
+    /*!
+     *  @brief The configuration compiled into typed element arrays.
+     */
+    GuiModel model;
+
+    /*!
+     *  @brief Whether loadJson keeps the JSON DOM in config.
+     */
+    bool retainConfig = false;
+
+    /*!
+     *  @brief Whether loads read and write the binary cache.
+     */
+    bool binaryCache = true;
+
+    /*!
+     *  @brief Whether loads check the configuration against the schema.
+     */
+    bool schemaValidation = true;
+
+    /*!
+     *  @brief Number of threads preparing panels, 0 for one per hardware thread.
+     */
+    size_t buildThreads = 0;
+
+    /*!
+     *  @brief Timings of the last configuration load.
+     */
+    GuiLoadStats loadStats;
+
 private:
     /*!
-     *  @brief The main GUI panel.
+     *  @brief The backend showing the elements.
+     */
+    std::unique_ptr<GuiBackend> backend;
+
+    /*!
+     *  @brief The backend as a GuiWidgetBackend, nullptr for other backends.
+     */
+    GuiWidgetBackend* widgets = nullptr;
+
+    /*!
+     *  @brief Placeholder returned by getGui() without the ofxGui backend, created on first use.
+     */
+    std::unique_ptr<ofxPanel> detachedGui;
+
+    /*!
+     *  @brief Placeholder returned by getPanels() without the ofxGui backend, always empty when returned.
+     */
+    std::vector<std::shared_ptr<ofxPanel>> detachedPanels;
+
+    /*!
+     *  @brief Element IDs and action names interned at load time. Never cleared, so IDs stay valid across reloads.
+     */
+    GuiStringTable strings;
+
+    /*!
+     *  @brief Interns the element IDs and actions of the model.
+     */
+    void internModel();
+
+    /*!
+     *  @brief Per-element events by ID. Node-based, so bindings can keep pointers to them.
+     */
+    std::unordered_map<GuiId, ofEvent<GuiEvent>> elementEvents;
+
+    /*!
+     *  @brief Changes collected for drainEvents().
+     */
+    GuiEventQueue eventQueue;
+
+    /*!
+     *  @brief Queues a change and notifies the element event and onChange.
+     *  @param event The change.
+     *  @param elementEvent The event of the element.
+     */
+    void dispatchEvent(GuiEvent& event, ofEvent<GuiEvent>& elementEvent);
+
+    /*!
+     *  @brief A map linking element IDs to their elements in the backend.
+     */
+    std::unordered_map<GuiId, GuiElementRef> guiElementsMap;
+
+    /*!
+     *  @struct LabelSlot
+     *  @brief Label resolved by getLabelHandle() together with its committed and pending text.
+     */
+    struct LabelSlot {
+        GuiElementRef element;                       //!< The label, invalid once removed by a reload.
+        size_t panel = GuiDirtyTracker::NoPanel;     //!< The panel holding the label.
+        std::string committed;                       //!< The text currently shown.
+        char pending[LabelCapacity];                 //!< The text to show after the next commit.
+        size_t pendingLength = 0;                    //!< The length of the pending text.
+        bool dirty = false;                          //!< Whether the slot is queued in dirtyLabels.
+        uint32_t layoutNode = GuiLayout::NoNode;     //!< The label in the layout, NoNode outside layouts.
+    };
+
+    /*!
+     *  @brief Label slots indexed by LabelHandle::index.
+     */
+    std::vector<LabelSlot> labelSlots;
+
+    /*!
+     *  @brief Lookup from label ID to its slot index.
+     */
+    std::unordered_map<GuiId, uint32_t> labelSlotLookup;
+
+    /*!
+     *  @brief Slots written since the last commit.
+     */
+    std::vector<uint32_t> dirtyLabels;
+
+    /*!
+     *  @brief Queues a slot for the next commit.
+     *  @param index The index of the slot.
+     */
+    void markLabelDirty(uint32_t index);
+
+    /*!
+     *  @struct BoundLabel
+     *  @brief A label declared with "bind", compiled once per build so sampling it neither looks up
+     *         names nor allocates.
+     */
+    struct BoundLabel {
+        LabelHandle label;                      //!< The label.
+        size_t element = 0;                     //!< Index of the label in the model, whose "bind" names the values.
+        GuiLabelFormat format;                  //!< The compiled "format".
+        std::vector<uint32_t> values;           //!< Registry index of each bound value, NoValue until registered.
+        std::vector<GuiValueSample> samples;    //!< The values rendered last.
+        uint64_t intervalMillis = 0;            //!< Minimum time between samples, 0 for once per update.
+        uint64_t lastSampleMillis = 0;          //!< When the values were last sampled.
+        bool rendered = false;                  //!< Whether the label shows its values yet.
+    };
+
+    /*!
+     *  @brief The application values bound labels read.
+     */
+    GuiValueRegistry values;
+
+    /*!
+     *  @brief The labels of the model declared with "bind".
+     */
+    std::vector<BoundLabel> boundLabels;
+
+    /*!
+     *  @brief Compiles the bound labels of the model. Called after every build and reload.
+     */
+    void buildBoundLabels();
+
+    /*!
+     *  @brief Looks up the values of the bound labels, after a value is registered.
+     */
+    void resolveBoundLabels();
+
+    /*!
+     *  @brief Calls updateBindings(). Bound to the update event once a bound label exists.
+     */
+    void onUpdateBindings(ofEventArgs&);
+
+    /*!
+     *  @brief Samples the bound labels, subscribed once a bound label exists.
+     */
+    ofEventListener bindingListener;
+
+    /*!
+     *  @brief Whether bindingListener is subscribed.
+     */
+    bool bindingSubscribed = false;
+
+    /*!
+     *  @brief Creates, registers and binds the element of a model entry without adding it to a panel.
+     *  @param index The index of the element in the model.
+     *  @param rect The position and size of the element.
+     *  @return The element, invalid for unknown element types.
+     */
+    GuiElementRef createGuiElement(size_t index, const ofRectangle& rect);
+
+    /*!
+     *  @struct PanelPlan
+     *  @brief The construction work of a panel that needs no backend calls, prepared on worker threads.
+     */
+    struct PanelPlan {
+        std::vector<uint32_t> elements;     //!< Model indices of the elements to create, in order.
+        std::vector<ofRectangle> rects;     //!< Position and size of each element, defaults resolved.
+        GuiTypeCounts counts = {};          //!< Number of elements of each type in the panel.
+    };
+
+    /*!
+     *  @brief Prepares the elements of a panel. Only reads the model, so panels can be planned concurrently.
+     *  @param model The compiled model.
+     *  @param panelModel The compiled model of the panel.
+     *  @param plan Receives the elements to create.
+     */
+    static void planPanel(const GuiModel& model, const GuiPanelModel& panelModel, PanelPlan& plan);
+
+    /*!
+     *  @brief Returns the rectangle of an element, with a missing width or height replaced by the defaults.
+     *  @param model The compiled model.
+     *  @param index The index of the element.
+     */
+    static ofRectangle resolveElementRect(const GuiModel& model, size_t index);
+
+    /*!
+     *  @brief Sets up a panel of the backend and creates its elements from a plan. Must run on the main thread.
+     *  @param panel The index of the panel.
+     *  @param plan The plan of the panel.
+     */
+    void buildPanel(size_t panel, const PanelPlan& plan);
+
+    /*!
+     *  @brief Moves the elements of a panel to their layout rects once the panel holds them,
+     *         as attaching a widget places it below the previous one.
+     *  @param panel The index of the panel.
+     */
+    void placePanelElements(size_t panel);
+
+    /*!
+     *  @brief Configurations with fewer elements are planned on the calling thread,
+     *         where starting threads would cost more than it saves.
+     */
+    static constexpr size_t MinParallelElements = 1024;
+
+    /*!
+     *  @brief Makes room in the backend for the elements of the model and the dynamic toggles.
+     */
+    void reserveElements();
+
+    /*!
+     *  @brief Applies the changed properties of an element to its existing widget.
+     *  @param guiElement The element to update.
+     *  @param previousModel The model the widget was created from.
+     *  @param previousIndex The index of the element in the previous model.
+     *  @param index The index of the element in the current model.
+     *  @return True if anything changed.
+     */
+    bool updateGuiElement(const GuiElementRef& guiElement, const GuiModel& previousModel, size_t previousIndex, size_t index);
+
+    /*!
+     *  @brief Returns true if the widget of an element can be kept across a reload and updated in place.
+     *  @param previousModel The model the widget was created from.
+     *  @param previousIndex The index of the element in the previous model.
+     *  @param index The index of the element in the current model.
+     */
+    bool canReuseWidget(const GuiModel& previousModel, size_t previousIndex, size_t index) const;
+
+    /*!
+     *  @brief Unregisters an element, detaches its listener and releases its widget.
+     *  @param id The ID of the element.
+     */
+    void removeGuiElement(GuiId id);
+
+    /*!
+     *  @brief Diffs a newly loaded model against the current one and applies the changes.
+     *  @param nextModel The newly loaded model. Moved into the current model.
+     */
+    void reconcile(GuiModel& nextModel);
+
+    /*!
+     *  @brief Points label slots at the current elements after a reload.
+     */
+    void refreshLabelSlots();
+
+    /*!
+     *  @brief Checks the configuration file for changes. Bound to the update event while watching.
+     */
+    void checkConfigChanged(ofEventArgs&);
+
+    /*!
+     *  @brief Audio parameters fed by elements, read from the audio thread.
+     */
+    AudioParameterBridge audioBridge;
+
+    /*!
+     *  @struct AsyncLoad
+     *  @brief Result of a configuration load done on the worker thread by setupAsync().
+     */
+    struct AsyncLoad {
+        GuiModel model;         //!< The compiled model.
+        json config;            //!< The JSON DOM, if retained.
+        GuiLoadStats stats;     //!< Timings of the load.
+        GuiIncludeCache includes;   //!< The include files parsed by the load.
+        std::vector<GuiDependency> dependencies;    //!< The files included by the configuration.
+        bool loaded = false;    //!< Whether the load succeeded.
+    };
+
+    /*!
+     *  @brief Logs a completed load and applies its settings.
+     *  @param fullPath The path the configuration was loaded from.
+     */
+    void finishLoad(const std::string& fullPath);
+
+    /*!
+     *  @brief Creates the widgets from the loaded model and starts watching if requested.
+     *  @param fullPath The path the configuration was loaded from.
+     *  @param watchConfig Whether to watch the configuration file.
+     */
+    void finishSetup(const std::string& fullPath, bool watchConfig);
+
+    /*!
+     *  @brief Completes setupAsync() once the worker is done. Bound to the update event while loading.
+     */
+    void checkAsyncSetup(ofEventArgs&);
+
+    /*!
+     *  @brief The load running on the worker thread.
+     */
+    std::future<AsyncLoad> asyncLoad;
+
+    /*!
+     *  @brief Listener on the update event while an asynchronous setup is pending.
+     */
+    ofEventListener asyncListener;
+
+    /*!
+     *  @brief The path passed to setupAsync().
+     */
+    std::string asyncPath;
+
+    /*!
+     *  @brief The watch flag passed to setupAsync().
+     */
+    bool asyncWatchConfig = false;
+
+    /*!
+     *  @brief Whether the GUI has been set up.
+     */
+    bool setupComplete = false;
+
+    /*!
+     *  @brief The elements of each panel in the order they were added.
+     */
+    std::vector<std::vector<GuiElementRef>> panelElements;
+
+    /*!
+     *  @brief The full path of the configuration file passed to setup().
+     */
+    std::string configPath;
+
+    /*!
+     *  @struct WatchedFile
+     *  @brief A file of the configuration checked for changes.
+     */
+    struct WatchedFile {
+        std::string path;                               //!< The full path of the file.
+        std::filesystem::file_time_type writeTime;      //!< Its modification time when it was last checked.
+    };
+
+    /*!
+     *  @brief Records the modification times of the configuration and the files it includes.
+     */
+    void watchConfigFiles();
+
+    /*!
+     *  @brief The configuration file and the files it includes, while the configuration is watched.
+     */
+    std::vector<WatchedFile> watchedFiles;
+
+    /*!
+     *  @brief The files included by the loaded configuration.
+     */
+    std::vector<GuiDependency> configDependencies;
+
+    /*!
+     *  @brief Include files parsed by previous loads, so a reload parses only the files that changed.
+     */
+    GuiIncludeCache includeCache;
+
+    /*!
+     *  @brief Listener on the update event while the configuration file is watched.
+     */
+    ofEventListener watchListener;
+
+    /*!
+     *  @brief How often the configuration file is checked, in milliseconds.
+     */
+    uint64_t watchInterval = 500;
+
+    /*!
+     *  @brief Time of the last check of the configuration file.
+     */
+    uint64_t lastWatchCheck = 0;
+
+    /*!
+     *  @struct ElementBinding
+     *  @brief Dispatch record resolved once when an element is created, so a change
+     *         goes straight to its ID without searching the element maps or the JSON.
+     */
+    struct ElementBinding {
+        GuiId id;                                   //!< The ID of the element.
+        std::pair<std::string, bool> eventParam;    //!< onToggleEvent payload reused on every dispatch, toggles only.
+        GuiEvent event;                             //!< onChange payload reused on every dispatch.
+        ofEvent<GuiEvent>* elementEvent = nullptr;  //!< The event of the element ID.
+        ofEventListener listener;                   //!< Listener bound to the element parameter.
+        AudioParameter* audioParameter = nullptr;   //!< Audio parameter fed by the element, if any.
+        GuiElementRef element;                      //!< The element.
+        size_t panel = GuiDirtyTracker::NoPanel;    //!< The panel marked dirty when it changes, NoPanel for dynamic toggles.
+        ofParameter<bool>* parameter = nullptr;     //!< The parameter of a toggle, key of toggleIdMap.
+        uint64_t minIntervalMillis = 0;             //!< Minimum time between coalesced notifications, 0 for once per frame.
+        uint64_t lastNotifyMillis = 0;              //!< When the last coalesced change was notified.
+        bool pending = false;                       //!< Whether a coalesced change waits in pendingBindings.
+        uint32_t stateIndex = UINT32_MAX;           //!< The entry of the element in the snapshot, UINT32_MAX for buttons.
+    };
+
+    /*!
+     *  @brief Handles the action triggered by a toggle.
+     *  @param binding The dispatch record of the toggle that changed.
+     *  @param checked The state of the toggle (true or false).
+     */
+    void onToggleAction(ElementBinding& binding, bool checked);
+
+    /*!
+     *  @brief Creates the dispatch record of an element and subscribes it to the element changes.
+     *  @param guiElement The element, one with a value.
+     *  @param id The identifier of the element.
+     *  @param action The action of the element, invalid if it has none.
+     *  @param audioParameter The audio parameter fed by the element, or nullptr.
+     *  @return The record, owned by bindings.
+     */
+    ElementBinding& bindElement(const GuiElementRef& guiElement, GuiId id, GuiId action = GuiId(), AudioParameter* audioParameter = nullptr);
+
+    /*!
+     *  @brief Binds the element of a model entry, with its action, audio parameter and rate. Elements without a value are skipped.
+     *  @param guiElement The element.
+     *  @param id The identifier of the element.
+     *  @param index The index of the element in the model.
+     */
+    void bindModelElement(const GuiElementRef& guiElement, GuiId id, size_t index);
+
+    /*!
+     *  @brief Handles a value change reported by the backend: toggles, buttons and dropdowns are
+     *         notified right away, sliders and fields are coalesced until the next flush.
+     *  @param binding The dispatch record of the element.
+     *  @param value The new value.
+     */
+    void onElementChanged(ElementBinding& binding, const GuiEvent::Value& value);
+
+    /*!
+     *  @brief Queues the change of a coalesced element for the next flush.
+     *  @param binding The dispatch record of the element.
+     */
+    void queueChange(ElementBinding& binding);
+
+    /*!
+     *  @brief Feeds the audio parameter, notifies the events and marks the panel dirty.
+     *  @param binding The dispatch record of the element, with its new value.
+     */
+    void notifyChange(ElementBinding& binding);
+
+    /*!
+     *  @brief Calls flushChanges(). Bound to the update event once a coalesced element exists.
+     */
+    void onUpdateFlush(ofEventArgs&);
+
+    /*!
+     *  @brief Coalesced elements with a change waiting to be notified.
+     */
+    std::vector<ElementBinding*> pendingBindings;
+
+    /*!
+     *  @brief The elements being notified by flushChanges(), kept to reuse its capacity.
+     */
+    std::vector<ElementBinding*> flushingBindings;
+
+    /*!
+     *  @brief Listener on the update event flushing coalesced changes.
+     */
+    ofEventListener flushListener;
+
+    /*!
+     *  @brief Whether flushListener is subscribed.
+     */
+    bool flushSubscribed = false;
+
+    /*!
+     *  @brief Declares the audio parameter of an element, if it has one.
+     *  @param index The index of the element in the model.
+     *  @return The audio parameter, or nullptr.
+     */
+    AudioParameter* declareAudioParameter(size_t index);
+
+    /*!
+     *  @brief Removes the dispatch record of an element, detaching its listener.
+     *  @param id The identifier of the element.
+     */
+    void unbindElement(GuiId id);
+
+    /*!
+     *  @brief Dispatch records of all bound elements by ID, owned here so their addresses stay stable.
+     */
+    std::unordered_map<GuiId, std::unique_ptr<ElementBinding>> bindings;
+
+    /*!
+     *  @struct DynamicToggle
+     *  @brief Entry of the dynamic toggle registry.
+     */
+    struct DynamicToggle {
+        GuiId id;                   //!< The generated ID.
+        GuiElementRef element;      //!< The toggle.
+        uint32_t layoutNode;        //!< The toggle in toggleLayout.
+    };
+
+    /*!
+     *  @brief Dynamically created toggles in insertion order.
+     */
+    std::list<DynamicToggle> dynamicToggles;
+
+    /*!
+     *  @brief Lookup from generated ID to registry entry.
+     */
+    std::unordered_map<GuiId, std::list<DynamicToggle>::iterator> dynamicToggleIds;
+
+    /*!
+     *  @brief Lookup from pool slot to registry entry, for removal by handle.
+     */
+    std::unordered_map<uint32_t, std::list<DynamicToggle>::iterator> dynamicToggleSlots;
+
+    /*!
+     *  @brief Counter making generated toggle IDs unique within this instance.
+     */
+    uint32_t dynamicToggleCount = 0;
+
+    /*!
+     *  @brief Layout of the panels with a "layout" or groups, rebuilt with the widgets.
+     */
+    GuiLayout layout;
+
+    /*!
+     *  @brief The element of each model entry, invalid for entries without one.
+     */
+    std::vector<GuiElementRef> modelElements;
+
+    /*!
+     *  @brief Column of the dynamic toggles, so adding or removing one only moves the toggles after it.
+     */
+    GuiLayout toggleLayout;
+
+    /*!
+     *  @brief The column group of toggleLayout, NoNode until the first toggle is added.
+     */
+    uint32_t toggleColumn = GuiLayout::NoNode;
+
+    /*!
+     *  @brief Builds the layout of the current model and resolves the layout nodes of the label slots.
+     */
+    void buildLayout();
+
+    /*!
+     *  @brief Relayouts the elements whose size changed and moves the affected widgets.
+     */
+    void applyLayout();
+
+    /*!
+     *  @brief Moves the dynamic toggles placed again by toggleLayout.
+     */
+    void applyToggleLayout();
+
+    /*!
+     *  @brief Detaches a dynamic toggle from the GUI and releases it.
+     *  @param entry The registry entry of the toggle.
+     */
+    void eraseDynamicToggle(std::list<DynamicToggle>::iterator entry);
+
+    /*!
+     *  @brief Returns the panel holding an element.
+     *  @param id The ID of the element.
+     *  @return The index of the panel, or GuiDirtyTracker::NoPanel for dynamic toggles and
+     *          elements of panels set up with setupPanel().
+     */
+    size_t panelOf(GuiId id) const;
+
+    /*!
+     *  @brief Records the panel holding an element, in the lookup and in its dispatch record.
+     *  @param id The ID of the element, ignored if invalid.
+     *  @param panel The index of the panel.
+     */
+    void setElementPanel(GuiId id, size_t panel);
+
+    /*!
+     *  @brief The panel holding each element ID, so a change marks its panel without a search.
+     */
+    std::unordered_map<GuiId, size_t> elementPanels;
+
+    /*!
+     *  @brief Tracks pointer interaction with panels. Bound to the mouse events in cached mode.
+     *  @param args The mouse event.
+     */
+    void onMouseEvent(ofMouseEventArgs& args);
+
+    /*!
+     *  @brief Whether draw() renders panels through their FBO caches.
+     */
+    bool cachedRendering = false;
+
+    /*!
+     *  @brief Which panels must be rendered again.
+     */
+    GuiDirtyTracker dirtyTracker;
+
+    /*!
+     *  @brief The panel under the pointer when a button was pressed, it follows drags outside its shape.
+     */
+    size_t pressedPanel = GuiDirtyTracker::NoPanel;
+
+    /*!
+     *  @brief Listeners on the mouse events while cached rendering is enabled.
+     */
+    ofEventListeners mouseListeners;
+
+    /*!
+     *  @brief Applies the 'profiler' block of the configuration. A block that is absent or disabled
+     *         leaves the profiling set by the application as it is.
+     */
+    void applyProfilerSettings();
+
+    /*!
+     *  @brief Ends the profiled frame. Bound to the update event while profiling.
+     */
+    void onUpdateProfile(ofEventArgs&);
+
+    /*!
+     *  @brief Timings and counters of the GUI work.
+     */
+    GuiProfiler profiler;
+
+    /*!
+     *  @brief Ends the profiled frames, subscribed while profiling.
+     */
+    ofEventListener profileListener;
+
+    /*!
+     *  @brief Whether draw() draws the profiler stats.
+     */
+    bool profilerOverlay = false;
+
+    /*!
+     *  @brief The left edge of the profiler overlay.
+     */
+    float profilerOverlayX = 10;
+
+    /*!
+     *  @brief The baseline of the first line of the profiler overlay.
+     */
+    float profilerOverlayY = 20;
+
+    /*!
+     *  @brief The Chrome trace written when the GUI is destroyed, from the configuration.
+     */
+    std::string traceFile;
+
+    /*!
+     *  @brief Returns the snapshot for a change, copying it first if it was handed out.
+     */
+    GuiSnapshot& editState();
+
+    /*!
+     *  @brief Adds the element of a new dispatch record to the snapshot, or reactivates its entry.
+     *  @param binding The dispatch record.
+     */
+    void trackState(ElementBinding& binding);
+
+    /*!
+     *  @brief Starts a background save if the values changed and the interval passed.
+     *         Bound to the update event while autosaving.
+     */
+    void onUpdateAutosave(ofEventArgs&);
+
+    /*!
+     *  @brief The values of all elements, replaced by a copy when changed while shared.
+     */
+    std::shared_ptr<GuiSnapshot> state = std::make_shared<GuiSnapshot>();
+
+    /*!
+     *  @brief The entry of each ID in the snapshot. Entries outlive their elements, so indices stay valid.
+     */
+    std::unordered_map<GuiId, uint32_t> stateLookup;
+
+    /*!
+     *  @brief Whether the values changed since the last autosave.
+     */
+    bool stateChanged = false;
+
+    /*!
+     *  @brief The full path of the autosave file, empty while autosave is disabled.
+     */
+    std::string autosavePath;
+
+    /*!
+     *  @brief Minimum time between autosaves.
+     */
+    uint64_t autosaveInterval = 500;
+
+    /*!
+     *  @brief When the last autosave started.
+     */
+    uint64_t lastAutosave = 0;
+
+    /*!
+     *  @brief Starts the autosaves, subscribed while autosaving.
+     */
+    ofEventListener autosaveListener;
+
+    /*!
+     *  @brief The autosave running on a background thread, at most one at a time.
+     */
+    std::future<bool> pendingSave;
+
+    /*!
+     *  @brief Applies a Set or answers a Get from a remote client.
+     *  @param message The message.
+     *  @param peer The client.
+     */
+    void handleRemoteMessage(const GuiRemoteMessage& message, const GuiRemotePeer& peer);
+
+    /*!
+     *  @brief Calls updateRemote(). Bound to the update event while remote control is enabled.
      */
-    ofxPanel gui;
+    void onUpdateRemote(ofEventArgs&);
 
     /*!
-     *  @brief A map linking element labels to their shared pointers.
+     *  @brief The remote control endpoint, null while remote control is disabled.
      */
-    std::map<std::string, std::shared_ptr<ofxBaseGui>> guiElementsMap;
+    std::unique_ptr<GuiRemoteEndpoint> remote;
 
     /*!
-     *  @brief Adds a GUI element to a panel based on the JSON configuration.
-     *  @param panel The panel to which the element is added.
-     *  @param elementConfig The JSON configuration for the GUI element.
+     *  @brief Serves the remote clients, subscribed while remote control is enabled.
      */
-    void addGuiElement(ofxPanel& panel, const json& elementConfig);
+    ofEventListener remoteListener;
 
 };
@@ -0,0 +1,28 @@
+#include "ofxGuiJsonAudioBridge.h"
+
+AudioParameter* AudioParameterBridge::declare(const std::string& name, float initialValue) {
+    auto it = lookup.find(name);
+    if (it != lookup.end()) {
+        return it->second;
+    }
+    parameters.push_back(std::make_unique<AudioParameter>());
+    AudioParameter* parameter = parameters.back().get();
+    parameter->reset(initialValue);
+    lookup[name] = parameter;
+    return parameter;
+}
+
+AudioParameter* AudioParameterBridge::find(const std::string& name) const {
+    auto it = lookup.find(name);
+    return it != lookup.end() ? it->second : nullptr;
+}
+
+void AudioParameterBridge::setSampleRate(float rate) {
+    if (rate == sampleRate) {
+        return;
+    }
+    sampleRate = rate;
+    for (const auto& parameter : parameters) {
+        parameter->setSampleRate(rate);  // Smoothing times are kept, only their length in samples changes
+    }
+}
@@ -0,0 +1,141 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonAudioBridge.h
+
+    @brief    This file defines the real-time safe bridge between GUI elements
+              on the main thread and parameters read from the audio callback.
+              Values are published through lock-free atomics, so the audio
+              thread never locks or allocates.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*!
+ *  @class AudioParameter
+ *  @brief A single value written by the main thread and read by the audio thread.
+ *
+ *  publish() is called from the main thread only. get() and next() are called from the
+ *  audio thread only; next() advances an optional one-pole smoother once per sample.
+ */
+class alignas(64) AudioParameter {
+public:
+    static_assert(std::atomic<float>::is_always_lock_free, "AudioParameter requires lock-free float atomics");
+
+    /*!
+     *  @brief Publishes a new value. Main thread only.
+     *  @param value The new value.
+     */
+    void publish(float value) { target.store(value, std::memory_order_relaxed); }
+
+    /*!
+     *  @brief Returns the last published value without smoothing. Wait-free, safe on the audio thread.
+     */
+    float get() const { return target.load(std::memory_order_relaxed); }
+
+    /*!
+     *  @brief Returns the smoothed value for the next sample. Audio thread only.
+     */
+    float next() {
+        float goal = target.load(std::memory_order_relaxed);
+        current += coefficient.load(std::memory_order_relaxed) * (goal - current);
+        return current;
+    }
+
+    /*!
+     *  @brief Sets the smoothing time of next(). Call before the audio stream starts or from the main thread.
+     *  @param millis Time constant of the smoother in milliseconds, 0 disables smoothing.
+     *  @param sampleRate The sample rate of the audio stream.
+     */
+    void setSmoothing(float millis, float sampleRate) {
+        smoothingMillis = millis;
+        setSampleRate(sampleRate);
+    }
+
+    /*!
+     *  @brief Recomputes the smoothing coefficient for a new sample rate, keeping the smoothing time.
+     *         Call from the main thread when the audio stream is set up again.
+     *  @param sampleRate The sample rate of the audio stream.
+     */
+    void setSampleRate(float sampleRate) {
+        float samples = smoothingMillis * 0.001f * sampleRate;
+        coefficient.store(samples > 1.f ? 1.f - std::exp(-1.f / samples) : 1.f, std::memory_order_relaxed);
+    }
+
+    /*!
+     *  @brief Returns the smoothing coefficient applied by next() on each sample.
+     */
+    float getCoefficient() const { return coefficient.load(std::memory_order_relaxed); }
+
+    /*!
+     *  @brief Sets the published and smoothed value at once. Call before the audio stream starts.
+     *  @param value The initial value.
+     */
+    void reset(float value) {
+        target.store(value, std::memory_order_relaxed);
+        current = value;
+    }
+
+private:
+    std::atomic<float> target{ 0.f };       //!< The last published value.
+    std::atomic<float> coefficient{ 1.f };  //!< The smoothing coefficient per sample.
+    float current = 0.f;                    //!< The smoothed value, owned by the audio thread.
+    float smoothingMillis = 0.f;            //!< The smoothing time, main thread only.
+};
+
+/*!
+ *  @class AudioParameterBridge
+ *  @brief Owns the audio parameters declared by the configuration or by the application.
+ *
+ *  Parameters are created on the main thread and never destroyed while the bridge lives,
+ *  so pointers handed to the audio thread stay valid across config reloads.
+ */
+class AudioParameterBridge {
+public:
+    /*!
+     *  @brief Returns the parameter with a name, creating it if needed. Main thread only.
+     *  @param name The name of the parameter.
+     *  @param initialValue The value of a newly created parameter.
+     *  @return The parameter.
+     */
+    AudioParameter* declare(const std::string& name, float initialValue = 0.f);
+
+    /*!
+     *  @brief Finds a parameter. Resolve once on the main thread and hand the pointer to the audio thread.
+     *  @param name The name of the parameter.
+     *  @return The parameter, or nullptr if it was never declared.
+     */
+    AudioParameter* find(const std::string& name) const;
+
+    /*!
+     *  @brief Sets the sample rate used to compute smoothing coefficients, and recomputes the
+     *         coefficients of the declared parameters if it changed. Main thread only.
+     *  @param rate The sample rate of the audio stream.
+     */
+    void setSampleRate(float rate);
+
+    /*!
+     *  @brief Returns the sample rate used to compute smoothing coefficients.
+     */
+    float getSampleRate() const { return sampleRate; }
+
+private:
+    std::vector<std::unique_ptr<AudioParameter>> parameters;    //!< The parameters, stable in memory.
+    std::map<std::string, AudioParameter*> lookup;              //!< Lookup from name to parameter.
+    float sampleRate = 44100.f;                                 //!< Sample rate for smoothing.
+};
@@ -0,0 +1,273 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonBackend.h
+
+    @brief    This file defines GuiBackend, the interface through which ofxGuiJson
+              creates, updates and draws the elements of the model. The ofxGui
+              widgets are one implementation, an in-memory headless one is another.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxGuiJsonModel.h"
+#include "ofxGuiJsonPool.h"
+#include "ofxGuiJsonDirtyTracker.h"
+#include "ofxGuiJsonEvent.h"
+#include <array>
+#include <cmath>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+class ofxBaseGui;
+
+/*!
+ *  @struct GuiElementRef
+ *  @brief Reference to an element created by a GuiBackend.
+ */
+struct GuiElementRef {
+    GuiElementType type = GuiElementType::Unknown;  //!< The element type.
+    WidgetHandle handle;                            //!< The handle of the element in its backend.
+
+    /*!
+     *  @brief Returns true if the reference was returned by a backend.
+     */
+    bool isValid() const { return handle.isValid(); }
+
+    bool operator==(const GuiElementRef& other) const {
+        return type == other.type && handle.index == other.handle.index && handle.generation == other.handle.generation;
+    }
+    bool operator!=(const GuiElementRef& other) const { return !(*this == other); }
+    bool operator<(const GuiElementRef& other) const {
+        return std::tie(type, handle.index, handle.generation) < std::tie(other.type, other.handle.index, other.handle.generation);
+    }
+};
+
+/*!
+ *  @brief Number of elements of each GuiElementType.
+ */
+using GuiTypeCounts = std::array<size_t, GuiElementTypeCount>;
+
+/*!
+ *  @brief Returns true if elements of a type hold a value and report its changes.
+ *  @param type The element type.
+ */
+inline bool hasElementValue(GuiElementType type) {
+    return type != GuiElementType::Unknown && type != GuiElementType::Label && type != GuiElementType::VirtualList;
+}
+
+/*!
+ *  @brief Returns the type of the events reported by elements of a type.
+ *  @param type The element type, one for which hasElementValue() is true.
+ */
+inline GuiEventType toEventType(GuiElementType type) {
+    switch (type) {
+    case GuiElementType::Slider:
+    case GuiElementType::FloatField:
+        return GuiEventType::Float;
+    case GuiElementType::IntSlider:
+    case GuiElementType::IntField:
+        return GuiEventType::Int;
+    case GuiElementType::Button:
+        return GuiEventType::Trigger;
+    case GuiElementType::Dropdown:
+        return GuiEventType::Choice;
+    default:
+        return GuiEventType::Toggle;
+    }
+}
+
+/*!
+ *  @brief Converts a number to the value of an element: non-zero for toggles, rounded for integers and options.
+ *  @param type The element type.
+ *  @param number The number.
+ */
+inline GuiEvent::Value toElementValue(GuiElementType type, float number) {
+    GuiEvent::Value value = {};
+    switch (toEventType(type)) {
+    case GuiEventType::Toggle:
+        value.toggle = number != 0;
+        break;
+    case GuiEventType::Float:
+        value.number = number;
+        break;
+    default:
+        value.integer = static_cast<int32_t>(std::lround(number));
+        break;
+    }
+    return value;
+}
+
+/*!
+ *  @class GuiBackend
+ *  @brief Creates and owns the elements and panels ofxGuiJson builds from its model.
+ *
+ *  ofxGuiJson keeps the model, the IDs, the bindings and the events, and only calls the backend
+ *  to change what is shown. A backend reports value changes through the listeners of listen().
+ *  Main thread only.
+ */
+class GuiBackend {
+public:
+    virtual ~GuiBackend() {}
+
+    /*!
+     *  @brief Sets the number of panels. Added panels are empty until setupPanel(), removed panels are detached.
+     *  @param count The number of panels.
+     */
+    virtual void setPanelCount(size_t count) = 0;
+
+    /*!
+     *  @brief Returns the number of panels.
+     */
+    virtual size_t getPanelCount() const = 0;
+
+    /*!
+     *  @brief Sets the title, size and position of a panel.
+     *  @param panel The index of the panel.
+     *  @param panelModel The compiled model of the panel.
+     */
+    virtual void setupPanel(size_t panel, const GuiPanelModel& panelModel) = 0;
+
+    /*!
+     *  @brief Applies the title, size and position of a panel that changed on reload.
+     *  @param panel The index of the panel.
+     *  @param previous The model the panel was set up from.
+     *  @param next The new model of the panel.
+     */
+    virtual void updatePanel(size_t panel, const GuiPanelModel& previous, const GuiPanelModel& next) = 0;
+
+    /*!
+     *  @brief Replaces the elements shown by a panel. The elements are not destroyed.
+     *  @param panel The index of the panel.
+     *  @param elements The elements, in display order.
+     */
+    virtual void setPanelElements(size_t panel, const std::vector<GuiElementRef>& elements) = 0;
+
+    /*!
+     *  @brief Returns the topmost panel containing a point.
+     *  @param x The horizontal position.
+     *  @param y The vertical position.
+     *  @return The index of the panel, or GuiDirtyTracker::NoPanel.
+     */
+    virtual size_t findPanelAt(float x, float y) const = 0;
+
+    /*!
+     *  @brief Draws all panels.
+     *  @param dirtyTracker The panels changed since they were last rendered. Rendered panels are marked clean.
+     *  @param cached True to render only dirty panels and draw the others from a cache.
+     */
+    virtual void draw(GuiDirtyTracker& dirtyTracker, bool cached) = 0;
+
+    /*!
+     *  @brief Makes room for a number of elements of each type.
+     *  @param counts The number of elements of each type.
+     */
+    virtual void reserve(const GuiTypeCounts& counts) = 0;
+
+    /*!
+     *  @brief Creates the element of a model entry, not attached to a panel.
+     *  @param model The compiled model.
+     *  @param index The index of the element in the model.
+     *  @param rect The position and size of the element, defaults resolved.
+     *  @return The element, invalid for types the backend does not support.
+     */
+    virtual GuiElementRef createElement(const GuiModel& model, size_t index, const ofRectangle& rect) = 0;
+
+    /*!
+     *  @brief Creates a toggle that is not part of the model, not attached to a panel.
+     *  @param label The label of the toggle.
+     *  @param state The initial state.
+     *  @param rect The position and size of the toggle.
+     */
+    virtual GuiElementRef createToggle(const std::string& label, bool state, const ofRectangle& rect) = 0;
+
+    /*!
+     *  @brief Destroys an element. Stale references are ignored.
+     *  @param element The element.
+     */
+    virtual void destroyElement(const GuiElementRef& element) = 0;
+
+    /*!
+     *  @brief Destroys all panels and elements at once.
+     */
+    virtual void clear() = 0;
+
+    /*!
+     *  @brief Sets the text shown by an element.
+     *  @param element The element.
+     *  @param text The text.
+     */
+    virtual void setLabel(const GuiElementRef& element, const std::string& text) = 0;
+
+    /*!
+     *  @brief Returns the text shown by an element, empty for stale references.
+     *  @param element The element.
+     */
+    virtual std::string getLabel(const GuiElementRef& element) const = 0;
+
+    /*!
+     *  @brief Moves and resizes an element.
+     *  @param element The element.
+     *  @param rect The new position and size.
+     */
+    virtual void setRect(const GuiElementRef& element, const ofRectangle& rect) = 0;
+
+    /*!
+     *  @brief Subscribes to the value changes of an element, whether made by the user or by setValue().
+     *  @param element The element.
+     *  @param callback Called with the new value, typed as the GuiEvent of the element type.
+     *  @return The subscription, empty for elements without a value.
+     */
+    virtual ofEventListener listen(const GuiElementRef& element, std::function<void(const GuiEvent::Value&)> callback) = 0;
+
+    /*!
+     *  @brief Returns the value of an element.
+     *  @param element The element.
+     */
+    virtual GuiEvent::Value getValue(const GuiElementRef& element) const = 0;
+
+    /*!
+     *  @brief Sets the value of an element as if the user changed it, notifying its listeners.
+     *         A button is clicked whatever the value.
+     *  @param element The element.
+     *  @param value The new value, typed as the GuiEvent of the element type.
+     *  @return False for stale references and elements without a value.
+     */
+    virtual bool setValue(const GuiElementRef& element, const GuiEvent::Value& value) = 0;
+
+    /*!
+     *  @brief Appends an element to the main panel holding the dynamic toggles.
+     *  @param element The element.
+     */
+    virtual void addToMainPanel(const GuiElementRef& element) = 0;
+
+    /*!
+     *  @brief Detaches an element from the main panel. The other elements stay where they are,
+     *         they are moved with setRect().
+     *  @param element The element.
+     */
+    virtual void removeFromMainPanel(const GuiElementRef& element) = 0;
+
+    /*!
+     *  @brief Detaches every element from the main panel.
+     */
+    virtual void clearMainPanel() = 0;
+
+    /*!
+     *  @brief Returns the ofxGui widget of an element.
+     *  @param element The element.
+     *  @return The widget, or nullptr for backends without widgets.
+     */
+    virtual ofxBaseGui* getWidget(const GuiElementRef& /*element*/) const { return nullptr; }
+};
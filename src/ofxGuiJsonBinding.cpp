@@ -0,0 +1,267 @@
+#include "ofxGuiJsonBinding.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// Longest rendered value: a fixed double of 309 digits with MaxPrecision decimals and a sign
+static constexpr size_t ScratchSize = 352;
+
+// Precisions above this add no information to a double
+static constexpr int MaxPrecision = 17;
+
+uint32_t GuiValueRegistry::add(const std::string& name, const float* value) {
+    return store(name, { GuiValueType::Float, value, nullptr });
+}
+
+uint32_t GuiValueRegistry::add(const std::string& name, const double* value) {
+    return store(name, { GuiValueType::Double, value, nullptr });
+}
+
+uint32_t GuiValueRegistry::add(const std::string& name, const int* value) {
+    return store(name, { GuiValueType::Int, value, nullptr });
+}
+
+uint32_t GuiValueRegistry::add(const std::string& name, const bool* value) {
+    return store(name, { GuiValueType::Bool, value, nullptr });
+}
+
+uint32_t GuiValueRegistry::add(const std::string& name, std::function<double()> getter) {
+    return store(name, { GuiValueType::Getter, nullptr, std::move(getter) });
+}
+
+uint32_t GuiValueRegistry::store(const std::string& name, Value value) {
+    if ((value.type == GuiValueType::Getter && !value.getter) || (value.type != GuiValueType::Getter && !value.pointer)) {
+        ofLogWarning() << "Registering value '" << name << "' without a variable, labels bound to it keep their text.";
+        value = Value();
+    }
+    auto found = lookup.find(name);
+    if (found != lookup.end()) {
+        values[found->second] = std::move(value);
+        return found->second;
+    }
+    uint32_t index = static_cast<uint32_t>(values.size());
+    values.push_back(std::move(value));
+    lookup.emplace(name, index);
+    return index;
+}
+
+bool GuiValueRegistry::remove(const std::string& name) {
+    auto found = lookup.find(name);
+    if (found == lookup.end() || values[found->second].type == GuiValueType::None) {
+        return false;
+    }
+    values[found->second] = Value();
+    return true;
+}
+
+uint32_t GuiValueRegistry::find(const std::string& name) const {
+    auto found = lookup.find(name);
+    return found != lookup.end() ? found->second : NoValue;
+}
+
+GuiValueSample GuiValueRegistry::sample(uint32_t index) const {
+    GuiValueSample sample;
+    if (index >= values.size()) {
+        return sample;
+    }
+    const Value& value = values[index];
+    sample.type = value.type;
+    switch (value.type) {
+    case GuiValueType::Float:
+        sample.value = *static_cast<const float*>(value.pointer);
+        break;
+    case GuiValueType::Double:
+        sample.value = *static_cast<const double*>(value.pointer);
+        break;
+    case GuiValueType::Int:
+        sample.value = *static_cast<const int*>(value.pointer);
+        break;
+    case GuiValueType::Bool:
+        sample.value = *static_cast<const bool*>(value.pointer) ? 1 : 0;
+        break;
+    case GuiValueType::Getter:
+        sample.value = value.getter();
+        break;
+    default:
+        break;
+    }
+    return sample;
+}
+
+void GuiValueRegistry::clear() {
+    values.clear();
+    lookup.clear();
+}
+
+bool GuiLabelFormat::compile(const std::string& format, size_t valueCount, std::string& error) {
+    text.clear();
+    segments.clear();
+    if (format.empty()) {
+        std::string spaced;
+        for (size_t v = 0; v < valueCount; v++) {
+            spaced += v == 0 ? "{}" : " {}";
+        }
+        return spaced.empty() || compile(spaced, valueCount, error);
+    }
+
+    auto appendLiteral = [this](char c) {
+        if (segments.empty() || segments.back().length == 0) {
+            Segment literal;
+            literal.start = static_cast<uint32_t>(text.size());
+            segments.push_back(literal);
+        }
+        text += c;
+        segments.back().length++;
+    };
+
+    uint32_t nextValue = 0;
+    for (size_t i = 0; i < format.size(); i++) {
+        char c = format[i];
+        if (c == '}') {
+            if (i + 1 < format.size() && format[i + 1] == '}') {
+                appendLiteral('}');
+                i++;
+                continue;
+            }
+            error = "unmatched '}' at " + ofToString(i) + ", write '}}' for a brace";
+            return false;
+        }
+        if (c != '{') {
+            appendLiteral(c);
+            continue;
+        }
+        if (i + 1 < format.size() && format[i + 1] == '{') {
+            appendLiteral('{');
+            i++;
+            continue;
+        }
+
+        size_t close = format.find('}', i);
+        if (close == std::string::npos) {
+            error = "unterminated '{' at " + ofToString(i);
+            return false;
+        }
+        std::string field = format.substr(i + 1, close - i - 1);
+        std::string index = field.substr(0, field.find(':'));
+        std::string spec = index.size() < field.size() ? field.substr(index.size() + 1) : std::string();
+
+        Segment placeholder;
+        if (index.empty()) {
+            placeholder.value = nextValue++;
+        }
+        else if (std::all_of(index.begin(), index.end(), [](char d) { return d >= '0' && d <= '9'; }) && index.size() < 6) {
+            placeholder.value = static_cast<uint32_t>(std::stoul(index));
+        }
+        else {
+            error = "invalid value index '" + index + "' in '{" + field + "}'";
+            return false;
+        }
+
+        size_t s = 0;
+        if (s < spec.size() && spec[s] == '.') {
+            size_t digits = ++s;
+            while (s < spec.size() && spec[s] >= '0' && spec[s] <= '9') {
+                s++;
+            }
+            if (s == digits || s - digits > 2) {
+                error = "invalid precision in '{" + field + "}'";
+                return false;
+            }
+            placeholder.precision = std::min(std::stoi(spec.substr(digits, s - digits)), MaxPrecision);
+        }
+        if (s < spec.size() && std::strchr("fegd", spec[s])) {
+            placeholder.presentation = spec[s++];
+        }
+        if (s != spec.size()) {
+            error = "unsupported format '{" + field + "}', expected {}, {:.Nf}, {:.Ne}, {:.Ng} or {:d}";
+            return false;
+        }
+        if (placeholder.presentation == 'd' && placeholder.precision >= 0) {
+            error = "'{" + field + "}' has a precision, which integers do not take";
+            return false;
+        }
+        if (placeholder.value >= valueCount) {
+            error = "'{" + field + "}' uses value " + ofToString(placeholder.value) + " but " +
+                ofToString(valueCount) + (valueCount == 1 ? " is bound" : " are bound");
+            return false;
+        }
+        segments.push_back(placeholder);
+        i = close;
+    }
+    return true;
+}
+
+size_t GuiLabelFormat::render(const GuiValueSample* samples, char* out, size_t capacity) const {
+    char* cursor = out;
+    char* last = out + capacity - 1;  // Room for the terminator
+    for (const Segment& segment : segments) {
+        if (cursor == last) {
+            break;
+        }
+        if (segment.length > 0) {
+            size_t length = std::min(static_cast<size_t>(segment.length), static_cast<size_t>(last - cursor));
+            std::memcpy(cursor, text.data() + segment.start, length);
+            cursor += length;
+            continue;
+        }
+        cursor = renderValue(segment, samples[segment.value], cursor, last);
+    }
+    *cursor = '\0';
+    return static_cast<size_t>(cursor - out);
+}
+
+char* GuiLabelFormat::renderValue(const Segment& segment, const GuiValueSample& sample, char* first, char* last) {
+    GuiValueType type = sample.type;
+    double value = sample.value;
+    char scratch[ScratchSize];
+    char* end = scratch;
+    char presentation = segment.presentation;
+    if (presentation == 0 && segment.precision >= 0) {
+        presentation = 'g';  // "{:.3}" is general notation, as in std::format
+    }
+
+    if (presentation == 'd' || (presentation == 0 && type == GuiValueType::Int)) {
+        if (std::isfinite(value)) {
+            double clamped = std::max(std::min(std::round(value), 9.2e18), -9.2e18);
+            end = std::to_chars(scratch, scratch + ScratchSize, static_cast<long long>(clamped)).ptr;
+        }
+        else {
+            end = std::to_chars(scratch, scratch + ScratchSize, 0).ptr;
+        }
+    }
+    else if (presentation == 0 && type == GuiValueType::Bool) {
+        const char* word = value != 0 ? "true" : "false";
+        end = scratch + std::strlen(word);
+        std::memcpy(scratch, word, end - scratch);
+    }
+    else {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        std::chars_format chars = presentation == 'f' ? std::chars_format::fixed :
+            presentation == 'e' ? std::chars_format::scientific : std::chars_format::general;
+        std::to_chars_result result;
+        if (presentation == 0 && type == GuiValueType::Float) {
+            result = std::to_chars(scratch, scratch + ScratchSize, static_cast<float>(value));
+        }
+        else if (presentation == 0) {
+            result = std::to_chars(scratch, scratch + ScratchSize, value);
+        }
+        else {
+            result = std::to_chars(scratch, scratch + ScratchSize, value, chars, segment.precision >= 0 ? segment.precision : 6);
+        }
+        end = result.ec == std::errc() ? result.ptr : scratch;
+#else
+        // Standard libraries without floating point to_chars: snprintf, which does not allocate either
+        char printfFormat[] = "%.*g";
+        printfFormat[3] = presentation != 0 ? presentation : 'g';
+        int precision = segment.precision >= 0 ? segment.precision : 6;
+        int written = std::snprintf(scratch, ScratchSize, printfFormat, precision, value);
+        end = scratch + std::max(0, std::min(written, static_cast<int>(ScratchSize) - 1));
+#endif
+    }
+
+    size_t length = std::min(static_cast<size_t>(end - scratch), static_cast<size_t>(last - first));
+    std::memcpy(first, scratch, length);
+    return first + length;
+}
@@ -0,0 +1,180 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonBinding.h
+
+    @brief    This file defines the pieces of label data binding: the registry
+              of application values that labels declared with "bind" read, and
+              the compiled "format" that renders them into a fixed buffer
+              without allocating.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include "ofMain.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*!
+ *  @enum GuiValueType
+ *  @brief The type of a registered value, which sets how "{}" renders it.
+ */
+enum class GuiValueType : uint8_t {
+    None,       //!< Unregistered, labels reading it keep their text.
+    Float,      //!< const float*, shortest text that reads back the same float.
+    Double,     //!< const double*, shortest text that reads back the same double.
+    Int,        //!< const int*.
+    Bool,       //!< const bool*, "true" or "false".
+    Getter      //!< std::function<double()>, rendered as a double.
+};
+
+/*!
+ *  @struct GuiValueSample
+ *  @brief A value read from the registry, with the type that sets how it renders.
+ */
+struct GuiValueSample {
+    GuiValueType type = GuiValueType::None;     //!< The type of the value, None before the first read.
+    double value = 0;                           //!< The value.
+
+    bool operator==(const GuiValueSample& other) const { return type == other.type && value == other.value; }
+    bool operator!=(const GuiValueSample& other) const { return !(*this == other); }
+};
+
+/*!
+ *  @class GuiValueRegistry
+ *  @brief Application values by name. A name keeps its index for the life of the registry, so
+ *         labels resolve it once and sample it without a lookup.
+ *
+ *  Values are read on the main thread. A value written by another thread should be copied into
+ *  a main thread variable, or registered as a getter that reads it safely.
+ */
+class GuiValueRegistry {
+public:
+    /*!
+     *  @brief Index used for names that are not registered.
+     */
+    static constexpr uint32_t NoValue = UINT32_MAX;
+
+    /*!
+     *  @brief Registers a value, replacing any value with the same name.
+     *  @param name The name used by "bind", e.g. "audio.frequency".
+     *  @param value The value, which must outlive its registration.
+     *  @return The index of the name.
+     */
+    uint32_t add(const std::string& name, const float* value);
+    uint32_t add(const std::string& name, const double* value);
+    uint32_t add(const std::string& name, const int* value);
+    uint32_t add(const std::string& name, const bool* value);
+    uint32_t add(const std::string& name, std::function<double()> getter);
+
+    /*!
+     *  @brief Unregisters a value. Its index stays reserved for the name.
+     *  @param name The name.
+     *  @return True if the name was registered.
+     */
+    bool remove(const std::string& name);
+
+    /*!
+     *  @brief Returns the index of a name.
+     *  @param name The name.
+     *  @return The index, or NoValue if the name was never registered.
+     */
+    uint32_t find(const std::string& name) const;
+
+    /*!
+     *  @brief Reads a value.
+     *  @param index The index of the value.
+     *  @return The value, of type None if it is not registered.
+     */
+    GuiValueSample sample(uint32_t index) const;
+
+    /*!
+     *  @brief Removes every value and name.
+     */
+    void clear();
+
+private:
+    /*!
+     *  @struct Value
+     *  @brief A registered value.
+     */
+    struct Value {
+        GuiValueType type = GuiValueType::None;     //!< The type of the value.
+        const void* pointer = nullptr;              //!< The variable, for every type but Getter.
+        std::function<double()> getter;             //!< The getter of a Getter value.
+    };
+
+    /*!
+     *  @brief Stores a value under a name, reusing the index of the name.
+     */
+    uint32_t store(const std::string& name, Value value);
+
+    std::vector<Value> values;                              //!< Values by index.
+    std::unordered_map<std::string, uint32_t> lookup;       //!< Index of each name.
+};
+
+/*!
+ *  @class GuiLabelFormat
+ *  @brief A "format" string compiled into literal runs and placeholders, in the syntax of
+ *         std::format:
+ *
+ *  - "{}" renders the next value by its type, "{1}" the value at an index of "bind".
+ *  - "{:.2f}" fixed, "{:.3e}" scientific and "{:.4g}" general notation, with an optional precision.
+ *  - "{:d}" the value rounded to an integer.
+ *  - "{{" and "}}" are literal braces.
+ *
+ *  Rendering uses std::to_chars into the caller's buffer and never allocates.
+ */
+class GuiLabelFormat {
+public:
+    /*!
+     *  @brief Compiles a format string.
+     *  @param format The format, empty for "{}" per value separated by spaces.
+     *  @param valueCount The number of values bound to the label.
+     *  @param error Set to what is wrong when the format is invalid.
+     *  @return False if the format is invalid or uses a value that is not bound.
+     */
+    bool compile(const std::string& format, size_t valueCount, std::string& error);
+
+    /*!
+     *  @brief Renders the values into a buffer, truncating at its end.
+     *  @param samples The bound values, in the order of "bind".
+     *  @param out The buffer, always terminated.
+     *  @param capacity The size of the buffer, at least 1.
+     *  @return The length of the text.
+     */
+    size_t render(const GuiValueSample* samples, char* out, size_t capacity) const;
+
+private:
+    /*!
+     *  @struct Segment
+     *  @brief A literal run of the format text or a placeholder.
+     */
+    struct Segment {
+        uint32_t start = 0;             //!< First character of a literal run in text.
+        uint32_t length = 0;            //!< Length of a literal run, 0 for placeholders.
+        uint32_t value = 0;             //!< Index of the bound value of a placeholder.
+        int precision = -1;             //!< Precision of a placeholder, -1 for none.
+        char presentation = 0;          //!< 'f', 'e', 'g', 'd', or 0 for the default of the type.
+    };
+
+    /*!
+     *  @brief Renders one value into [first, last).
+     *  @return The end of the written text.
+     */
+    static char* renderValue(const Segment& segment, const GuiValueSample& sample, char* first, char* last);
+
+    std::string text;                   //!< The literal characters of the format, braces unescaped.
+    std::vector<Segment> segments;      //!< The format in order.
+};
@@ -0,0 +1,441 @@
+#include "ofxGuiJsonCompose.h"
+#include "ofxGuiJsonLoader.h"
+#include "ofxGuiJsonModel.h"
+#include <algorithm>
+#include <filesystem>
+#include <string_view>
+
+namespace {
+    const char* const IncludeKey = "$include";
+    const char* const TemplateKey = "$template";
+    const char* const TemplatesKey = "$templates";
+    const char* const RepeatKey = "repeat";
+
+    std::string childPointer(const std::string& pointer, const std::string& token) {
+        std::string child = pointer + '/';
+        for (char c : token) {
+            if (c == '~') child += "~0";
+            else if (c == '/') child += "~1";
+            else child += c;
+        }
+        return child;
+    }
+
+    std::string childPointer(const std::string& pointer, size_t index) {
+        return pointer + '/' + std::to_string(index);
+    }
+
+    bool isReference(const json& value) {
+        return value.is_object() && (value.contains(IncludeKey) || value.contains(TemplateKey));
+    }
+
+    // True if the quoted name is followed by a colon, i.e. is an object key. Quotes escaped inside
+    // strings are skipped; text that only looks like a key costs the DOM path, nothing else.
+    bool containsKey(std::string_view text, std::string_view name) {
+        for (size_t at = text.find(name); at != std::string_view::npos; at = text.find(name, at + 1)) {
+            size_t end = at + name.size();
+            if (at == 0 || text[at - 1] != '"' || (at > 1 && text[at - 2] == '\\') || end >= text.size() || text[end] != '"') {
+                continue;
+            }
+            size_t next = text.find_first_not_of(" \t\r\n", end + 1);
+            if (next != std::string_view::npos && text[next] == ':') {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+const json* GuiIncludeCache::find(const std::string& path, uint64_t hash) const {
+    auto found = entries.find(path);
+    return found != entries.end() && found->second.hash == hash ? &found->second.document : nullptr;
+}
+
+const json& GuiIncludeCache::store(const std::string& path, uint64_t hash, json document) {
+    Entry& entry = entries[path];
+    entry.hash = hash;
+    entry.document = std::move(document);
+    return entry.document;
+}
+
+GuiConfigComposer::GuiConfigComposer(const std::string& path, GuiIncludeCache* includeCache)
+    : rootPath(path), cache(includeCache ? includeCache : &localCache) {
+}
+
+bool GuiConfigComposer::usesComposition(const char* text, size_t length) {
+    std::string_view view(text, length);
+    return containsKey(view, IncludeKey) || containsKey(view, TemplateKey) || containsKey(view, TemplatesKey) ||
+        containsKey(view, RepeatKey);
+}
+
+bool GuiConfigComposer::expand(const json& source, json& expanded) {
+    templates.clear();
+    dependencies.clear();
+    parsedIncludes = 0;
+    repeatCopies = 0;
+    fileStack.assign(1, rootPath);
+    expanded = json();
+    bool ok = expandValue(source, expanded, json::object(), "", 0);
+    return checkResolved(expanded, "") && ok;
+}
+
+void GuiConfigComposer::error(const std::string& pointer, const std::string& message) {
+    ofLogError() << fileStack.back() << "#" << pointer << ": " << message;
+}
+
+bool GuiConfigComposer::expandValue(const json& value, json& out, const json& scope, const std::string& pointer, int depth) {
+    if (value.is_array()) {
+        out = json::array();
+        bool ok = true;
+        for (size_t i = 0; i < value.size(); i++) {
+            ok &= expandItem(value[i], out, scope, childPointer(pointer, i), depth);
+        }
+        return ok;
+    }
+    if (!value.is_object()) {
+        out = value;
+        return true;
+    }
+    if (isReference(value)) {
+        return expandReference(value, out, false, scope, pointer, depth);
+    }
+
+    // Templates first, so the other keys of the object can use them
+    bool ok = true;
+    auto definitions = value.find(TemplatesKey);
+    if (definitions != value.end()) {
+        ok &= defineTemplates(*definitions, childPointer(pointer, TemplatesKey), depth);
+    }
+    out = json::object();
+    for (auto it = value.begin(); it != value.end(); ++it) {
+        if (it.key() != TemplatesKey) {
+            ok &= expandValue(it.value(), out[it.key()], scope, childPointer(pointer, it.key()), depth);
+        }
+    }
+    return ok;
+}
+
+bool GuiConfigComposer::expandItem(const json& item, json& out, const json& scope, const std::string& pointer, int depth) {
+    if (item.is_object() && item.contains(RepeatKey)) {
+        return expandRepeat(item, out, scope, pointer, depth);
+    }
+    if (isReference(item)) {
+        return expandReference(item, out, true, scope, pointer, depth);
+    }
+    out.push_back(json());
+    return expandValue(item, out.back(), scope, pointer, depth);
+}
+
+bool GuiConfigComposer::expandReference(const json& object, json& out, bool splice, const json& scope, const std::string& pointer, int depth) {
+    if (depth >= MaxDepth) {
+        error(pointer, "includes and templates nested deeper than " + std::to_string(MaxDepth) + " levels");
+        return false;
+    }
+
+    json body;
+    json params = scope;
+    json overrides = json::object();
+    std::string path;
+    const json& includeName = readJsonChild(object, IncludeKey);
+    if (object.contains(IncludeKey)) {
+        if (!includeName.is_string()) {
+            error(childPointer(pointer, IncludeKey), "expected the path of a file");
+            return false;
+        }
+        const json* included = include(includeName.get<std::string>(), childPointer(pointer, IncludeKey), path);
+        if (!included) {
+            return false;
+        }
+        body = *included;
+        for (auto it = object.begin(); it != object.end(); ++it) {
+            if (it.key() != IncludeKey) {
+                overrides[it.key()] = it.value();
+            }
+        }
+    }
+    else {
+        const json& name = readJsonChild(object, TemplateKey);
+        auto found = name.is_string() ? templates.find(name.get<std::string>()) : templates.end();
+        if (found == templates.end()) {
+            error(childPointer(pointer, TemplateKey), "unknown template " + name.dump());
+            return false;
+        }
+        body = found->second;
+        for (auto it = object.begin(); it != object.end(); ++it) {
+            if (it.key() != TemplateKey) {
+                params[it.key()] = it.value();
+            }
+        }
+    }
+    substitute(body, params);
+
+    // The replacement is expanded in its own file, so its includes and errors are relative to it
+    bool ok = true;
+    std::string bodyPointer = path.empty() ? pointer : "";
+    if (!path.empty()) {
+        fileStack.push_back(path);
+    }
+    json result;
+    if (splice && body.is_array()) {
+        for (size_t i = 0; i < body.size(); i++) {
+            ok &= expandItem(body[i], out, params, childPointer(bodyPointer, i), depth + 1);
+        }
+    }
+    else {
+        ok &= expandValue(body, result, params, bodyPointer, depth + 1);
+    }
+    if (!path.empty()) {
+        fileStack.pop_back();
+    }
+    if (splice && body.is_array()) {
+        if (!overrides.empty()) {
+            error(pointer, "keys next to \"$include\" need an included object, not an array");
+            ok = false;
+        }
+        return ok;
+    }
+
+    if (!overrides.empty()) {
+        if (!result.is_object()) {
+            error(pointer, "keys next to \"$include\" need an included object");
+            return false;
+        }
+        for (auto it = overrides.begin(); it != overrides.end(); ++it) {
+            ok &= expandValue(it.value(), result[it.key()], scope, childPointer(pointer, it.key()), depth);
+        }
+    }
+    if (splice) {
+        out.push_back(std::move(result));
+    }
+    else {
+        out = std::move(result);
+    }
+    return ok;
+}
+
+bool GuiConfigComposer::expandRepeat(const json& item, json& out, const json& scope, const std::string& pointer, int depth) {
+    static const char* const keys[] = { "count", "start", "as", "id_pattern", "layout" };
+    const json& repeat = item[RepeatKey];
+    std::string repeatPointer = childPointer(pointer, RepeatKey);
+    if (!repeat.is_object()) {
+        error(repeatPointer, "expected an object with a \"count\"");
+        return false;
+    }
+    bool ok = true;
+    for (auto it = repeat.begin(); it != repeat.end(); ++it) {
+        if (std::find(std::begin(keys), std::end(keys), it.key()) == std::end(keys)) {
+            error(childPointer(repeatPointer, it.key()), "unknown key '" + it.key() + "'");
+            ok = false;
+        }
+    }
+    const json& countValue = readJsonChild(repeat, "count");
+    if (!countValue.is_number_integer() || countValue.get<int64_t>() < 0) {
+        error(childPointer(repeatPointer, "count"), "expected an integer of 0 or more");
+        return false;
+    }
+    int64_t count = countValue.get<int64_t>();
+    if (count > MaxRepeatCount || repeatCopies + count > MaxRepeatCount) {
+        error(childPointer(repeatPointer, "count"), "repeats generate " + std::to_string(repeatCopies + count) +
+            " copies, more than the limit of " + std::to_string(MaxRepeatCount));
+        return false;
+    }
+    repeatCopies += count;
+    int64_t start = readJsonValue<int64_t>(repeat, "start", 0);
+    std::string variable = readJsonValue<std::string>(repeat, "as", "i");
+    const json& idPattern = readJsonChild(repeat, "id_pattern");
+
+    // Offset of each copy from the previous one; column and row step by the size of the copy
+    const json& layout = readJsonChild(repeat, "layout");
+    std::string mode = layout.is_string() ? layout.get<std::string>() : layout.is_object() ? "offset" : "column";
+    if (mode != "column" && mode != "row" && mode != "none" && mode != "offset") {
+        error(childPointer(repeatPointer, "layout"), "expected \"column\", \"row\", \"none\" or { \"dx\", \"dy\" }");
+        return false;
+    }
+
+    json copyBase = item;
+    copyBase.erase(RepeatKey);
+    for (int64_t k = 0; k < count; k++) {
+        json params = scope;
+        params[variable] = start + k;
+        json copy = copyBase;
+        substitute(copy, params);
+
+        size_t first = out.size();
+        ok &= expandItem(copy, out, params, pointer, depth);
+        for (size_t r = first; r < out.size(); r++) {
+            json& result = out[r];
+            if (!result.is_object()) {
+                continue;
+            }
+            if (idPattern.is_string()) {
+                json id = idPattern;
+                substitute(id, params);
+                result["id"] = std::move(id);
+            }
+            const json& size = readJsonChild(result, "size");
+            float dx = 0;
+            float dy = 0;
+            if (mode == "column") {
+                dy = readJsonValue<float>(size, "height", GuiElementDesc().rect.height);
+            }
+            else if (mode == "row") {
+                dx = readJsonValue<float>(size, "width", GuiElementDesc().rect.width);
+            }
+            else if (mode == "offset") {
+                dx = readJsonValue<float>(layout, "dx", 0);
+                dy = readJsonValue<float>(layout, "dy", 0);
+            }
+            if (k > 0 && (dx != 0 || dy != 0)) {
+                json& position = result["position"];
+                if (!position.is_object()) {
+                    position = json::object();
+                }
+                position["x"] = readJsonValue<float>(position, "x", 0) + k * dx;
+                position["y"] = readJsonValue<float>(position, "y", 0) + k * dy;
+            }
+        }
+    }
+    return ok;
+}
+
+bool GuiConfigComposer::defineTemplates(const json& block, const std::string& pointer, int depth) {
+    if (block.is_object() && block.contains(IncludeKey)) {
+        const json& name = block[IncludeKey];
+        std::string path;
+        const json* included = name.is_string() ? include(name.get<std::string>(), childPointer(pointer, IncludeKey), path) : nullptr;
+        if (!included) {
+            if (!name.is_string()) {
+                error(childPointer(pointer, IncludeKey), "expected the path of a file");
+            }
+            return false;
+        }
+        if (depth >= MaxDepth) {
+            error(pointer, "includes nested deeper than " + std::to_string(MaxDepth) + " levels");
+            return false;
+        }
+        // A file of templates is either the templates or an object with a "$templates" block
+        fileStack.push_back(path);
+        auto nested = included->find(TemplatesKey);
+        bool ok = defineTemplates(nested != included->end() ? *nested : *included, "", depth + 1);
+        fileStack.pop_back();
+        return ok;
+    }
+    if (!block.is_object()) {
+        error(pointer, "expected an object of templates");
+        return false;
+    }
+    for (auto it = block.begin(); it != block.end(); ++it) {
+        templates[it.key()] = it.value();  // A later definition replaces an earlier one
+    }
+    return true;
+}
+
+const json* GuiConfigComposer::include(const std::string& name, const std::string& pointer, std::string& path) {
+    std::filesystem::path base = std::filesystem::path(fileStack.back()).parent_path();
+    path = (base / name).lexically_normal().string();
+    if (std::find(fileStack.begin(), fileStack.end(), path) != fileStack.end()) {
+        error(pointer, "circular include of " + name);
+        return nullptr;
+    }
+
+    MappedFile file;
+    if (!file.open(path)) {
+        error(pointer, "cannot read included file " + path);
+        return nullptr;
+    }
+    static const char empty = '\0';
+    const char* first = file.size() > 0 ? file.data() : &empty;
+    uint64_t hash = GuiModelLoader::hashBytes(first, file.size());
+    auto recorded = std::find_if(dependencies.begin(), dependencies.end(), [&](const GuiDependency& d) { return d.path == path; });
+    if (recorded == dependencies.end()) {
+        dependencies.push_back({ path, hash });
+    }
+
+    if (const json* cached = cache->find(path, hash)) {
+        return cached;
+    }
+    json document;
+    try {
+        document = json::parse(first, first + file.size());
+    }
+    catch (const nlohmann::json::parse_error& e) {
+        error(pointer, path + ": JSON parse error at byte " + std::to_string(e.byte) + ": " + e.what());
+        return nullptr;
+    }
+    parsedIncludes++;
+    return &cache->store(path, hash, std::move(document));
+}
+
+void GuiConfigComposer::substitute(json& value, const json& params) {
+    if (value.is_structured()) {
+        for (auto& child : value) {
+            substitute(child, params);
+        }
+        return;
+    }
+    if (!value.is_string()) {
+        return;
+    }
+    const std::string& text = value.get_ref<const std::string&>();
+    size_t open = text.find("${");
+    if (open == std::string::npos) {
+        return;
+    }
+
+    // A string that is only a parameter takes the parameter with its type
+    if (open == 0 && text.find('}') == text.size() - 1) {
+        auto found = params.find(text.substr(2, text.size() - 3));
+        if (found != params.end()) {
+            value = *found;
+            return;
+        }
+    }
+    std::string result;
+    size_t from = 0;
+    while (open != std::string::npos) {
+        size_t close = text.find('}', open + 2);
+        if (close == std::string::npos) {
+            break;
+        }
+        auto found = params.find(text.substr(open + 2, close - open - 2));
+        result.append(text, from, open - from);
+        if (found != params.end()) {
+            result += found->is_string() ? found->get<std::string>() : found->dump();
+        }
+        else {
+            result.append(text, open, close + 1 - open);
+        }
+        from = close + 1;
+        open = text.find("${", from);
+    }
+    result.append(text, from, std::string::npos);
+    value = std::move(result);
+}
+
+bool GuiConfigComposer::checkResolved(const json& value, const std::string& pointer) {
+    if (value.is_object()) {
+        bool ok = true;
+        for (auto it = value.begin(); it != value.end(); ++it) {
+            ok &= checkResolved(it.value(), childPointer(pointer, it.key()));
+        }
+        return ok;
+    }
+    if (value.is_array()) {
+        bool ok = true;
+        for (size_t i = 0; i < value.size(); i++) {
+            ok &= checkResolved(value[i], childPointer(pointer, i));
+        }
+        return ok;
+    }
+    if (!value.is_string()) {
+        return true;
+    }
+    const std::string& text = value.get_ref<const std::string&>();
+    size_t open = text.find("${");
+    size_t close = open != std::string::npos ? text.find('}', open) : std::string::npos;
+    if (close == std::string::npos) {
+        return true;
+    }
+    error(pointer, "no value for parameter '" + text.substr(open + 2, close - open - 2) + "'");
+    return false;
+}
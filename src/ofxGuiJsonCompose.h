@@ -0,0 +1,228 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonCompose.h
+
+    @brief    This file defines the composition stage of the loader, which
+              expands "$include" files, "$template" uses and "repeat"
+              generators into a plain configuration before it is compiled,
+              and the cache of parsed include files kept across reloads.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include "ofMain.h"
+#include <json.hpp>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using json = nlohmann::json;
+
+/*!
+ *  @struct GuiDependency
+ *  @brief A file included by a configuration, with the hash of the text it was expanded from.
+ */
+struct GuiDependency {
+    std::string path;       //!< The full path of the file.
+    uint64_t hash = 0;      //!< guiHash() of its text.
+};
+
+/*!
+ *  @class GuiIncludeCache
+ *  @brief Parsed include files by path. An entry is reused while the text of its file hashes the
+ *         same, so a reload parses only the files that changed.
+ */
+class GuiIncludeCache {
+public:
+    /*!
+     *  @brief Returns the parsed file, if it was parsed from the same text.
+     *  @param path The full path of the file.
+     *  @param hash guiHash() of its current text.
+     *  @return The parsed file, or nullptr.
+     */
+    const json* find(const std::string& path, uint64_t hash) const;
+
+    /*!
+     *  @brief Stores a parsed file, replacing its previous entry.
+     *  @param path The full path of the file.
+     *  @param hash guiHash() of its text.
+     *  @param document The parsed file.
+     *  @return The stored file.
+     */
+    const json& store(const std::string& path, uint64_t hash, json document);
+
+    /*!
+     *  @brief Removes all files.
+     */
+    void clear() { entries.clear(); }
+
+    /*!
+     *  @brief Returns the number of files.
+     */
+    size_t size() const { return entries.size(); }
+
+private:
+    /*!
+     *  @struct Entry
+     *  @brief A parsed file.
+     */
+    struct Entry {
+        uint64_t hash = 0;  //!< guiHash() of the text it was parsed from.
+        json document;      //!< The parsed file.
+    };
+
+    std::unordered_map<std::string, Entry> entries;     //!< Files by full path.
+};
+
+/*!
+ *  @class GuiConfigComposer
+ *  @brief Expands a configuration into one without composition keys:
+ *
+ *  - { "$include": "file.json" } is replaced by the file, relative to the including file. In an
+ *    array, an included array is spliced in. Other keys next to "$include" override those of an
+ *    included object.
+ *  - "$templates": { "name": value } defines templates in any object, and is removed from it.
+ *    { "$template": "name", "key": value } is replaced by the template, with "${key}" in its strings
+ *    replaced by the value. A string that is only "${key}" takes the value with its type. In an array,
+ *    a template that is an array is spliced in.
+ *  - An array item with "repeat": { "count": 4, "id_pattern": "device${i}", "layout": "column" }
+ *    is replaced by count copies, with "${i}" replaced by the index of each copy (from "start", 0 by
+ *    default; "as" renames i). "layout" offsets the position of each copy: "column" by its height,
+ *    "row" by its width, or { "dx": 0, "dy": 40 }; "none" keeps it.
+ */
+class GuiConfigComposer {
+public:
+    /*!
+     *  @brief Deepest nesting of includes and templates, to stop runaway recursion.
+     */
+    static constexpr int MaxDepth = 32;
+
+    /*!
+     *  @brief Most copies a configuration can generate with "repeat", for one repeat and for all of
+     *         them together, so a mistyped count fails instead of exhausting memory. Larger lists
+     *         are meant for "virtual_list".
+     */
+    static constexpr int64_t MaxRepeatCount = 100000;
+
+    /*!
+     *  @brief Creates a composer for a configuration file.
+     *  @param path The full path of the configuration, includes are relative to it.
+     *  @param includeCache Parsed include files kept across loads, may be null.
+     */
+    explicit GuiConfigComposer(const std::string& path, GuiIncludeCache* includeCache = nullptr);
+
+    /*!
+     *  @brief Returns true if a configuration text uses any composition key, so configurations
+     *         that do not can skip this stage and be streamed. Only names followed by a colon count,
+     *         so a string value such as "repeat" does not.
+     *  @param text The text.
+     *  @param length The length of the text.
+     */
+    static bool usesComposition(const char* text, size_t length);
+
+    /*!
+     *  @brief Expands a parsed configuration.
+     *  @param source The configuration as parsed.
+     *  @param expanded The configuration without composition keys.
+     *  @return False if an include could not be read or a template, parameter or repeat is invalid.
+     *          Every error is logged with the file and the JSON pointer of the key.
+     */
+    bool expand(const json& source, json& expanded);
+
+    /*!
+     *  @brief Returns the files included by the last expand(), with the hashes they were expanded from.
+     */
+    const std::vector<GuiDependency>& getDependencies() const { return dependencies; }
+
+    /*!
+     *  @brief Returns the number of include files parsed by the last expand(), the others came from the cache.
+     */
+    size_t getParsedIncludes() const { return parsedIncludes; }
+
+private:
+    /*!
+     *  @brief Expands a value that is not an array item.
+     *  @param value The value.
+     *  @param out Set to the expansion.
+     *  @param scope The parameters of the enclosing templates and repeats.
+     *  @param pointer JSON pointer of the value, for errors.
+     *  @param depth Nesting of includes and templates.
+     */
+    bool expandValue(const json& value, json& out, const json& scope, const std::string& pointer, int depth);
+
+    /*!
+     *  @brief Expands an array item, appending zero or more items.
+     *  @param item The item.
+     *  @param out The array appended to.
+     */
+    bool expandItem(const json& item, json& out, const json& scope, const std::string& pointer, int depth);
+
+    /*!
+     *  @brief Expands a "repeat" item, appending its copies.
+     */
+    bool expandRepeat(const json& item, json& out, const json& scope, const std::string& pointer, int depth);
+
+    /*!
+     *  @brief Expands an object with "$include" or "$template".
+     *  @param object The object.
+     *  @param out Set to the expansion, or appended to when splicing.
+     *  @param splice True for array items: an array replacement is appended item by item.
+     */
+    bool expandReference(const json& object, json& out, bool splice, const json& scope, const std::string& pointer, int depth);
+
+    /*!
+     *  @brief Registers the templates of a "$templates" block.
+     *  @param block The block, or an object with "$include" naming a file of templates.
+     */
+    bool defineTemplates(const json& block, const std::string& pointer, int depth);
+
+    /*!
+     *  @brief Returns an include file, parsed or from the cache.
+     *  @param name The path as written, relative to the including file.
+     *  @param pointer JSON pointer of the "$include", for errors.
+     *  @param path Set to the full path of the file.
+     *  @return The file, or nullptr if it could not be read or parsed.
+     */
+    const json* include(const std::string& name, const std::string& pointer, std::string& path);
+
+    /*!
+     *  @brief Replaces "${key}" in the strings of a value. Parameters that are not given are left
+     *         for an enclosing stage, e.g. the "${i}" of a repeat inside a template.
+     *  @param value The value, changed in place.
+     *  @param params The parameters.
+     */
+    static void substitute(json& value, const json& params);
+
+    /*!
+     *  @brief Reports the "${key}" left in the strings of the expansion, whose parameter was never given.
+     *  @param value The expansion.
+     *  @param pointer JSON pointer of the value.
+     */
+    bool checkResolved(const json& value, const std::string& pointer);
+
+    /*!
+     *  @brief Logs an error at the current file.
+     *  @param pointer JSON pointer of the key.
+     *  @param message What is wrong.
+     */
+    void error(const std::string& pointer, const std::string& message);
+
+    std::string rootPath;                               //!< The configuration file.
+    GuiIncludeCache* cache;                             //!< Parsed include files.
+    GuiIncludeCache localCache;                         //!< Used when no cache is given.
+    std::unordered_map<std::string, json> templates;    //!< Templates by name.
+    std::vector<std::string> fileStack;                 //!< The files being expanded, the configuration first.
+    std::vector<GuiDependency> dependencies;            //!< Files included, each once.
+    size_t parsedIncludes = 0;                          //!< Include files parsed, not from the cache.
+    int64_t repeatCopies = 0;                           //!< Copies generated by "repeat" so far.
+};
@@ -0,0 +1,45 @@
+#include "ofxGuiJsonDirtyTracker.h"
+
+void GuiDirtyTracker::resize(size_t panelCount) {
+    for (size_t i = panelCount; i < dirty.size(); i++) {
+        dirtyCount -= dirty[i];
+    }
+    if (panelCount > dirty.size()) {
+        dirtyCount += panelCount - dirty.size();
+    }
+    dirty.resize(panelCount, 1);
+    if (hoveredPanel != NoPanel && hoveredPanel >= panelCount) {
+        hoveredPanel = NoPanel;
+    }
+}
+
+void GuiDirtyTracker::markDirty(size_t panel) {
+    if (panel < dirty.size() && !dirty[panel]) {
+        dirty[panel] = 1;
+        dirtyCount++;
+    }
+}
+
+void GuiDirtyTracker::markAllDirty() {
+    for (auto& flag : dirty) {
+        flag = 1;
+    }
+    dirtyCount = dirty.size();
+}
+
+void GuiDirtyTracker::markClean(size_t panel) {
+    if (panel < dirty.size() && dirty[panel]) {
+        dirty[panel] = 0;
+        dirtyCount--;
+    }
+    renderCount++;
+}
+
+void GuiDirtyTracker::setHoveredPanel(size_t panel) {
+    if (panel == hoveredPanel) {
+        return;
+    }
+    markDirty(hoveredPanel);  // Ignored for NoPanel
+    markDirty(panel);
+    hoveredPanel = panel;
+}
@@ -0,0 +1,97 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonDirtyTracker.h
+
+    @brief    This file defines GuiDirtyTracker, the CPU-side bookkeeping of
+              the cached render mode. It records which panels must be
+              rendered again and has no dependency on a window or renderer,
+              so it can be driven and checked without a display.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*!
+ *  @class GuiDirtyTracker
+ *  @brief Tracks which panels changed since they were last rendered.
+ */
+class GuiDirtyTracker {
+public:
+    /*!
+     *  @brief Index used when no panel is hovered.
+     */
+    static constexpr size_t NoPanel = SIZE_MAX;
+
+    /*!
+     *  @brief Sets the number of tracked panels. Added panels start dirty.
+     *  @param panelCount The number of panels.
+     */
+    void resize(size_t panelCount);
+
+    /*!
+     *  @brief Marks a panel as needing a render. Out of range indices are ignored.
+     *  @param panel The index of the panel.
+     */
+    void markDirty(size_t panel);
+
+    /*!
+     *  @brief Marks every panel as needing a render.
+     */
+    void markAllDirty();
+
+    /*!
+     *  @brief Marks a panel as rendered.
+     *  @param panel The index of the panel.
+     */
+    void markClean(size_t panel);
+
+    /*!
+     *  @brief Returns true if a panel must be rendered again.
+     *  @param panel The index of the panel.
+     */
+    bool isDirty(size_t panel) const { return panel < dirty.size() && dirty[panel]; }
+
+    /*!
+     *  @brief Returns the number of panels that must be rendered again.
+     */
+    size_t getDirtyCount() const { return dirtyCount; }
+
+    /*!
+     *  @brief Returns the number of tracked panels.
+     */
+    size_t size() const { return dirty.size(); }
+
+    /*!
+     *  @brief Sets the panel under the pointer. When it changes, the panels left and entered are marked dirty.
+     *  @param panel The index of the hovered panel, or NoPanel.
+     */
+    void setHoveredPanel(size_t panel);
+
+    /*!
+     *  @brief Returns the panel under the pointer, or NoPanel.
+     */
+    size_t getHoveredPanel() const { return hoveredPanel; }
+
+    /*!
+     *  @brief Returns how many panel renders were recorded by markClean().
+     */
+    uint64_t getRenderCount() const { return renderCount; }
+
+private:
+    std::vector<uint8_t> dirty;         //!< Dirty flag per panel.
+    size_t dirtyCount = 0;              //!< Number of set flags.
+    size_t hoveredPanel = NoPanel;      //!< The panel under the pointer.
+    uint64_t renderCount = 0;           //!< Number of panel renders.
+};
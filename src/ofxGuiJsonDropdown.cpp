@@ -0,0 +1,63 @@
+#include "ofxGuiJsonDropdown.h"
+#include <algorithm>
+
+void ofxGuiJsonDropdown::setup(const std::string& label, const std::vector<std::string>& choices, int index, float width, float rowHeight) {
+    ofxGuiGroup::setup(label);
+    clear();
+    rows.clear();
+    rowListeners.clear();
+    title = label;
+    options = choices;
+    selected.set(label, std::clamp(index, 0, std::max(static_cast<int>(options.size()) - 1, 0)));
+
+    for (size_t o = 0; o < options.size(); o++) {
+        auto row = std::make_unique<ofxToggle>();
+        row->setup(options[o], false, width, rowHeight);
+        ofParameter<bool>& param = row->getParameter().cast<bool>();
+        rowListeners.push_back(param.newListener([this, o](bool& state) {
+            onOptionChanged(o, state);
+        }));
+        add(row.get());
+        rows.push_back(std::move(row));
+    }
+    setWidthElements(width);
+    showSelection();
+    minimize();
+}
+
+void ofxGuiJsonDropdown::setSelected(int index) {
+    if (index < 0 || static_cast<size_t>(index) >= options.size()) {
+        return;
+    }
+    if (index != selected.get()) {
+        selected = index;  // Notifies the listeners of the parameter
+    }
+    showSelection();
+}
+
+std::string ofxGuiJsonDropdown::getSelectedOption() const {
+    int index = selected.get();
+    return index >= 0 && static_cast<size_t>(index) < options.size() ? options[index] : std::string();
+}
+
+void ofxGuiJsonDropdown::onOptionChanged(size_t option, bool state) {
+    if (updating) {
+        return;
+    }
+    if (state) {
+        setSelected(static_cast<int>(option));
+        minimize();
+    }
+    else {
+        showSelection();  // The selected row was clicked again, keep it selected
+    }
+}
+
+void ofxGuiJsonDropdown::showSelection() {
+    updating = true;
+    for (size_t o = 0; o < rows.size(); o++) {
+        rows[o]->getParameter().cast<bool>() = static_cast<int>(o) == selected.get();
+    }
+    updating = false;
+    setName(options.empty() ? title : title + ": " + getSelectedOption());
+}
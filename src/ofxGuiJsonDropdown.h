@@ -0,0 +1,87 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonDropdown.h
+
+    @brief    This file defines the "dropdown" element: a collapsible group whose
+              header shows the selected option and whose rows select one option.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxGui.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/*!
+ *  @class ofxGuiJsonDropdown
+ *  @brief Group listing options as radio rows. Clicking the header opens or closes it, picking a row closes it.
+ */
+class ofxGuiJsonDropdown : public ofxGuiGroup {
+public:
+    /*!
+     *  @brief Creates one row per option. The dropdown starts closed.
+     *  @param label The title of the dropdown.
+     *  @param choices The options.
+     *  @param index The index of the selected option, clamped to the options.
+     *  @param width The width of the dropdown.
+     *  @param rowHeight The height of each row.
+     */
+    void setup(const std::string& label, const std::vector<std::string>& choices, int index, float width, float rowHeight);
+
+    /*!
+     *  @brief Selects an option, notifying the listeners of getSelectedParameter() if it changed.
+     *  @param index The index of the option. Out of range indices are ignored.
+     */
+    void setSelected(int index);
+
+    /*!
+     *  @brief Returns the index of the selected option.
+     */
+    int getSelected() const { return selected.get(); }
+
+    /*!
+     *  @brief Returns the text of the selected option, empty without options.
+     */
+    std::string getSelectedOption() const;
+
+    /*!
+     *  @brief Returns the parameter holding the selected index. Listen to it for changes.
+     */
+    ofParameter<int>& getSelectedParameter() { return selected; }
+
+    /*!
+     *  @brief Returns the options.
+     */
+    const std::vector<std::string>& getOptions() const { return options; }
+
+private:
+    /*!
+     *  @brief Handles a click on an option row.
+     *  @param option The index of the option.
+     *  @param state The new state of the row.
+     */
+    void onOptionChanged(size_t option, bool state);
+
+    /*!
+     *  @brief Shows the selection in the header and the row states.
+     */
+    void showSelection();
+
+    std::string title;                              //!< The title without the selection.
+    std::vector<std::string> options;               //!< The options.
+    std::vector<std::unique_ptr<ofxToggle>> rows;   //!< One row per option.
+    std::vector<ofEventListener> rowListeners;      //!< Listeners of the rows.
+    ofParameter<int> selected;                      //!< The index of the selected option.
+    bool updating = false;                          //!< Set while rows are updated, so their changes are not clicks.
+};
@@ -0,0 +1,155 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonEvent.h
+
+    @brief    This file defines GuiEvent, the typed payload notified when any
+              element changes, and GuiEventQueue, which collects the changes
+              of a frame so they can be drained in one pass.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include "ofxGuiJsonId.h"
+#include <cstdint>
+#include <vector>
+
+/*!
+ *  @enum GuiEventType
+ *  @brief Which member of GuiEvent::value is set.
+ */
+enum class GuiEventType : uint8_t {
+    Toggle,     //!< value.toggle, from toggles.
+    Float,      //!< value.number, from sliders and float fields.
+    Int,        //!< value.integer, from integer sliders and fields.
+    Trigger,    //!< No value, from buttons.
+    Choice      //!< value.integer is the index of the selected option, from dropdowns.
+};
+
+/*!
+ *  @struct GuiEvent
+ *  @brief Change of an element. Holds interned IDs and no strings, so it is copied without allocating.
+ */
+struct GuiEvent {
+    GuiEventType type = GuiEventType::Toggle;   //!< The type of the value.
+    GuiId id;                                   //!< The ID of the element, see ofxGuiJson::getName().
+    GuiId action;                               //!< The "action" of the element, invalid if it has none.
+    uint64_t actionKey = 0;                     //!< guiHash() of the action, 0 if none; switch on it with case guiHash("name").
+
+    /*!
+     *  @union Value
+     *  @brief The new value, selected by type.
+     */
+    union Value {
+        bool toggle;        //!< GuiEventType::Toggle.
+        float number;       //!< GuiEventType::Float.
+        int32_t integer;    //!< GuiEventType::Int and GuiEventType::Choice.
+    } value = { false };    //!< The new value.
+
+    /*!
+     *  @brief Returns the value as a boolean, true for any non-zero value and for triggers.
+     */
+    bool asBool() const {
+        switch (type) {
+        case GuiEventType::Toggle: return value.toggle;
+        case GuiEventType::Float: return value.number != 0;
+        case GuiEventType::Trigger: return true;
+        default: return value.integer != 0;
+        }
+    }
+
+    /*!
+     *  @brief Returns the value as a number, 1 or 0 for toggles and 1 for triggers.
+     */
+    float asFloat() const {
+        switch (type) {
+        case GuiEventType::Toggle: return value.toggle ? 1.f : 0.f;
+        case GuiEventType::Float: return value.number;
+        case GuiEventType::Trigger: return 1.f;
+        default: return static_cast<float>(value.integer);
+        }
+    }
+
+    /*!
+     *  @brief Returns the value as an integer, truncating floats.
+     */
+    int asInt() const {
+        switch (type) {
+        case GuiEventType::Toggle: return value.toggle ? 1 : 0;
+        case GuiEventType::Float: return static_cast<int>(value.number);
+        case GuiEventType::Trigger: return 1;
+        default: return value.integer;
+        }
+    }
+};
+
+/*!
+ *  @class GuiEventQueue
+ *  @brief Double-buffered list of the events of a frame. Both buffers keep their capacity,
+ *         so once warmed up, pushing and draining never allocate.
+ */
+class GuiEventQueue {
+public:
+    /*!
+     *  @brief Enables or disables collection. A disabled queue ignores push() and drops pending events.
+     *  @param enable True to collect events.
+     *  @param capacity Number of events each buffer holds before growing.
+     */
+    void setEnabled(bool enable, size_t capacity = 256) {
+        enabled = enable;
+        pending.clear();
+        drained.clear();
+        if (enable) {
+            pending.reserve(capacity);
+            drained.reserve(capacity);
+        }
+    }
+
+    /*!
+     *  @brief Returns true if events are collected.
+     */
+    bool isEnabled() const { return enabled; }
+
+    /*!
+     *  @brief Appends an event if the queue is enabled.
+     *  @param event The event.
+     */
+    void push(const GuiEvent& event) {
+        if (enabled) {
+            pending.push_back(event);
+        }
+    }
+
+    /*!
+     *  @brief Returns the events pushed since the previous drain, in order.
+     *  @return The events, valid until the next drain.
+     */
+    const std::vector<GuiEvent>& drain() {
+        drained.clear();
+        drained.swap(pending);
+        return drained;
+    }
+
+    /*!
+     *  @brief Returns the number of events waiting to be drained.
+     */
+    size_t size() const { return pending.size(); }
+
+    /*!
+     *  @brief Returns the number of events held before the pending buffer grows.
+     */
+    size_t capacity() const { return pending.capacity(); }
+
+private:
+    std::vector<GuiEvent> pending;  //!< Events pushed since the last drain.
+    std::vector<GuiEvent> drained;  //!< Events returned by the last drain.
+    bool enabled = false;           //!< Whether push() collects events.
+};
@@ -0,0 +1,165 @@
+#include "ofxGuiJsonHeadlessBackend.h"
+#include <algorithm>
+
+void GuiHeadlessBackend::setupPanel(size_t panel, const GuiPanelModel& panelModel) {
+    panels[panel].title = panelModel.title;
+    panels[panel].shape = ofRectangle(panelModel.x, panelModel.y, panelModel.width, panelModel.height);
+}
+
+void GuiHeadlessBackend::updatePanel(size_t panel, const GuiPanelModel& /*previous*/, const GuiPanelModel& next) {
+    setupPanel(panel, next);
+}
+
+void GuiHeadlessBackend::setPanelElements(size_t panel, const std::vector<GuiElementRef>& panelElements) {
+    panels[panel].elements = panelElements;
+}
+
+size_t GuiHeadlessBackend::findPanelAt(float x, float y) const {
+    for (size_t p = panels.size(); p-- > 0;) {
+        const ofRectangle& shape = panels[p].shape;
+        if (x >= shape.x && y >= shape.y && x <= shape.x + shape.width && y <= shape.y + shape.height) {
+            return p;
+        }
+    }
+    return GuiDirtyTracker::NoPanel;
+}
+
+void GuiHeadlessBackend::draw(GuiDirtyTracker& dirtyTracker, bool cached) {
+    drawCount++;
+    if (!cached) {
+        return;
+    }
+    // Nothing is rendered, the renders that would have happened are recorded
+    dirtyTracker.resize(panels.size());
+    for (size_t p = 0; p < panels.size(); p++) {
+        if (dirtyTracker.isDirty(p)) {
+            dirtyTracker.markClean(p);
+        }
+    }
+}
+
+void GuiHeadlessBackend::reserve(const GuiTypeCounts& counts) {
+    size_t total = 0;
+    for (size_t count : counts) {
+        total += count;
+    }
+    elements.reserve(total);
+}
+
+GuiElementRef GuiHeadlessBackend::create(GuiElementType type, const std::string& label, const ofRectangle& rect) {
+    GuiElementRef element;
+    element.type = type;
+    element.handle = elements.create();
+    Element* state = elements.get(element.handle);
+    state->type = type;
+    state->label = label;
+    state->rect = rect;
+    return element;
+}
+
+GuiElementRef GuiHeadlessBackend::createElement(const GuiModel& model, size_t index, const ofRectangle& rect) {
+    GuiElementType type = model.types[index];
+    if (type == GuiElementType::Unknown) {
+        return GuiElementRef();
+    }
+    GuiElementRef element = create(type, model.labels[index], rect);
+    Element* state = elements.get(element.handle);
+    state->minValue = model.mins[index];
+    state->maxValue = model.maxs[index];
+    state->options = model.options[index];
+    if (hasElementValue(type) && type != GuiElementType::Button) {
+        state->value = toElementValue(type, model.defaults[index]);
+    }
+    return element;
+}
+
+GuiElementRef GuiHeadlessBackend::createToggle(const std::string& label, bool state, const ofRectangle& rect) {
+    GuiElementRef element = create(GuiElementType::Toggle, label, rect);
+    elements.get(element.handle)->value.toggle = state;
+    return element;
+}
+
+void GuiHeadlessBackend::clear() {
+    panels.clear();
+    mainPanel.clear();
+    elements.clear();
+}
+
+void GuiHeadlessBackend::setLabel(const GuiElementRef& element, const std::string& text) {
+    Element* state = elements.get(element.handle);
+    if (state && state->label != text) {
+        state->label = text;
+        labelWrites++;
+    }
+}
+
+std::string GuiHeadlessBackend::getLabel(const GuiElementRef& element) const {
+    const Element* state = elements.get(element.handle);
+    return state ? state->label : std::string();
+}
+
+void GuiHeadlessBackend::setRect(const GuiElementRef& element, const ofRectangle& rect) {
+    Element* state = elements.get(element.handle);
+    if (state) {
+        state->rect = rect;
+    }
+}
+
+ofEventListener GuiHeadlessBackend::listen(const GuiElementRef& element, std::function<void(const GuiEvent::Value&)> callback) {
+    Element* state = elements.get(element.handle);
+    if (!state || !hasElementValue(state->type)) {
+        return ofEventListener();
+    }
+    return state->changed.newListener([callback](GuiEvent::Value& value) {
+        callback(value);
+    });
+}
+
+GuiEvent::Value GuiHeadlessBackend::getValue(const GuiElementRef& element) const {
+    const Element* state = elements.get(element.handle);
+    return state ? state->value : GuiEvent::Value{};
+}
+
+bool GuiHeadlessBackend::setValue(const GuiElementRef& element, const GuiEvent::Value& value) {
+    Element* state = elements.get(element.handle);
+    if (!state || !hasElementValue(state->type)) {
+        return false;
+    }
+
+    // Ranges are enforced as the widgets do, a dropdown ignores options it does not have
+    GuiEvent::Value next = value;
+    switch (state->type) {
+    case GuiElementType::Slider:
+    case GuiElementType::FloatField:
+        next.number = ofClamp(value.number, state->minValue, state->maxValue);
+        break;
+    case GuiElementType::IntSlider:
+    case GuiElementType::IntField:
+        next.integer = std::clamp(value.integer, static_cast<int32_t>(std::lround(state->minValue)),
+            static_cast<int32_t>(std::lround(state->maxValue)));
+        break;
+    case GuiElementType::Dropdown:
+        if (value.integer < 0 || static_cast<size_t>(value.integer) >= state->options.size()) {
+            return false;
+        }
+        if (value.integer == state->value.integer) {
+            return true;  // Selecting the selected option changes nothing
+        }
+        break;
+    case GuiElementType::Button:
+        next = GuiEvent::Value{};
+        break;
+    default:
+        break;
+    }
+    state->value = next;
+    ofNotifyEvent(state->changed, next);
+    return true;
+}
+
+void GuiHeadlessBackend::removeFromMainPanel(const GuiElementRef& element) {
+    auto it = std::find(mainPanel.begin(), mainPanel.end(), element);
+    if (it != mainPanel.end()) {
+        mainPanel.erase(it);
+    }
+}
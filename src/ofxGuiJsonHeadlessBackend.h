@@ -0,0 +1,139 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonHeadlessBackend.h
+
+    @brief    This file defines GuiHeadlessBackend, a GuiBackend keeping the state
+              of every element in memory without creating widgets or touching GL,
+              to run loads, dispatch, label updates and reloads in tests and
+              benchmarks on machines without a GPU.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxGuiJsonBackend.h"
+#include <string>
+#include <vector>
+
+/*!
+ *  @class GuiHeadlessBackend
+ *  @brief GuiBackend storing elements as plain records. draw() renders nothing, it only
+ *         marks the dirty panels clean, so render counts can be checked.
+ *
+ *  Pass it to the ofxGuiJson constructor and drive the elements with setValue():
+ *  @code
+ *  auto backend = std::make_unique<GuiHeadlessBackend>();
+ *  GuiHeadlessBackend& headless = *backend;
+ *  ofxGuiJson gui(std::move(backend));
+ *  gui.setup("config.json");
+ *  gui.setElementValue("muteToggle", 1);
+ *  @endcode
+ */
+class GuiHeadlessBackend : public GuiBackend {
+public:
+    /*!
+     *  @struct Element
+     *  @brief State of one element.
+     */
+    struct Element {
+        GuiElementType type = GuiElementType::Unknown;  //!< The element type.
+        std::string label;                              //!< The text shown by the element.
+        ofRectangle rect;                               //!< The position and size of the element.
+        GuiEvent::Value value = {};                     //!< The value, typed as the GuiEvent of the type.
+        float minValue = 0;                             //!< The lowest value of ranged types.
+        float maxValue = 1;                             //!< The highest value of ranged types.
+        std::vector<std::string> options;               //!< The options of a dropdown.
+        ofEvent<GuiEvent::Value> changed;               //!< Notified by setValue().
+    };
+
+    /*!
+     *  @struct Panel
+     *  @brief State of one panel.
+     */
+    struct Panel {
+        std::string title;                      //!< The title.
+        ofRectangle shape;                      //!< The position and size.
+        std::vector<GuiElementRef> elements;    //!< The elements, in display order.
+    };
+
+    void setPanelCount(size_t count) override { panels.resize(count); }
+    size_t getPanelCount() const override { return panels.size(); }
+    void setupPanel(size_t panel, const GuiPanelModel& panelModel) override;
+    void updatePanel(size_t panel, const GuiPanelModel& previous, const GuiPanelModel& next) override;
+    void setPanelElements(size_t panel, const std::vector<GuiElementRef>& panelElements) override;
+    size_t findPanelAt(float x, float y) const override;
+    void draw(GuiDirtyTracker& dirtyTracker, bool cached) override;
+
+    void reserve(const GuiTypeCounts& counts) override;
+    GuiElementRef createElement(const GuiModel& model, size_t index, const ofRectangle& rect) override;
+    GuiElementRef createToggle(const std::string& label, bool state, const ofRectangle& rect) override;
+    void destroyElement(const GuiElementRef& element) override { elements.destroy(element.handle); }
+    void clear() override;
+    void setLabel(const GuiElementRef& element, const std::string& text) override;
+    std::string getLabel(const GuiElementRef& element) const override;
+    void setRect(const GuiElementRef& element, const ofRectangle& rect) override;
+    ofEventListener listen(const GuiElementRef& element, std::function<void(const GuiEvent::Value&)> callback) override;
+    GuiEvent::Value getValue(const GuiElementRef& element) const override;
+    bool setValue(const GuiElementRef& element, const GuiEvent::Value& value) override;
+
+    void addToMainPanel(const GuiElementRef& element) override { mainPanel.push_back(element); }
+    void removeFromMainPanel(const GuiElementRef& element) override;
+    void clearMainPanel() override { mainPanel.clear(); }
+
+    /*!
+     *  @brief Returns the state of an element.
+     *  @param element The element.
+     *  @return The state, or nullptr for stale references.
+     */
+    const Element* getElement(const GuiElementRef& element) const { return elements.get(element.handle); }
+
+    /*!
+     *  @brief Returns the number of live elements.
+     */
+    size_t getElementCount() const { return elements.size(); }
+
+    /*!
+     *  @brief Returns the state of a panel.
+     *  @param panel The index of the panel, below getPanelCount().
+     */
+    const Panel& getPanel(size_t panel) const { return panels[panel]; }
+
+    /*!
+     *  @brief Returns the elements of the main panel, in display order.
+     */
+    const std::vector<GuiElementRef>& getMainPanelElements() const { return mainPanel; }
+
+    /*!
+     *  @brief Returns how many times setLabel() changed a text.
+     */
+    uint64_t getLabelWriteCount() const { return labelWrites; }
+
+    /*!
+     *  @brief Returns how many times draw() was called.
+     */
+    uint64_t getDrawCount() const { return drawCount; }
+
+private:
+    /*!
+     *  @brief Creates an element with its type and label.
+     *  @param type The element type.
+     *  @param label The text shown by the element.
+     *  @param rect The position and size.
+     */
+    GuiElementRef create(GuiElementType type, const std::string& label, const ofRectangle& rect);
+
+    WidgetPool<Element> elements;           //!< All elements, whatever their type.
+    std::vector<Panel> panels;              //!< One panel per panel of the model.
+    std::vector<GuiElementRef> mainPanel;   //!< The elements of the main panel.
+    uint64_t labelWrites = 0;               //!< Number of texts changed by setLabel().
+    uint64_t drawCount = 0;                 //!< Number of draw() calls.
+};
@@ -0,0 +1,150 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonId.h
+
+    @brief    This file defines GuiId, the small integer standing for an element
+              ID or action name, the GuiStringTable interning those names at load
+              time, and guiHash, a constexpr hash to switch on action names.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*!
+ *  @brief Hashes a name with 64-bit FNV-1a. Usable in constant expressions, e.g. as a case label:
+ *         case guiHash("toggleMute"):
+ *  @param text The name.
+ *  @param length The length of the name.
+ */
+constexpr uint64_t guiHash(const char* text, size_t length) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= static_cast<unsigned char>(text[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/*!
+ *  @brief Hashes a null-terminated name with 64-bit FNV-1a.
+ *  @param text The name.
+ */
+constexpr uint64_t guiHash(const char* text) {
+    size_t length = 0;
+    while (text[length] != '\0') {
+        length++;
+    }
+    return guiHash(text, length);
+}
+
+/*!
+ *  @brief Hashes a name with 64-bit FNV-1a.
+ *  @param text The name.
+ */
+inline uint64_t guiHash(const std::string& text) {
+    return guiHash(text.data(), text.size());
+}
+
+/*!
+ *  @struct GuiId
+ *  @brief Interned element ID or action name. Compared and hashed as an integer.
+ */
+struct GuiId {
+    uint32_t value = UINT32_MAX;    //!< Index of the name in its GuiStringTable.
+
+    /*!
+     *  @brief Returns true if the ID refers to a name.
+     */
+    bool isValid() const { return value != UINT32_MAX; }
+
+    bool operator==(const GuiId& other) const { return value == other.value; }
+    bool operator!=(const GuiId& other) const { return value != other.value; }
+    bool operator<(const GuiId& other) const { return value < other.value; }
+};
+
+namespace std {
+    template<>
+    struct hash<GuiId> {
+        size_t operator()(const GuiId& id) const { return id.value; }
+    };
+}
+
+/*!
+ *  @class GuiStringTable
+ *  @brief Interns names, giving each distinct name a GuiId that stays the same for the life of the table.
+ *
+ *  Names are never removed, so IDs held by the application stay valid across reloads. Main thread only.
+ */
+class GuiStringTable {
+public:
+    /*!
+     *  @brief Returns the ID of a name, adding the name if it is new.
+     *  @param name The name.
+     */
+    GuiId intern(const std::string& name) {
+        GuiId id = find(name);
+        if (id.isValid()) {
+            return id;
+        }
+        id.value = static_cast<uint32_t>(names.size());
+        names.push_back(name);
+        hashes.push_back(guiHash(name));
+        lookup.emplace(names.back(), id.value);  // Keyed by the stored copy, which never moves
+        return id;
+    }
+
+    /*!
+     *  @brief Returns the ID of a name without adding it.
+     *  @param name The name.
+     *  @return The ID, invalid if the name was never interned.
+     */
+    GuiId find(std::string_view name) const {
+        GuiId id;
+        auto it = lookup.find(name);
+        if (it != lookup.end()) {
+            id.value = it->second;
+        }
+        return id;
+    }
+
+    /*!
+     *  @brief Returns the name of an ID, empty for invalid IDs.
+     *  @param id The ID.
+     */
+    const std::string& name(GuiId id) const {
+        static const std::string empty;
+        return id.value < names.size() ? names[id.value] : empty;
+    }
+
+    /*!
+     *  @brief Returns guiHash() of the name of an ID, 0 for invalid IDs.
+     *  @param id The ID.
+     */
+    uint64_t hash(GuiId id) const { return id.value < hashes.size() ? hashes[id.value] : 0; }
+
+    /*!
+     *  @brief Returns the number of interned names.
+     */
+    size_t size() const { return names.size(); }
+
+private:
+    std::deque<std::string> names;                              //!< Names by ID, stable addresses.
+    std::vector<uint64_t> hashes;                               //!< guiHash() of each name.
+    std::unordered_map<std::string_view, uint32_t> lookup;      //!< Name to ID, viewing into names.
+};
@@ -0,0 +1,458 @@
+#include "ofxGuiJsonLayout.h"
+#include <algorithm>
+
+namespace {
+    // Size of elements whose size is not given, as in GuiElementDesc
+    constexpr float DefaultWidth = 300;
+    constexpr float DefaultHeight = 30;
+
+    bool sameRect(const ofRectangle& a, const ofRectangle& b) {
+        return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+    }
+}
+
+float GuiLayout::measureText(const std::string& text) {
+    size_t characters = 0;
+    for (unsigned char c : text) {
+        characters += (c & 0xC0) != 0x80;  // Continuation bytes of UTF-8 sequences are not characters
+    }
+    return characters * CharWidth;
+}
+
+float GuiLayout::measureElementWidth(GuiElementType type, const std::string& label) {
+    float text = measureText(label) + 2 * TextPadding;
+    switch (type) {
+    case GuiElementType::Label:
+    case GuiElementType::Button:
+        return text;
+    case GuiElementType::Toggle:
+        return text + DefaultHeight;  // The check box is as wide as it is high
+    default:
+        return std::max(DefaultWidth, text);
+    }
+}
+
+ofRectangle GuiLayout::toElementRect(const GuiModel& model, size_t index, const ofRectangle& box) {
+    ofRectangle rect = box;
+    if (model.types[index] == GuiElementType::VirtualList) {
+        rect.height = box.height / std::max(model.visibleRows[index], 1u);
+    }
+    return rect;
+}
+
+void GuiLayout::layoutPanel(GuiModel& model, size_t panel) {
+    const GuiPanelModel& panelModel = model.panels[panel];
+    if (!panelModel.valid || !panelModel.hasLayout()) {
+        return;  // Elements keep the rects given in JSON
+    }
+    GuiLayout layout;
+    layout.addPanel(model, panel);
+    layout.layoutAll();
+    for (const auto& node : layout.nodes) {
+        if (node.live && !node.isGroup) {
+            model.rects[node.slot] = toElementRect(model, node.slot, node.rect);
+        }
+    }
+}
+
+void GuiLayout::build(const GuiModel& model) {
+    clear();
+    for (size_t p = 0; p < model.panels.size(); p++) {
+        const GuiPanelModel& panelModel = model.panels[p];
+        if (panelModel.valid && panelModel.hasLayout()) {
+            addPanel(model, p);
+        }
+    }
+    layoutAll();
+}
+
+uint32_t GuiLayout::findElement(uint32_t id) const {
+    auto found = idNodes.find(id);
+    return found != idNodes.end() ? found->second : NoNode;
+}
+
+void GuiLayout::addPanel(const GuiModel& model, size_t panel) {
+    const GuiPanelModel& panelModel = model.panels[panel];
+    uint32_t root = addGroup(NoNode, panelModel.layout, ofRectangle(0, 0, panelModel.width, 0), GuiFixedWidth);
+
+    // Groups are stored in the order they start, so a group comes before the elements added after its start
+    std::vector<uint32_t> groupNodes(panelModel.groupCount, NoNode);
+    size_t group = panelModel.firstGroup;
+    size_t lastGroup = panelModel.firstGroup + panelModel.groupCount;
+    size_t lastElement = panelModel.firstElement + panelModel.elementCount;
+    auto parentOf = [&](uint32_t modelGroup) {
+        return modelGroup == GuiGroupModel::NoGroup ? root : groupNodes[modelGroup - panelModel.firstGroup];
+    };
+    for (size_t i = panelModel.firstElement; i <= lastElement; i++) {
+        for (; group < lastGroup && model.groups[group].firstElement <= i; group++) {
+            const GuiGroupModel& groupModel = model.groups[group];
+            groupNodes[group - panelModel.firstGroup] = addGroup(parentOf(groupModel.parent), groupModel.layout, groupModel.rect, groupModel.fixedSize);
+        }
+        if (i == lastElement || model.types[i] == GuiElementType::Unknown) {
+            continue;  // Unknown elements are not created, so they take no space
+        }
+
+        uint8_t fixedSize = model.fixedSizes[i];
+        float width = measureElementWidth(model.types[i], model.labels[i]);
+        float height = DefaultHeight;
+        if (model.types[i] == GuiElementType::VirtualList) {
+            // The given height is the height of a row
+            height = (fixedSize & GuiFixedHeight ? model.rects[i].height : DefaultHeight) * std::max(model.visibleRows[i], 1u);
+            fixedSize &= ~GuiFixedHeight;
+        }
+        uint32_t item = addItem(parentOf(model.elementGroups[i]), model.rects[i], fixedSize, width, height, static_cast<uint32_t>(i));
+        if (model.ids[i] != GuiModel::NoId) {
+            idNodes[model.ids[i]] = item;
+        }
+    }
+}
+
+uint32_t GuiLayout::allocate() {
+    uint32_t node;
+    if (!freeNodes.empty()) {
+        node = freeNodes.back();
+        freeNodes.pop_back();
+        nodes[node] = Node();
+    }
+    else {
+        node = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+    }
+    nodes[node].live = true;
+    return node;
+}
+
+uint32_t GuiLayout::addGroup(uint32_t parent, const GuiLayoutSpec& spec, const ofRectangle& rect, uint8_t fixedSize) {
+    uint32_t node = allocate();
+    Node& group = nodes[node];
+    group.isGroup = true;
+    group.spec = spec;
+    group.given = rect;
+    group.fixedSize = fixedSize;
+    group.parent = parent;
+    if (parent == NoNode) {
+        roots.push_back(node);
+    }
+    else {
+        Node& parentNode = nodes[parent];
+        group.position = static_cast<uint32_t>(parentNode.children.size());
+        parentNode.children.push_back(node);
+        parentNode.firstDirty = std::min(parentNode.firstDirty, group.position);
+    }
+    queue(node);
+    return node;
+}
+
+uint32_t GuiLayout::addItem(uint32_t parent, const ofRectangle& rect, uint8_t fixedSize, float width, float height, uint32_t slot) {
+    uint32_t node = allocate();
+    Node& item = nodes[node];
+    Node& parentNode = nodes[parent];
+    item.given = rect;
+    item.fixedSize = fixedSize;
+    item.contentWidth = width;
+    item.contentHeight = height;
+    item.slot = slot;
+    item.parent = parent;
+    item.position = static_cast<uint32_t>(parentNode.children.size());
+    parentNode.children.push_back(node);
+    parentNode.firstDirty = std::min(parentNode.firstDirty, item.position);
+    queue(node);
+    return node;
+}
+
+void GuiLayout::remove(uint32_t node) {
+    if (node >= nodes.size() || !nodes[node].live) {
+        return;
+    }
+    uint32_t parent = nodes[node].parent;
+    if (parent == NoNode) {
+        roots.erase(std::find(roots.begin(), roots.end(), node));
+    }
+    else {
+        // Only the siblings after the node are renumbered and placed again
+        Node& parentNode = nodes[parent];
+        uint32_t position = nodes[node].position;
+        parentNode.children.erase(parentNode.children.begin() + position);
+        for (size_t i = position; i < parentNode.children.size(); i++) {
+            nodes[parentNode.children[i]].position = static_cast<uint32_t>(i);
+        }
+        parentNode.firstDirty = std::min(parentNode.firstDirty, position);
+        queue(parent);
+    }
+    release(node);
+}
+
+void GuiLayout::release(uint32_t node) {
+    for (uint32_t child : nodes[node].children) {
+        release(child);
+    }
+    nodes[node].children.clear();
+    nodes[node].live = false;
+    freeNodes.push_back(node);
+}
+
+void GuiLayout::setContentWidth(uint32_t node, float width) {
+    if (node >= nodes.size() || !nodes[node].live || nodes[node].contentWidth == width) {
+        return;
+    }
+    nodes[node].contentWidth = width;
+    if (!(nodes[node].fixedSize & GuiFixedWidth)) {
+        queue(node);
+    }
+}
+
+void GuiLayout::queue(uint32_t node) {
+    if (!nodes[node].queued) {
+        nodes[node].queued = true;
+        pending.push_back(node);
+    }
+}
+
+void GuiLayout::clear() {
+    nodes.clear();
+    freeNodes.clear();
+    roots.clear();
+    pending.clear();
+    moved.clear();
+    idNodes.clear();
+    stats = GuiLayoutStats();
+}
+
+bool GuiLayout::measure(uint32_t node) {
+    Node& n = nodes[node];
+    stats.measured++;
+    float width = n.contentWidth;
+    float height = n.contentHeight;
+    if (n.isGroup) {
+        const GuiLayoutSpec& spec = n.spec;
+        size_t count = n.children.size();
+        float gaps = count > 1 ? spec.gap * (count - 1) : 0;
+        width = 0;
+        height = 0;
+        switch (spec.type) {
+        case GuiLayoutType::Column:
+            for (uint32_t child : n.children) {
+                width = std::max(width, nodes[child].width);
+                height += nodes[child].height;
+            }
+            height += gaps;
+            break;
+        case GuiLayoutType::Row:
+            for (uint32_t child : n.children) {
+                width += nodes[child].width;
+                height = std::max(height, nodes[child].height);
+            }
+            width += gaps;
+            break;
+        case GuiLayoutType::Grid: {
+            size_t columns = std::max(spec.columns, 1u);
+            size_t rows = (count + columns - 1) / columns;
+            float rowHeight = 0;
+            for (size_t i = 0; i < count; i++) {
+                const Node& child = nodes[n.children[i]];
+                width = std::max(width, child.width);
+                rowHeight = std::max(rowHeight, child.height);
+                if (i % columns == columns - 1 || i == count - 1) {
+                    height += rowHeight;
+                    rowHeight = 0;
+                }
+            }
+            width = width * columns + spec.gap * (columns - 1);
+            height += rows > 1 ? spec.gap * (rows - 1) : 0;
+            break;
+        }
+        default:
+            // Children keep their positions, the group is as large as their bounds
+            for (uint32_t child : n.children) {
+                const Node& c = nodes[child];
+                width = std::max(width, c.given.x + (c.isGroup ? c.width : c.given.width));
+                height = std::max(height, c.given.y + (c.isGroup ? c.height : c.given.height));
+            }
+            break;
+        }
+        width += 2 * spec.padding;
+        height += 2 * spec.padding;
+    }
+    if (n.fixedSize & GuiFixedWidth) {
+        width = n.given.width;
+    }
+    if (n.fixedSize & GuiFixedHeight) {
+        height = n.given.height;
+    }
+    bool changed = width != n.width || height != n.height;
+    n.width = width;
+    n.height = height;
+    return changed;
+}
+
+void GuiLayout::measureAll(uint32_t node) {
+    for (uint32_t child : nodes[node].children) {
+        measureAll(child);
+    }
+    measure(node);
+}
+
+void GuiLayout::layoutAll() {
+    stats = GuiLayoutStats();
+    moved.clear();
+    for (uint32_t node : pending) {
+        nodes[node].queued = false;
+    }
+    pending.clear();
+    for (uint32_t root : roots) {
+        measureAll(root);
+        arrange(root, positionedBox(root));
+    }
+    stats.moved = moved.size();
+}
+
+void GuiLayout::propagate(uint32_t node, std::vector<uint32_t>& arrangeRoots) {
+    uint32_t current = node;
+    while (true) {
+        bool resized = measure(current) || !nodes[current].placed;
+        const Node& n = nodes[current];
+        if (!resized) {
+            if (n.isGroup && n.firstDirty != NoNode) {
+                arrangeRoots.push_back(current);  // Same size, only its children move
+            }
+            return;
+        }
+        if (n.parent == NoNode) {
+            arrangeRoots.push_back(current);
+            return;
+        }
+        Node& parent = nodes[n.parent];
+        parent.firstDirty = std::min(parent.firstDirty, n.position);
+        current = n.parent;
+    }
+}
+
+bool GuiLayout::update() {
+    stats = GuiLayoutStats();
+    moved.clear();
+    std::vector<uint32_t> arrangeRoots;
+    for (size_t i = 0; i < pending.size(); i++) {
+        uint32_t node = pending[i];
+        nodes[node].queued = false;
+        if (nodes[node].live) {
+            propagate(node, arrangeRoots);
+        }
+    }
+    pending.clear();
+
+    for (uint32_t node : arrangeRoots) {
+        const Node& n = nodes[node];
+        if (n.live) {
+            arrange(node, n.parent == NoNode ? positionedBox(node) : n.rect);
+        }
+    }
+    stats.moved = moved.size();
+    return !moved.empty();
+}
+
+ofRectangle GuiLayout::positionedBox(uint32_t node) const {
+    const Node& n = nodes[node];
+    if (n.parent == NoNode) {
+        return ofRectangle(n.given.x, n.given.y, n.width, n.height);
+    }
+    const Node& parent = nodes[n.parent];
+    float x = parent.rect.x + parent.spec.padding + n.given.x;
+    float y = parent.rect.y + parent.spec.padding + n.given.y;
+    return n.isGroup ? ofRectangle(x, y, n.width, n.height) : ofRectangle(x, y, n.given.width, n.given.height);
+}
+
+void GuiLayout::place(uint32_t node, const ofRectangle& box) {
+    const Node& n = nodes[node];
+    if (n.placed && n.firstDirty == NoNode && sameRect(box, n.rect)) {
+        return;
+    }
+    arrange(node, box);
+}
+
+void GuiLayout::arrange(uint32_t node, const ofRectangle& box) {
+    Node& n = nodes[node];
+    bool repositioned = !n.placed || box.x != n.rect.x || box.y != n.rect.y;
+    bool widened = !n.placed || box.width != n.rect.width;
+    bool changed = repositioned || widened || box.height != n.rect.height;
+    n.rect = box;
+    n.placed = true;
+    stats.placed++;
+    if (!n.isGroup) {
+        if (changed) {
+            moved.push_back(node);
+        }
+        return;
+    }
+
+    // Children before the first changed one keep their places, unless the group moved or a
+    // change of width stretches them
+    const GuiLayoutSpec& spec = n.spec;
+    size_t count = n.children.size();
+    size_t from = std::min<size_t>(n.firstDirty, count);
+    n.firstDirty = NoNode;
+    bool stretches = spec.type == GuiLayoutType::Column || spec.type == GuiLayoutType::Grid;
+    if (repositioned || (widened && stretches)) {
+        from = 0;
+    }
+    if (from >= count) {
+        return;
+    }
+
+    ofRectangle content(box.x + spec.padding, box.y + spec.padding, box.width - 2 * spec.padding, box.height - 2 * spec.padding);
+    switch (spec.type) {
+    case GuiLayoutType::Column: {
+        float y = from == 0 ? content.y : nodes[n.children[from - 1]].rect.getBottom() + spec.gap;
+        for (size_t i = from; i < count; i++) {
+            uint32_t child = n.children[i];
+            const Node& c = nodes[child];
+            float width = c.fixedSize & GuiFixedWidth ? c.width : content.width;
+            float height = c.height;
+            place(child, ofRectangle(content.x, y, width, height));
+            y += height + spec.gap;
+        }
+        break;
+    }
+    case GuiLayoutType::Row: {
+        float x = from == 0 ? content.x : nodes[n.children[from - 1]].rect.getRight() + spec.gap;
+        for (size_t i = from; i < count; i++) {
+            uint32_t child = n.children[i];
+            float width = nodes[child].width;
+            place(child, ofRectangle(x, content.y, width, nodes[child].height));
+            x += width + spec.gap;
+        }
+        break;
+    }
+    case GuiLayoutType::Grid: {
+        size_t columns = std::max(spec.columns, 1u);
+        float cellWidth = std::max((content.width - spec.gap * (columns - 1)) / columns, 0.f);
+        auto rowHeight = [&](size_t start) {
+            float height = 0;
+            for (size_t i = start; i < std::min(start + columns, count); i++) {
+                height = std::max(height, nodes[n.children[i]].height);
+            }
+            return height;
+        };
+        size_t start = from - from % columns;  // A changed cell can change the height of its row
+        float y = content.y;
+        if (start > 0) {
+            size_t previous = start - columns;
+            y = nodes[n.children[previous]].rect.y + rowHeight(previous) + spec.gap;
+        }
+        for (; start < count; start += columns) {
+            for (size_t i = start; i < std::min(start + columns, count); i++) {
+                uint32_t child = n.children[i];
+                const Node& c = nodes[child];
+                float width = c.fixedSize & GuiFixedWidth ? c.width : cellWidth;
+                place(child, ofRectangle(content.x + (i - start) * (cellWidth + spec.gap), y, width, c.height));
+            }
+            y += rowHeight(start) + spec.gap;
+        }
+        break;
+    }
+    default:
+        for (size_t i = from; i < count; i++) {
+            place(n.children[i], positionedBox(n.children[i]));
+        }
+        break;
+    }
+}
@@ -0,0 +1,278 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonLayout.h
+
+    @brief    This file defines GuiLayout, the layout pass of ofxGuiJson. Panels
+              and groups with a "layout" place their elements in columns, rows
+              or grids. The size of each node is measured once and cached; when
+              a label changes or an element is added or removed, only the nodes
+              whose size changed are measured again and only the subtree they
+              affect is placed again.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxGuiJsonModel.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*!
+ *  @struct GuiLayoutStats
+ *  @brief Work done by the last GuiLayout::update().
+ */
+struct GuiLayoutStats {
+    size_t measured = 0;    //!< Nodes whose size was computed.
+    size_t placed = 0;      //!< Nodes whose position was computed.
+    size_t moved = 0;       //!< Items whose rect changed.
+};
+
+/*!
+ *  @class GuiLayout
+ *  @brief A tree of groups and items. Items are leaves with a content size given by the caller,
+ *         groups place their children by their GuiLayoutSpec.
+ *
+ *  In a column, children without a fixed width take the width of the column; in a grid they take
+ *  the width of a cell. A group without a layout places each child at its own position. A group
+ *  without a fixed size is as large as its children and padding.
+ */
+class GuiLayout {
+public:
+    /*!
+     *  @brief Index used for no node.
+     */
+    static constexpr uint32_t NoNode = UINT32_MAX;
+
+    /*!
+     *  @brief Advance of a character of the ofxGui bitmap font.
+     */
+    static constexpr float CharWidth = 8;
+
+    /*!
+     *  @brief Space on each side of the text of an element.
+     */
+    static constexpr float TextPadding = 4;
+
+    /*!
+     *  @brief Returns the width of a text in the ofxGui bitmap font.
+     *  @param text The UTF-8 text.
+     */
+    static float measureText(const std::string& text);
+
+    /*!
+     *  @brief Returns the natural width of an element: its text for labels, toggles and buttons,
+     *         and at least the default element width for the others.
+     *  @param type The element type.
+     *  @param label The label of the element.
+     */
+    static float measureElementWidth(GuiElementType type, const std::string& label);
+
+    /*!
+     *  @brief Converts the box of an element in the layout into its rect in the model. The box of
+     *         a virtual list holds all its visible rows, its rect the height of one row.
+     *  @param model The model.
+     *  @param index The index of the element.
+     *  @param box The box of the element.
+     */
+    static ofRectangle toElementRect(const GuiModel& model, size_t index, const ofRectangle& box);
+
+    /*!
+     *  @brief Lays out the elements of a panel with a layout or groups, writing their rects into
+     *         the model. Panels without either are left as they are.
+     *  @param model The model.
+     *  @param panel The index of the panel.
+     */
+    static void layoutPanel(GuiModel& model, size_t panel);
+
+    /*!
+     *  @brief Replaces the tree with the panels of a model that have a layout or groups, and lays
+     *         it out. Their elements are items whose slot is their index in the model.
+     *  @param model The model, laid out by layoutPanel() when it was compiled.
+     */
+    void build(const GuiModel& model);
+
+    /*!
+     *  @brief Returns the item of an element of the model passed to build().
+     *  @param id The interned ID of the element, see GuiModel::findId().
+     *  @return The item, or NoNode if the element is not in a layout.
+     */
+    uint32_t findElement(uint32_t id) const;
+
+    /*!
+     *  @brief Adds a group.
+     *  @param parent The parent group, NoNode for a root placed at the position of rect.
+     *  @param spec How the group places its children.
+     *  @param rect The position, used when the parent has no layout, and the fixed size.
+     *  @param fixedSize GuiFixedSize flags of the dimensions of rect that are fixed.
+     *  @return The group.
+     */
+    uint32_t addGroup(uint32_t parent, const GuiLayoutSpec& spec, const ofRectangle& rect, uint8_t fixedSize);
+
+    /*!
+     *  @brief Adds an item after the last child of a group.
+     *  @param parent The group.
+     *  @param rect The position, used when the parent has no layout, and the fixed size.
+     *  @param fixedSize GuiFixedSize flags of the dimensions of rect that are fixed.
+     *  @param width The width of the content, used when the width is not fixed.
+     *  @param height The height of the content, used when the height is not fixed.
+     *  @param slot A value of the caller, e.g. the index of the element, returned by getSlot().
+     *  @return The item.
+     */
+    uint32_t addItem(uint32_t parent, const ofRectangle& rect, uint8_t fixedSize, float width, float height, uint32_t slot);
+
+    /*!
+     *  @brief Removes a node and its children. The siblings after it move up on the next update().
+     *  @param node The node.
+     */
+    void remove(uint32_t node);
+
+    /*!
+     *  @brief Sets the width of the content of an item, e.g. after its label changed.
+     *  @param node The item.
+     *  @param width The width of the content.
+     */
+    void setContentWidth(uint32_t node, float width);
+
+    /*!
+     *  @brief Sets the slot of an item.
+     *  @param node The item.
+     *  @param slot The value returned by getSlot().
+     */
+    void setSlot(uint32_t node, uint32_t slot) { nodes[node].slot = slot; }
+
+    /*!
+     *  @brief Measures the nodes changed since the last update and places the subtrees they affect.
+     *  @return True if an item moved or was resized, see getMoved().
+     */
+    bool update();
+
+    /*!
+     *  @brief Returns the box of a node after the last update().
+     *  @param node The node.
+     */
+    const ofRectangle& getRect(uint32_t node) const { return nodes[node].rect; }
+
+    /*!
+     *  @brief Returns the slot of an item.
+     *  @param node The item.
+     */
+    uint32_t getSlot(uint32_t node) const { return nodes[node].slot; }
+
+    /*!
+     *  @brief Returns the items placed or resized by the last update().
+     */
+    const std::vector<uint32_t>& getMoved() const { return moved; }
+
+    /*!
+     *  @brief Returns the work done by the last update().
+     */
+    const GuiLayoutStats& getStats() const { return stats; }
+
+    /*!
+     *  @brief Removes every node.
+     */
+    void clear();
+
+private:
+    /*!
+     *  @struct Node
+     *  @brief A group or an item.
+     */
+    struct Node {
+        uint32_t parent = NoNode;           //!< The parent group, NoNode for roots.
+        uint32_t position = 0;              //!< Index in the children of the parent.
+        uint32_t slot = NoNode;             //!< Value of the caller, items only.
+        uint32_t firstDirty = NoNode;       //!< First child to place again, groups only.
+        bool isGroup = false;               //!< Whether the node is a group.
+        bool live = false;                  //!< Whether the node is in the tree, removed nodes are reused.
+        bool queued = false;                //!< Whether the node is in pending.
+        bool placed = false;                //!< Whether rect was computed.
+        uint8_t fixedSize = 0;              //!< GuiFixedSize flags of given.
+        GuiLayoutSpec spec;                 //!< How a group places its children.
+        ofRectangle given;                  //!< Position and fixed size.
+        float contentWidth = 0;             //!< Width of the content of an item.
+        float contentHeight = 0;            //!< Height of the content of an item.
+        float width = 0;                    //!< Cached measured width.
+        float height = 0;                   //!< Cached measured height.
+        ofRectangle rect;                   //!< The placed box.
+        std::vector<uint32_t> children;     //!< Children of a group, in layout order.
+    };
+
+    /*!
+     *  @brief Adds a root for a panel of a model, with its groups and elements in layout order.
+     *  @param model The model.
+     *  @param panel The index of the panel.
+     */
+    void addPanel(const GuiModel& model, size_t panel);
+
+    /*!
+     *  @brief Measures and places every node, for a tree built in one go.
+     */
+    void layoutAll();
+
+    /*!
+     *  @brief Allocates a node, reusing a removed one.
+     */
+    uint32_t allocate();
+
+    /*!
+     *  @brief Queues a node to be measured on the next update().
+     */
+    void queue(uint32_t node);
+
+    /*!
+     *  @brief Computes the size of a node from its content or its children, which must be measured.
+     *  @return True if the size changed.
+     */
+    bool measure(uint32_t node);
+
+    /*!
+     *  @brief Measures a node and its subtree, children first.
+     */
+    void measureAll(uint32_t node);
+
+    /*!
+     *  @brief Measures a changed node and its ancestors until one keeps its size, collecting the
+     *         groups whose children must be placed again.
+     */
+    void propagate(uint32_t node, std::vector<uint32_t>& roots);
+
+    /*!
+     *  @brief Returns the box of a node whose parent has no layout, or of a root.
+     */
+    ofRectangle positionedBox(uint32_t node) const;
+
+    /*!
+     *  @brief Places a node in a box, and the children of a group from the first that may have moved.
+     */
+    void arrange(uint32_t node, const ofRectangle& box);
+
+    /*!
+     *  @brief Places a child unless its box and children are unchanged.
+     */
+    void place(uint32_t node, const ofRectangle& box);
+
+    /*!
+     *  @brief Frees a node and its subtree.
+     */
+    void release(uint32_t node);
+
+    std::vector<Node> nodes;                            //!< All nodes, removed ones included.
+    std::vector<uint32_t> freeNodes;                    //!< Removed nodes.
+    std::vector<uint32_t> roots;                        //!< Nodes without a parent.
+    std::vector<uint32_t> pending;                      //!< Nodes changed since the last update().
+    std::vector<uint32_t> moved;                        //!< Items placed or resized by the last update().
+    std::unordered_map<uint32_t, uint32_t> idNodes;     //!< Item of each model element ID, filled by build().
+    GuiLayoutStats stats;                               //!< Work done by the last update().
+};
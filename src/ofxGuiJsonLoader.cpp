@@ -0,0 +1,655 @@
+#include "ofxGuiJsonLoader.h"
+#include "ofxGuiJsonId.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    double millisSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    length = static_cast<size_t>(fileSize.QuadPart);
+    if (length == 0) {
+        return true;
+    }
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingHandle) {
+        close();
+        return false;
+    }
+    bytes = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (!bytes) {
+        close();
+        return false;
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(fd);
+            length = 0;
+            return false;
+        }
+        bytes = static_cast<const char*>(mapped);
+    }
+    ::close(fd);  // The mapping stays valid after the descriptor is closed
+#endif
+    return true;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (bytes) {
+        UnmapViewOfFile(bytes);
+    }
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle) {
+        CloseHandle(fileHandle);
+    }
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    if (bytes) {
+        munmap(const_cast<char*>(bytes), length);
+    }
+#endif
+    bytes = nullptr;
+    length = 0;
+}
+
+void GuiCborEncoder::key(const std::string& key) {
+    // A text string head: major type 3 and the length in the smallest width that holds it
+    uint64_t length = key.size();
+    if (length < 24) {
+        out.push_back(static_cast<uint8_t>(0x60 | length));
+    }
+    else {
+        int bytes = length <= UINT8_MAX ? 1 : length <= UINT16_MAX ? 2 : length <= UINT32_MAX ? 4 : 8;
+        out.push_back(static_cast<uint8_t>(bytes == 1 ? 0x78 : bytes == 2 ? 0x79 : bytes == 4 ? 0x7A : 0x7B));
+        for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<uint8_t>(length >> shift));
+        }
+    }
+    out.insert(out.end(), key.begin(), key.end());
+}
+
+void GuiCborEncoder::value(const json& value) {
+    json::to_cbor(value, out);
+}
+
+GuiModelSaxHandler::GuiModelSaxHandler(GuiModel& target, GuiSchemaValidator* schemaValidator, GuiCborEncoder* cacheEncoder) :
+    model(target), validator(schemaValidator), encoder(cacheEncoder) {
+    model.clear();
+}
+
+bool GuiModelSaxHandler::null() {
+    scalar(json());
+    return true;
+}
+
+bool GuiModelSaxHandler::boolean(bool val) {
+    scalar(json(val));
+    return true;
+}
+
+bool GuiModelSaxHandler::number_integer(json::number_integer_t val) {
+    scalar(json(val));
+    return true;
+}
+
+bool GuiModelSaxHandler::number_unsigned(json::number_unsigned_t val) {
+    scalar(json(val));
+    return true;
+}
+
+bool GuiModelSaxHandler::number_float(json::number_float_t val, const json::string_t&) {
+    scalar(json(val));
+    return true;
+}
+
+bool GuiModelSaxHandler::string(json::string_t& val) {
+    scalar(json(std::move(val)));
+    return true;
+}
+
+bool GuiModelSaxHandler::start_object(std::size_t) {
+    if (validator) {
+        validator->beginObject();
+    }
+    if (encoder) {
+        encoder->beginObject();
+    }
+    Scope scope = childScope(false);
+    switch (scope) {
+    case Scope::Panel:
+        model.beginPanel(GuiPanelModel());
+        break;
+    case Scope::PanelGui:
+        model.panels.back().valid = true;
+        break;
+    case Scope::Element:
+        elements.emplace_back();
+        break;
+    default:
+        break;
+    }
+    scopes.push_back(scope);
+    currentKey.clear();
+    return true;
+}
+
+bool GuiModelSaxHandler::key(json::string_t& val) {
+    if (validator) {
+        validator->key(val);
+    }
+    if (encoder) {
+        encoder->key(val);
+    }
+    currentKey = std::move(val);
+    return true;
+}
+
+bool GuiModelSaxHandler::end_object() {
+    if (validator) {
+        validator->endObject();
+    }
+    if (encoder) {
+        encoder->end();
+    }
+    Scope scope = scopes.back();
+    scopes.pop_back();
+    if (scope == Scope::Panel) {
+        model.endPanel();
+    }
+    else if (scope == Scope::Element) {
+        GuiElementDesc& element = elements.back();
+        if (element.isGroup) {
+            model.endGroup(element);
+        }
+        else if (element.type == "group") {
+            model.beginGroup();  // A group without "elements"
+            model.endGroup(element);
+        }
+        else {
+            model.addElement(element);
+        }
+        elements.pop_back();
+    }
+    return true;
+}
+
+bool GuiModelSaxHandler::start_array(std::size_t) {
+    if (validator) {
+        validator->beginArray();
+    }
+    if (encoder) {
+        encoder->beginArray();
+    }
+    Scope scope = childScope(true);
+    if (scope == Scope::Panels) {
+        hasPanels = true;
+    }
+    else if (scope == Scope::Elements && scopes.back() == Scope::Element) {
+        elements.back().isGroup = true;  // Its elements follow, so the group starts now
+        model.beginGroup();
+    }
+    else if (scope == Scope::BackgroundColor) {
+        backgroundColor.clear();
+    }
+    scopes.push_back(scope);
+    return true;
+}
+
+bool GuiModelSaxHandler::end_array() {
+    if (validator) {
+        validator->endArray();
+    }
+    if (encoder) {
+        encoder->end();
+    }
+    Scope scope = scopes.back();
+    scopes.pop_back();
+    if (scope == Scope::BackgroundColor) {
+        model.compileBackgroundColor(json(backgroundColor));
+    }
+    return true;
+}
+
+bool GuiModelSaxHandler::parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception& ex) {
+    error = "JSON parse error at byte " + std::to_string(position) + ": " + ex.what();
+    return false;
+}
+
+GuiModelSaxHandler::Scope GuiModelSaxHandler::childScope(bool isArray) const {
+    if (scopes.empty()) {
+        return isArray ? Scope::Skip : Scope::Root;
+    }
+    switch (scopes.back()) {
+    case Scope::Root:
+        if (isArray && currentKey == "panels") return Scope::Panels;
+        if (isArray && currentKey == "background_color") return Scope::BackgroundColor;
+        if (!isArray && currentKey == "audio_settings") return Scope::Audio;
+        if (!isArray && currentKey == "interaction") return Scope::Interaction;
+        if (!isArray && currentKey == "profiler") return Scope::Profiler;
+        break;
+    case Scope::Profiler:
+        if (!isArray && currentKey == "position") return Scope::ProfilerPosition;
+        break;
+    case Scope::Panels:
+        if (!isArray) return Scope::Panel;
+        break;
+    case Scope::Panel:
+        if (!isArray && currentKey == "gui") return Scope::PanelGui;
+        if (isArray && currentKey == "elements") return Scope::Elements;
+        break;
+    case Scope::PanelGui:
+        if (!isArray && currentKey == "position") return Scope::PanelGuiPosition;
+        break;
+    case Scope::Elements:
+        if (!isArray) return Scope::Element;
+        break;
+    case Scope::Element:
+        if (!isArray && currentKey == "position") return Scope::ElementPosition;
+        if (!isArray && currentKey == "size") return Scope::ElementSize;
+        if (isArray && currentKey == "options") return Scope::ElementOptions;
+        if (isArray && currentKey == "bind") return Scope::ElementBind;
+        if (isArray && currentKey == "elements") return Scope::Elements;
+        break;
+    default:
+        break;
+    }
+    return Scope::Skip;
+}
+
+void GuiModelSaxHandler::scalar(const json& value) {
+    if (validator) {
+        validator->value(value);
+    }
+    if (encoder) {
+        encoder->value(value);
+    }
+    if (scopes.empty() || value.is_null()) {
+        return;
+    }
+    const std::string& k = currentKey;
+    switch (scopes.back()) {
+    case Scope::PanelGui: {
+        GuiPanelModel& panel = model.panels.back();
+        if (k == "title") assignJsonValue(panel.title, value, k);
+        else if (k == "settings_file") assignJsonValue(panel.settingsFile, value, k);
+        else if (k == "width") assignJsonValue(panel.width, value, k);
+        else if (k == "height") assignJsonValue(panel.height, value, k);
+        else readLayoutKey(panel.layout, k, value);
+        break;
+    }
+    case Scope::PanelGuiPosition: {
+        GuiPanelModel& panel = model.panels.back();
+        if (k == "x") assignJsonValue(panel.x, value, k);
+        else if (k == "y") assignJsonValue(panel.y, value, k);
+        break;
+    }
+    case Scope::Element:
+        readElementKey(elements.back(), GuiElementScope::Element, k, value);
+        break;
+    case Scope::ElementOptions:
+        readElementKey(elements.back(), GuiElementScope::Options, k, value);
+        break;
+    case Scope::ElementBind:
+        readElementKey(elements.back(), GuiElementScope::Bind, k, value);
+        break;
+    case Scope::ElementPosition:
+        readElementKey(elements.back(), GuiElementScope::Position, k, value);
+        break;
+    case Scope::ElementSize:
+        readElementKey(elements.back(), GuiElementScope::Size, k, value);
+        break;
+    case Scope::BackgroundColor:
+        backgroundColor.push_back(value);
+        break;
+    case Scope::Audio: {
+        GuiAudioSettings& audio = model.settings.audio;
+        if (k == "outputChannels") assignJsonValue(audio.outputChannels, value, k);
+        else if (k == "inputChannels") assignJsonValue(audio.inputChannels, value, k);
+        else if (k == "sampleRate") assignJsonValue(audio.sampleRate, value, k);
+        else if (k == "bufferSize") assignJsonValue(audio.bufferSize, value, k);
+        else if (k == "minFrequency") assignJsonValue(audio.minFrequency, value, k);
+        else if (k == "maxFrequency") assignJsonValue(audio.maxFrequency, value, k);
+        else if (k == "sensitivity") assignJsonValue(audio.sensitivity, value, k);
+        break;
+    }
+    case Scope::Interaction:
+        if (k == "enable") assignJsonValue(model.settings.interaction.enable, value, k);
+        else if (k == "type") assignJsonValue(model.settings.interaction.type, value, k);
+        break;
+    case Scope::Profiler: {
+        GuiProfilerSettings& profiler = model.settings.profiler;
+        if (k == "enable") assignJsonValue(profiler.enable, value, k);
+        else if (k == "overlay") assignJsonValue(profiler.overlay, value, k);
+        else if (k == "history_frames") assignJsonValue(profiler.historyFrames, value, k);
+        else if (k == "trace_file") assignJsonValue(profiler.traceFile, value, k);
+        break;
+    }
+    case Scope::ProfilerPosition:
+        if (k == "x") assignJsonValue(model.settings.profiler.x, value, k);
+        else if (k == "y") assignJsonValue(model.settings.profiler.y, value, k);
+        break;
+    default:
+        break;
+    }
+}
+
+bool GuiModelLoader::load(const std::string& path, GuiModel& model, json* config) {
+    auto start = std::chrono::steady_clock::now();
+    stats = GuiLoadStats();
+    validator.reset();
+    sourcePath = path;
+    dependencies.clear();
+
+    MappedFile file;
+    if (!file.open(path)) {
+        ofLogError() << "Failed to open JSON config file: " << path;
+        return false;
+    }
+    stats.fileBytes = file.size();
+    stats.mapMillis = millisSince(start);
+
+    static const char empty = '\0';
+    const char* first = file.size() > 0 ? file.data() : &empty;
+    const char* last = first + file.size();
+
+    uint64_t sourceHash = 0;
+    if (useCache) {
+        sourceHash = hashBytes(first, file.size());
+        auto cacheStart = std::chrono::steady_clock::now();
+        if (loadCache(cachePath(path), sourceHash, model, config)) {
+            stats.fromCache = true;
+            stats.parseMillis = millisSince(cacheStart);
+            stats.elementCount = model.size();
+            stats.totalMillis = millisSince(start);
+            return true;
+        }
+    }
+
+    auto parseStart = std::chrono::steady_clock::now();
+    bool loaded = false;
+    bool composed = GuiConfigComposer::usesComposition(first, file.size());
+    // A cache is trusted without checking it again, so only validated configurations are cached
+    bool cacheable = useCache && validate;
+    if (config || composed) {
+        // Retained or composed config: build the DOM once, it is encoded into the new cache
+        json local;
+        json& dom = config ? *config : local;
+        loaded = parseDom(first, last, dom, composed) && model.compile(dom);
+        if (!loaded) {
+            model.clear();
+        }
+        else if (cacheable) {
+            writeCache(cachePath(path), sourceHash, json::to_cbor(dom), dependencies);
+        }
+    }
+    else {
+        // The cache is encoded from the same events that compile the model
+        std::vector<uint8_t> payload;
+        GuiCborEncoder encoder(payload);
+        GuiModelSaxHandler handler(model, validate ? &validator : nullptr, cacheable ? &encoder : nullptr);
+        if (!json::sax_parse(first, last, &handler)) {
+            ofLogError() << handler.getError();
+            model.clear();
+        }
+        else if (!validator.isValid()) {
+            validator.logErrors(path);
+            model.clear();
+        }
+        else if (!handler.foundPanels()) {
+            ofLogError() << "Invalid or missing 'panels' configuration.";
+        }
+        else {
+            loaded = true;
+            if (cacheable) {
+                writeCache(cachePath(path), sourceHash, payload, dependencies);
+            }
+        }
+    }
+    stats.parseMillis = millisSince(parseStart);
+    stats.elementCount = model.size();
+    stats.totalMillis = millisSince(start);
+    return loaded;
+}
+
+bool GuiModelLoader::parseDom(const char* first, const char* last, json& dom, bool composed) {
+    if (composed) {
+        // Composition keys are not part of the schema, the expanded configuration is validated instead
+        json source;
+        try {
+            source = json::parse(first, last);
+        }
+        catch (const nlohmann::json::parse_error& e) {
+            ofLogError() << "JSON parse error at byte " << e.byte << ": " << e.what();
+            return false;
+        }
+        GuiConfigComposer composer(sourcePath, includeCache);
+        bool expanded = composer.expand(source, dom);
+        dependencies = composer.getDependencies();
+        stats.includeFiles = dependencies.size();
+        stats.includesParsed = composer.getParsedIncludes();
+        if (!expanded) {
+            return false;
+        }
+        if (validate && !validator.validate(dom)) {
+            validator.logErrors(sourcePath);
+            return false;
+        }
+        return true;
+    }
+    try {
+        if (!validate) {
+            dom = json::parse(first, last);
+            return true;
+        }
+        // The parser reports every event to the callback, so the DOM is validated while it is built
+        dom = json::parse(first, last, [this](int, json::parse_event_t event, json& parsed) {
+            switch (event) {
+            case json::parse_event_t::object_start: validator.beginObject(); break;
+            case json::parse_event_t::key: validator.key(parsed.get_ref<const std::string&>()); break;
+            case json::parse_event_t::object_end: validator.endObject(); break;
+            case json::parse_event_t::array_start: validator.beginArray(); break;
+            case json::parse_event_t::array_end: validator.endArray(); break;
+            case json::parse_event_t::value: validator.value(parsed); break;
+            }
+            return true;
+        });
+    }
+    catch (const nlohmann::json::parse_error& e) {
+        ofLogError() << "JSON parse error at byte " << e.byte << ": " << e.what();
+        return false;
+    }
+    if (!validator.isValid()) {
+        validator.logErrors(sourcePath);
+        return false;
+    }
+    return true;
+}
+
+uint64_t GuiModelLoader::hashBytes(const char* bytes, size_t length) {
+    return guiHash(bytes, length);
+}
+
+bool GuiModelLoader::loadCache(const std::string& path, uint64_t sourceHash, GuiModel& model, json* config) {
+    MappedFile cache;
+    if (!cache.open(path)) {
+        return false;  // No cache yet
+    }
+
+    GuiCacheHeader expected;
+    GuiCacheHeader header;
+    if (cache.size() < sizeof(header)) {
+        ofLogWarning() << "Ignoring truncated config cache: " << path;
+        return false;
+    }
+    std::memcpy(&header, cache.data(), sizeof(header));
+    if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 || header.version != expected.version ||
+        header.dependencyBytes > cache.size() - sizeof(header) ||
+        header.payloadBytes != cache.size() - sizeof(header) - header.dependencyBytes) {
+        ofLogWarning() << "Ignoring config cache with an unknown format: " << path;
+        return false;
+    }
+    if (header.sourceHash != sourceHash) {
+        ofLogNotice() << "Config changed since its cache was built, parsing the text.";
+        return false;
+    }
+
+    // Each included file must still hash as it did when the cache was built
+    const char* record = cache.data() + sizeof(header);
+    const char* recordsEnd = record + header.dependencyBytes;
+    std::vector<GuiDependency> cachedDependencies;
+    while (record < recordsEnd) {
+        uint64_t hash;
+        uint32_t pathLength;
+        if (static_cast<size_t>(recordsEnd - record) < sizeof(hash) + sizeof(pathLength)) {
+            ofLogWarning() << "Ignoring truncated config cache: " << path;
+            return false;
+        }
+        std::memcpy(&hash, record, sizeof(hash));
+        std::memcpy(&pathLength, record + sizeof(hash), sizeof(pathLength));
+        record += sizeof(hash) + sizeof(pathLength);
+        if (static_cast<size_t>(recordsEnd - record) < pathLength) {
+            ofLogWarning() << "Ignoring truncated config cache: " << path;
+            return false;
+        }
+        GuiDependency dependency{ std::string(record, pathLength), hash };
+        record += pathLength;
+
+        MappedFile included;
+        static const char empty = '\0';
+        if (!included.open(dependency.path) || hashBytes(included.size() > 0 ? included.data() : &empty, included.size()) != hash) {
+            ofLogNotice() << "Included file changed since the cache was built, parsing the text: " << dependency.path;
+            return false;
+        }
+        cachedDependencies.push_back(std::move(dependency));
+    }
+    dependencies = std::move(cachedDependencies);
+    stats.includeFiles = dependencies.size();
+
+    // The payload is decoded straight from the mapping
+    const uint8_t* first = reinterpret_cast<const uint8_t*>(recordsEnd);
+    const uint8_t* last = first + header.payloadBytes;
+    if (config) {
+        try {
+            *config = json::from_cbor(first, last);
+        }
+        catch (const json::exception& e) {
+            ofLogWarning() << "Ignoring unreadable config cache: " << e.what();
+            model.clear();
+            return false;
+        }
+        return model.compile(*config);
+    }
+
+    GuiModelSaxHandler handler(model);
+    if (!json::sax_parse(first, last, &handler, json::input_format_t::cbor) || !handler.foundPanels()) {
+        ofLogWarning() << "Ignoring unreadable config cache: " << handler.getError();
+        model.clear();
+        return false;
+    }
+    return true;
+}
+
+bool GuiModelLoader::writeCache(const std::string& path, uint64_t sourceHash, const std::vector<uint8_t>& payload,
+    const std::vector<GuiDependency>& dependencies) {
+    std::string records;
+    for (const auto& dependency : dependencies) {
+        uint32_t pathLength = static_cast<uint32_t>(dependency.path.size());
+        records.append(reinterpret_cast<const char*>(&dependency.hash), sizeof(dependency.hash));
+        records.append(reinterpret_cast<const char*>(&pathLength), sizeof(pathLength));
+        records.append(dependency.path);
+    }
+    GuiCacheHeader header;
+    header.sourceHash = sourceHash;
+    header.payloadBytes = payload.size();
+    header.dependencyBytes = records.size();
+
+    // Write next to the cache and rename, so a reader never sees a partial file
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(records.data(), records.size());
+        out.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+        if (!out) {
+            ofLogWarning() << "Could not write config cache: " << tempPath;
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        ofLogWarning() << "Could not write config cache: " << path << " (" << error.message() << ")";
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool GuiModelLoader::precompile(const std::string& path) {
+    MappedFile file;
+    if (!file.open(path)) {
+        ofLogError() << "Failed to open JSON config file: " << path;
+        return false;
+    }
+    static const char empty = '\0';
+    const char* first = file.size() > 0 ? file.data() : &empty;
+
+    json config;
+    GuiModel model;
+    GuiModelLoader loader;
+    loader.sourcePath = path;
+    bool composed = GuiConfigComposer::usesComposition(first, file.size());
+    if (!loader.parseDom(first, first + file.size(), config, composed) || !model.compile(config)) {
+        return false;
+    }
+    return writeCache(cachePath(path), hashBytes(first, file.size()), json::to_cbor(config), loader.dependencies);
+}
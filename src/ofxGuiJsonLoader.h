@@ -0,0 +1,329 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonLoader.h
+
+    @brief    This file defines the streaming configuration loader. The file is
+              memory mapped and parsed with the nlohmann SAX interface, emitting
+              element descriptors straight into a GuiModel without building a
+              JSON DOM first.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include "ofxGuiJsonModel.h"
+#include "ofxGuiJsonSchema.h"
+#include "ofxGuiJsonCompose.h"
+#include <json.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+/*!
+ *  @struct GuiLoadStats
+ *  @brief Timings and sizes of the last configuration load.
+ */
+struct GuiLoadStats {
+    size_t fileBytes = 0;       //!< Size of the configuration file.
+    size_t elementCount = 0;    //!< Number of elements compiled into the model.
+    double mapMillis = 0;       //!< Time spent opening and mapping the file.
+    double parseMillis = 0;     //!< Time spent parsing and compiling the model.
+    double totalMillis = 0;     //!< Total load time.
+    bool fromCache = false;     //!< Whether the model was loaded from the binary cache.
+    size_t includeFiles = 0;    //!< Number of files included by the configuration.
+    size_t includesParsed = 0;  //!< Number of included files parsed, the others came from the include cache.
+};
+
+/*!
+ *  @struct GuiCacheHeader
+ *  @brief Header of a binary cache file. The included files follow it, each a uint64_t hash, a uint32_t
+ *         path length and the path, then the CBOR encoding of the expanded configuration.
+ */
+struct GuiCacheHeader {
+    char magic[4] = { 'G', 'J', 'C', 'B' };    //!< Identifies a cache file.
+    uint32_t version = 4;                       //!< Layout version, bumped when the cache format or its validation changes.
+    uint64_t sourceHash = 0;                    //!< FNV-1a hash of the configuration text the cache was built from.
+    uint64_t payloadBytes = 0;                  //!< Size of the CBOR payload.
+    uint64_t dependencyBytes = 0;               //!< Size of the included file records.
+};
+
+/*!
+ *  @class MappedFile
+ *  @brief Read-only memory mapping of a file.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /*!
+     *  @brief Maps a file into memory, unmapping any previous file.
+     *  @param path The path to the file.
+     *  @return True if the file was opened. An empty file opens with size() == 0.
+     */
+    bool open(const std::string& path);
+
+    /*!
+     *  @brief Unmaps the file.
+     */
+    void close();
+
+    /*!
+     *  @brief Returns a pointer to the first byte of the file.
+     */
+    const char* data() const { return bytes; }
+
+    /*!
+     *  @brief Returns the size of the file in bytes.
+     */
+    size_t size() const { return length; }
+
+private:
+    const char* bytes = nullptr;    //!< The mapped bytes.
+    size_t length = 0;              //!< The number of mapped bytes.
+#ifdef _WIN32
+    void* fileHandle = nullptr;     //!< Handle of the open file.
+    void* mappingHandle = nullptr;  //!< Handle of the file mapping.
+#endif
+};
+
+/*!
+ *  @class GuiCborEncoder
+ *  @brief Encodes parse events into CBOR as they arrive, with indefinite length objects and arrays,
+ *         so the binary cache is written without building a JSON DOM.
+ */
+class GuiCborEncoder {
+public:
+    /*!
+     *  @brief Creates an encoder appending to a buffer.
+     *  @param buffer The buffer.
+     */
+    explicit GuiCborEncoder(std::vector<uint8_t>& buffer) : out(buffer) {}
+
+    void beginObject() { out.push_back(0xBF); }
+    void beginArray() { out.push_back(0x9F); }
+    void end() { out.push_back(0xFF); }
+    void key(const std::string& key);
+    void value(const json& value);
+
+private:
+    std::vector<uint8_t>& out;      //!< The encoded bytes.
+};
+
+/*!
+ *  @class GuiModelSaxHandler
+ *  @brief nlohmann SAX handler that compiles the configuration into a GuiModel as it is parsed.
+ *
+ *  Only the keys understood by GuiModel are kept; every other subtree is skipped without
+ *  being materialized. With a validator, every event is also checked against the schema in
+ *  the same pass, and with an encoder the whole configuration is encoded for the binary cache.
+ */
+class GuiModelSaxHandler {
+public:
+    /*!
+     *  @brief Creates a handler writing into a model. The model is cleared.
+     *  @param target The model to fill.
+     *  @param schemaValidator If not null, receives every parse event to check the configuration.
+     *  @param cacheEncoder If not null, receives every parse event to encode the configuration.
+     */
+    explicit GuiModelSaxHandler(GuiModel& target, GuiSchemaValidator* schemaValidator = nullptr, GuiCborEncoder* cacheEncoder = nullptr);
+
+    /*!
+     *  @brief Returns true if a 'panels' array was found.
+     */
+    bool foundPanels() const { return hasPanels; }
+
+    /*!
+     *  @brief Returns the parse error message, empty if parsing succeeded.
+     */
+    const std::string& getError() const { return error; }
+
+    // nlohmann::json_sax interface
+    bool null();
+    bool boolean(bool val);
+    bool number_integer(json::number_integer_t val);
+    bool number_unsigned(json::number_unsigned_t val);
+    bool number_float(json::number_float_t val, const json::string_t& s);
+    bool string(json::string_t& val);
+    template<typename Binary> bool binary(Binary&) { return true; }
+    bool start_object(std::size_t elements);
+    bool key(json::string_t& val);
+    bool end_object();
+    bool start_array(std::size_t elements);
+    bool end_array();
+    bool parse_error(std::size_t position, const std::string& lastToken, const nlohmann::detail::exception& ex);
+
+private:
+    /*!
+     *  @brief The part of the configuration the parser is currently in.
+     */
+    enum class Scope {
+        Skip,
+        Root,
+        Panels,
+        Panel,
+        PanelGui,
+        PanelGuiPosition,
+        Elements,
+        Element,
+        ElementPosition,
+        ElementSize,
+        ElementOptions,
+        ElementBind,
+        BackgroundColor,
+        Audio,
+        Interaction,
+        Profiler,
+        ProfilerPosition
+    };
+
+    /*!
+     *  @brief Handles a scalar value in the current scope.
+     *  @param value The value.
+     */
+    void scalar(const json& value);
+
+    /*!
+     *  @brief Returns the scope entered by an object or array opened in the current scope.
+     *  @param isArray True for arrays, false for objects.
+     */
+    Scope childScope(bool isArray) const;
+
+    GuiModel& model;                    //!< The model being filled.
+    GuiSchemaValidator* validator;      //!< The validator fed with the events, may be null.
+    GuiCborEncoder* encoder;            //!< The encoder fed with the events, may be null.
+    std::vector<Scope> scopes;          //!< Stack of open scopes.
+    std::string currentKey;             //!< The last key read in the current object.
+    std::vector<GuiElementDesc> elements;   //!< The element being read, after the groups enclosing it.
+    std::vector<json> backgroundColor;  //!< Values of the 'background_color' array.
+    bool hasPanels = false;             //!< Whether a 'panels' array was found.
+    std::string error;                  //!< The parse error, if any.
+};
+
+/*!
+ *  @class GuiModelLoader
+ *  @brief Loads a configuration file into a GuiModel through a memory mapping and the SAX handler.
+ */
+class GuiModelLoader {
+public:
+    /*!
+     *  @brief Loads and compiles a configuration file.
+     *  @param path The full path to the configuration file.
+     *  @param model The model to fill.
+     *  @param config If not null, the JSON DOM is also built into this value for callers that need it.
+     *  @return True if the file was read and contained a 'panels' array.
+     */
+    bool load(const std::string& path, GuiModel& model, json* config = nullptr);
+
+    /*!
+     *  @brief Enables the binary cache. When enabled, load() reads the cache next to the configuration
+     *         if it was built from the same text and included files, and writes it after parsing the text otherwise.
+     *  @param enable True to use the cache.
+     */
+    void setUseCache(bool enable) { useCache = enable; }
+
+    /*!
+     *  @brief Enables checking the configuration against GuiSchema::builtin() while it is parsed.
+     *         A configuration with errors does not load, and every error is logged with its JSON
+     *         pointer. Caches are only written while validating and for valid configurations, so
+     *         loads from the cache are not checked again. On by default.
+     *  @param enable True to validate.
+     */
+    void setValidate(bool enable) { validate = enable; }
+
+    /*!
+     *  @brief Sets the cache of parsed include files, kept by the caller across loads so that a
+     *         reload parses only the included files that changed.
+     *  @param cache The cache, null to parse every included file.
+     */
+    void setIncludeCache(GuiIncludeCache* cache) { includeCache = cache; }
+
+    /*!
+     *  @brief Returns the files included by the configuration of the last load.
+     */
+    const std::vector<GuiDependency>& getDependencies() const { return dependencies; }
+
+    /*!
+     *  @brief Returns the schema errors of the last load, empty if it was valid or not validated.
+     */
+    const std::vector<GuiSchemaError>& getSchemaErrors() const { return validator.getErrors(); }
+
+    /*!
+     *  @brief Checks a configuration file against the schema and writes its binary cache. Used by the precompile tool.
+     *  @param path The full path to the configuration file.
+     *  @return True if the configuration is valid and the cache was written.
+     */
+    static bool precompile(const std::string& path);
+
+    /*!
+     *  @brief Returns the path of the binary cache of a configuration file.
+     *  @param path The path to the configuration file.
+     */
+    static std::string cachePath(const std::string& path) { return path + ".cache"; }
+
+    /*!
+     *  @brief Hashes the text of a configuration.
+     *  @param bytes The text.
+     *  @param length The length of the text.
+     *  @return The 64-bit FNV-1a hash.
+     */
+    static uint64_t hashBytes(const char* bytes, size_t length);
+
+    /*!
+     *  @brief Returns the timings of the last load.
+     */
+    const GuiLoadStats& getStats() const { return stats; }
+
+private:
+    /*!
+     *  @brief Loads the model from the binary cache.
+     *  @param path The path to the cache file.
+     *  @param sourceHash The hash of the current configuration text.
+     *  @param model The model to fill.
+     *  @param config If not null, the JSON DOM is also decoded into this value.
+     *  @return True if the cache matched the hash and decoded into a valid model.
+     */
+    bool loadCache(const std::string& path, uint64_t sourceHash, GuiModel& model, json* config);
+
+    /*!
+     *  @brief Writes the binary cache of a configuration, replacing any previous one atomically.
+     *  @param path The path to the cache file.
+     *  @param sourceHash The hash of the configuration text.
+     *  @param payload The CBOR encoding of the parsed and expanded configuration.
+     *  @param dependencies The files included by the configuration.
+     *  @return True if the cache was written.
+     */
+    static bool writeCache(const std::string& path, uint64_t sourceHash, const std::vector<uint8_t>& payload,
+        const std::vector<GuiDependency>& dependencies);
+
+    /*!
+     *  @brief Parses a configuration into a DOM, feeding the validator in the same pass when validating.
+     *         A composed configuration is expanded first and the expansion is validated.
+     *  @param first The first byte of the text.
+     *  @param last One past the last byte of the text.
+     *  @param dom The parsed and expanded configuration.
+     *  @param composed True if the text uses composition keys, see GuiConfigComposer::usesComposition().
+     *  @return False if the text is not JSON, cannot be expanded or does not match the schema; the errors are logged.
+     */
+    bool parseDom(const char* first, const char* last, json& dom, bool composed);
+
+    GuiLoadStats stats;             //!< Timings of the last load.
+    bool useCache = false;          //!< Whether load() reads and writes the binary cache.
+    bool validate = true;           //!< Whether configurations are checked against the schema.
+    GuiSchemaValidator validator;   //!< Checks the configuration being parsed.
+    std::string sourcePath;         //!< The configuration being loaded, for error messages.
+    GuiIncludeCache* includeCache = nullptr;    //!< Parsed include files kept by the caller, may be null.
+    std::vector<GuiDependency> dependencies;    //!< Files included by the configuration of the last load.
+};
@@ -0,0 +1,429 @@
+#include "ofxGuiJsonModel.h"
+#include "ofxGuiJsonLayout.h"
+#include <algorithm>
+
+const json& readJsonChild(const json& node, const char* key) {
+    static const json nullNode;
+    if (!node.is_object()) {
+        return nullNode;
+    }
+    auto it = node.find(key);
+    return it != node.end() ? *it : nullNode;
+}
+
+GuiElementType parseElementType(const std::string& type) {
+    if (type == "toggle") return GuiElementType::Toggle;
+    if (type == "label") return GuiElementType::Label;
+    if (type == "virtual_list") return GuiElementType::VirtualList;
+    if (type == "slider") return GuiElementType::Slider;
+    if (type == "int_slider") return GuiElementType::IntSlider;
+    if (type == "button") return GuiElementType::Button;
+    if (type == "dropdown") return GuiElementType::Dropdown;
+    if (type == "float_field") return GuiElementType::FloatField;
+    if (type == "int_field") return GuiElementType::IntField;
+    return GuiElementType::Unknown;
+}
+
+GuiLayoutType parseLayoutType(const std::string& layout) {
+    if (layout == "column") return GuiLayoutType::Column;
+    if (layout == "row") return GuiLayoutType::Row;
+    if (layout == "grid") return GuiLayoutType::Grid;
+    return GuiLayoutType::None;
+}
+
+bool readLayoutKey(GuiLayoutSpec& spec, const std::string& key, const json& value) {
+    if (key == "layout") {
+        std::string layout;
+        assignJsonValue(layout, value, key);
+        spec.type = parseLayoutType(layout);
+        if (spec.type == GuiLayoutType::None) {
+            ofLogWarning() << "Unknown layout '" << layout << "', keeping element positions.";
+        }
+    }
+    else if (key == "gap") assignJsonValue(spec.gap, value, key);
+    else if (key == "padding") assignJsonValue(spec.padding, value, key);
+    else if (key == "columns") {
+        assignJsonValue(spec.columns, value, key);
+        spec.columns = std::max(spec.columns, 1u);
+    }
+    else return false;
+    return true;
+}
+
+bool readElementKey(GuiElementDesc& desc, GuiElementScope scope, const std::string& key, const json& value) {
+    if (value.is_null()) {
+        return true;
+    }
+    switch (scope) {
+    case GuiElementScope::Element:
+        if (key == "type") assignJsonValue(desc.type, value, key);
+        else if (key == "id") assignJsonValue(desc.id, value, key);
+        else if (key == "label") assignJsonValue(desc.label, value, key);
+        else if (key == "action") assignJsonValue(desc.action, value, key);
+        else if (key == "default") {
+            desc.defaultValue = readDefaultValue(value, 0);
+            if (value.is_string()) {
+                desc.defaultOption = value.get<std::string>();
+            }
+        }
+        else if (key == "audio_parameter") assignJsonValue(desc.audioParameter, value, key);
+        else if (key == "smoothing_ms") assignJsonValue(desc.smoothingMillis, value, key);
+        else if (key == "row_type") assignJsonValue(desc.rowType, value, key);
+        else if (key == "visible_rows") assignJsonValue(desc.visibleRows, value, key);
+        else if (key == "min") assignJsonValue(desc.minValue, value, key);
+        else if (key == "max") assignJsonValue(desc.maxValue, value, key);
+        else if (key == "max_rate") assignJsonValue(desc.maxRate, value, key);
+        else if (key == "bind") {
+            if (value.is_string()) {
+                desc.bind.assign(1, value.get<std::string>());
+            }
+            else {
+                ofLogWarning() << "Unexpected type for 'bind', expected a string or an array of strings.";
+            }
+        }
+        else if (key == "format") assignJsonValue(desc.format, value, key);
+        else return readLayoutKey(desc.layout, key, value);
+        return true;
+    case GuiElementScope::Position:
+        if (key == "x") assignJsonValue(desc.rect.x, value, key);
+        else if (key == "y") assignJsonValue(desc.rect.y, value, key);
+        else return false;
+        return true;
+    case GuiElementScope::Size:
+        // Only a number fixes the dimension, anything else leaves it to the layout
+        if (key == "width") {
+            assignJsonValue(desc.rect.width, value, key);
+            desc.fixedSize |= value.is_number() ? GuiFixedWidth : 0;
+        }
+        else if (key == "height") {
+            assignJsonValue(desc.rect.height, value, key);
+            desc.fixedSize |= value.is_number() ? GuiFixedHeight : 0;
+        }
+        else return false;
+        return true;
+    case GuiElementScope::Options:
+        if (value.is_string()) {
+            desc.options.push_back(value.get<std::string>());
+        }
+        else {
+            ofLogWarning() << "Unexpected type in 'options', expected strings.";
+        }
+        return true;
+    case GuiElementScope::Bind:
+        if (value.is_string()) {
+            desc.bind.push_back(value.get<std::string>());
+        }
+        else {
+            ofLogWarning() << "Unexpected type in 'bind', expected strings.";
+        }
+        return true;
+    }
+    return false;
+}
+
+float readDefaultValue(const json& value, float fallback) {
+    if (value.is_boolean()) {
+        return value.get<bool>() ? 1.f : 0.f;
+    }
+    if (value.is_number()) {
+        return value.get<float>();
+    }
+    if (!value.is_null() && !value.is_string()) {
+        ofLogWarning() << "Unexpected type for 'default', using default value.";
+    }
+    return fallback;
+}
+
+bool GuiModel::compile(const json& config) {
+    clear();
+    compileSettings(config);
+
+    const json& panelsConfig = readJsonChild(config, "panels");
+    if (!panelsConfig.is_array()) {
+        ofLogError() << "Invalid or missing 'panels' configuration.";
+        return false;
+    }
+
+    panels.reserve(panelsConfig.size());
+    for (const auto& panelConfig : panelsConfig) {
+        compilePanel(panelConfig);
+    }
+    return true;
+}
+
+void GuiModel::clear() {
+    panels.clear();
+    types.clear();
+    ids.clear();
+    labels.clear();
+    actions.clear();
+    rects.clear();
+    defaults.clear();
+    panelIndices.clear();
+    audioParameters.clear();
+    smoothingMillis.clear();
+    rowTypes.clear();
+    visibleRows.clear();
+    mins.clear();
+    maxs.clear();
+    maxRates.clear();
+    options.clear();
+    binds.clear();
+    formats.clear();
+    fixedSizes.clear();
+    elementGroups.clear();
+    groups.clear();
+    currentGroup = GuiGroupModel::NoGroup;
+    idNames.clear();
+    idLookup.clear();
+    settings = GuiSettings();
+}
+
+uint32_t GuiModel::intern(const std::string& id) {
+    auto it = idLookup.find(id);
+    if (it != idLookup.end()) {
+        return it->second;
+    }
+    uint32_t index = static_cast<uint32_t>(idNames.size());
+    idNames.push_back(id);
+    idLookup.emplace(id, index);
+    return index;
+}
+
+uint32_t GuiModel::findId(const std::string& id) const {
+    auto it = idLookup.find(id);
+    return it != idLookup.end() ? it->second : NoId;
+}
+
+const std::string& GuiModel::idOf(size_t index) const {
+    static const std::string empty;
+    uint32_t id = ids[index];
+    return id != NoId ? idNames[id] : empty;
+}
+
+void GuiModel::beginPanel(const GuiPanelModel& panel) {
+    panels.push_back(panel);
+    panels.back().firstElement = types.size();
+    panels.back().elementCount = 0;
+    panels.back().firstGroup = groups.size();
+    panels.back().groupCount = 0;
+    currentGroup = GuiGroupModel::NoGroup;
+}
+
+void GuiModel::endPanel() {
+    if (panels.empty()) {
+        return;
+    }
+    if (!panels.back().valid) {
+        ofLogError() << "Invalid 'gui' configuration for panel.";
+    }
+    panels.back().groupCount = groups.size() - panels.back().firstGroup;
+    GuiLayout::layoutPanel(*this, panels.size() - 1);  // Elements in layouts get their final rects
+}
+
+void GuiModel::beginGroup() {
+    if (panels.empty()) {
+        ofLogError() << "Group added outside of a panel.";
+        return;
+    }
+    GuiGroupModel group;
+    group.parent = currentGroup;
+    group.firstElement = types.size();
+    currentGroup = static_cast<uint32_t>(groups.size());
+    groups.push_back(group);
+}
+
+void GuiModel::endGroup(const GuiElementDesc& desc) {
+    if (currentGroup == GuiGroupModel::NoGroup) {
+        return;
+    }
+    GuiGroupModel& group = groups[currentGroup];
+    group.layout = desc.layout;
+    if (group.layout.type == GuiLayoutType::None) {
+        group.layout.type = GuiLayoutType::Column;
+    }
+    group.rect = desc.rect;
+    group.fixedSize = desc.fixedSize;
+    currentGroup = group.parent;
+}
+
+void GuiModel::addElement(const GuiElementDesc& desc) {
+    if (panels.empty()) {
+        ofLogError() << "Element '" << desc.id << "' added outside of a panel.";
+        return;
+    }
+
+    GuiElementType elementType = parseElementType(desc.type);
+    if (elementType == GuiElementType::Unknown) {
+        ofLogWarning() << "Unknown element type '" << desc.type << "' for element '" << desc.id << "'.";
+    }
+
+    float minValue = desc.minValue;
+    float maxValue = desc.maxValue;
+    float defaultValue = desc.defaultValue;
+    if (elementType == GuiElementType::Dropdown) {
+        // Options are indexed, the default may name one of them
+        minValue = 0;
+        maxValue = desc.options.empty() ? 0.f : static_cast<float>(desc.options.size() - 1);
+        if (!desc.defaultOption.empty()) {
+            auto option = std::find(desc.options.begin(), desc.options.end(), desc.defaultOption);
+            if (option != desc.options.end()) {
+                defaultValue = static_cast<float>(option - desc.options.begin());
+            }
+            else {
+                ofLogWarning() << "Default option '" << desc.defaultOption << "' not found in dropdown '" << desc.id << "'.";
+            }
+        }
+        if (desc.options.empty()) {
+            ofLogWarning() << "Dropdown '" << desc.id << "' has no 'options'.";
+        }
+    }
+    if (minValue > maxValue) {
+        ofLogWarning() << "'min' is above 'max' for element '" << desc.id << "', swapping them.";
+        std::swap(minValue, maxValue);
+    }
+    bool ranged = elementType == GuiElementType::Slider || elementType == GuiElementType::IntSlider ||
+        elementType == GuiElementType::FloatField || elementType == GuiElementType::IntField ||
+        elementType == GuiElementType::Dropdown;
+    if (ranged) {
+        defaultValue = ofClamp(defaultValue, minValue, maxValue);
+    }
+
+    types.push_back(elementType);
+    ids.push_back(desc.id.empty() ? NoId : intern(desc.id));
+    labels.push_back(desc.label);
+    actions.push_back(desc.action);
+    rects.push_back(desc.rect);
+    defaults.push_back(defaultValue);
+    panelIndices.push_back(static_cast<uint32_t>(panels.size() - 1));
+    audioParameters.push_back(desc.audioParameter);
+    smoothingMillis.push_back(desc.smoothingMillis);
+
+    GuiElementType rowType = GuiElementType::Unknown;
+    uint32_t rows = 0;
+    if (elementType == GuiElementType::VirtualList) {
+        rowType = desc.rowType == "label" ? GuiElementType::Label : GuiElementType::Toggle;
+        if (desc.rowType != "label" && desc.rowType != "toggle") {
+            ofLogWarning() << "Unknown row type '" << desc.rowType << "' for list '" << desc.id << "', using toggles.";
+        }
+        rows = static_cast<uint32_t>(std::max(desc.visibleRows, 1));
+    }
+    rowTypes.push_back(rowType);
+    visibleRows.push_back(rows);
+    mins.push_back(minValue);
+    maxs.push_back(maxValue);
+    maxRates.push_back(std::max(desc.maxRate, 0.f));
+    options.push_back(elementType == GuiElementType::Dropdown ? desc.options : std::vector<std::string>());
+    if (elementType != GuiElementType::Label && !desc.bind.empty()) {
+        ofLogWarning() << "Only labels can be bound, ignoring 'bind' of element '" << desc.id << "'.";
+    }
+    bool bound = elementType == GuiElementType::Label && !desc.bind.empty();
+    binds.push_back(bound ? desc.bind : std::vector<std::string>());
+    formats.push_back(bound ? desc.format : std::string());
+    fixedSizes.push_back(desc.fixedSize);
+    elementGroups.push_back(currentGroup);
+    panels.back().elementCount++;
+}
+
+void GuiModel::compilePanel(const json& panelConfig) {
+    GuiPanelModel panel;
+    const json& guiConfig = readJsonChild(panelConfig, "gui");
+    if (guiConfig.is_object()) {
+        panel.valid = true;
+        panel.title = readJsonValue<std::string>(guiConfig, "title", panel.title);
+        panel.settingsFile = readJsonValue<std::string>(guiConfig, "settings_file", "");
+        panel.width = readJsonValue<float>(guiConfig, "width", panel.width);
+        panel.height = readJsonValue<float>(guiConfig, "height", panel.height);
+        const json& position = readJsonChild(guiConfig, "position");
+        panel.x = readJsonValue<float>(position, "x", 0);
+        panel.y = readJsonValue<float>(position, "y", 0);
+        for (const auto& item : guiConfig.items()) {
+            if (!item.value().is_null()) {
+                readLayoutKey(panel.layout, item.key(), item.value());
+            }
+        }
+    }
+    beginPanel(panel);
+    compileElements(readJsonChild(panelConfig, "elements"));
+    endPanel();
+}
+
+void GuiModel::compileElements(const json& elementsConfig) {
+    if (elementsConfig.is_array()) {
+        for (const auto& elementConfig : elementsConfig) {
+            GuiElementDesc desc;
+            if (elementConfig.is_object()) {
+                for (const auto& item : elementConfig.items()) {
+                    const std::string& key = item.key();
+                    const json& value = item.value();
+                    if ((key == "position" || key == "size") && value.is_object()) {
+                        GuiElementScope scope = key == "position" ? GuiElementScope::Position : GuiElementScope::Size;
+                        for (const auto& field : value.items()) {
+                            readElementKey(desc, scope, field.key(), field.value());
+                        }
+                    }
+                    else if ((key == "options" || key == "bind") && value.is_array()) {
+                        GuiElementScope scope = key == "options" ? GuiElementScope::Options : GuiElementScope::Bind;
+                        for (const auto& entry : value) {
+                            readElementKey(desc, scope, key, entry);
+                        }
+                    }
+                    else if (key != "elements") {
+                        readElementKey(desc, GuiElementScope::Element, key, value);
+                    }
+                }
+            }
+
+            const json& children = readJsonChild(elementConfig, "elements");
+            if (children.is_array() || desc.type == "group") {
+                beginGroup();
+                compileElements(children);
+                endGroup(desc);
+            }
+            else {
+                addElement(desc);
+            }
+        }
+    }
+}
+
+void GuiModel::compileBackgroundColor(const json& bgColor) {
+    if (bgColor.is_array() && bgColor.size() == 3 && bgColor[0].is_number() && bgColor[1].is_number() && bgColor[2].is_number()) {
+        for (int i = 0; i < 3; i++) {
+            settings.backgroundColor[i] = bgColor[i].get<int>();
+        }
+        settings.hasBackgroundColor = true;
+    }
+    else {
+        ofLogError() << "Invalid 'background_color' format. Expected an array of 3 integers.";
+    }
+}
+
+void GuiModel::compileSettings(const json& config) {
+    const json& bgColor = readJsonChild(config, "background_color");
+    if (bgColor.is_array()) {
+        compileBackgroundColor(bgColor);
+    }
+
+    const json& audio = readJsonChild(config, "audio_settings");
+    settings.audio.outputChannels = readJsonValue<int>(audio, "outputChannels", 0);
+    settings.audio.inputChannels = readJsonValue<int>(audio, "inputChannels", 0);
+    settings.audio.sampleRate = readJsonValue<int>(audio, "sampleRate", 0);
+    settings.audio.bufferSize = readJsonValue<int>(audio, "bufferSize", 0);
+    settings.audio.minFrequency = readJsonValue<int>(audio, "minFrequency", 0);
+    settings.audio.maxFrequency = readJsonValue<int>(audio, "maxFrequency", 0);
+    settings.audio.sensitivity = readJsonValue<int>(audio, "sensitivity", 0);
+
+    const json& interaction = readJsonChild(config, "interaction");
+    settings.interaction.enable = readJsonValue<bool>(interaction, "enable", false);
+    settings.interaction.type = readJsonValue<std::string>(interaction, "type", "");
+
+    const json& profiler = readJsonChild(config, "profiler");
+    settings.profiler.enable = readJsonValue<bool>(profiler, "enable", false);
+    settings.profiler.overlay = readJsonValue<bool>(profiler, "overlay", false);
+    settings.profiler.historyFrames = readJsonValue<int>(profiler, "history_frames", 120);
+    settings.profiler.traceFile = readJsonValue<std::string>(profiler, "trace_file", "");
+    const json& overlayPosition = readJsonChild(profiler, "position");
+    settings.profiler.x = readJsonValue<float>(overlayPosition, "x", 10);
+    settings.profiler.y = readJsonValue<float>(overlayPosition, "y", 20);
+}
@@ -0,0 +1,433 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonModel.h
+
+    @brief    This file defines the GuiModel, a compiled and typed form of the
+              ofxGuiJson JSON configuration. The JSON is walked once and the
+              elements are stored as flat arrays that widget creation and
+              per-frame code can read without touching the JSON tree.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include "ofMain.h"
+#include <json.hpp>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using json = nlohmann::json;
+
+/*!
+ *  @brief Reads a value from a JSON object without undefined behaviour on missing keys.
+ *  @param node The JSON object to read from. Anything that is not an object yields the fallback.
+ *  @param key The key to read.
+ *  @param fallback The value returned when the key is missing, null or of the wrong type.
+ *  @return The value stored under the key, or the fallback.
+ */
+template<typename T>
+T readJsonValue(const json& node, const char* key, const T& fallback) {
+    if (!node.is_object()) {
+        return fallback;
+    }
+    auto it = node.find(key);
+    if (it == node.end() || it->is_null()) {
+        return fallback;
+    }
+    try {
+        return it->template get<T>();
+    }
+    catch (const json::exception&) {
+        ofLogWarning() << "Unexpected type for '" << key << "', using default value.";
+        return fallback;
+    }
+}
+
+/*!
+ *  @brief Assigns a JSON value to a variable, keeping the variable when the type does not match.
+ *  @param target The variable.
+ *  @param value The JSON value.
+ *  @param key The key of the value, for the warning logged on a type mismatch.
+ */
+template<typename T>
+void assignJsonValue(T& target, const json& value, const std::string& key) {
+    try {
+        target = value.template get<T>();
+    }
+    catch (const json::exception&) {
+        ofLogWarning() << "Unexpected type for '" << key << "', using default value.";
+    }
+}
+
+/*!
+ *  @brief Returns a child of a JSON object, or a null JSON value if it does not exist.
+ *  @param node The JSON object.
+ *  @param key The key of the child.
+ */
+const json& readJsonChild(const json& node, const char* key);
+
+/*!
+ *  @brief The element types understood by ofxGuiJson.
+ */
+enum class GuiElementType : uint8_t {
+    Unknown,
+    Toggle,
+    Label,
+    VirtualList,
+    Slider,
+    IntSlider,
+    Button,
+    Dropdown,
+    FloatField,
+    IntField
+};
+
+/*!
+ *  @brief Number of GuiElementType values.
+ */
+constexpr size_t GuiElementTypeCount = static_cast<size_t>(GuiElementType::IntField) + 1;
+
+/*!
+ *  @brief Returns the element type named in JSON, e.g. "int_slider", or GuiElementType::Unknown.
+ *  @param type The type as written in JSON.
+ */
+GuiElementType parseElementType(const std::string& type);
+
+/*!
+ *  @brief Reads a "default" value: booleans become 1 or 0, numbers are kept.
+ *  @param value The JSON value.
+ *  @param fallback The value returned for other types.
+ */
+float readDefaultValue(const json& value, float fallback);
+
+/*!
+ *  @brief How a panel or a group places its children.
+ */
+enum class GuiLayoutType : uint8_t {
+    None,       //!< Each child at its own position.
+    Column,     //!< Stacked top to bottom, stretched to the width of the column.
+    Row,        //!< Side by side, left to right.
+    Grid        //!< In rows of a fixed number of equal cells.
+};
+
+/*!
+ *  @brief Returns the layout named in JSON, e.g. "column", or GuiLayoutType::None.
+ *  @param layout The layout as written in JSON.
+ */
+GuiLayoutType parseLayoutType(const std::string& layout);
+
+/*!
+ *  @brief Flags of the dimensions given by a "size" block, measured otherwise in layouts.
+ */
+enum GuiFixedSize : uint8_t {
+    GuiFixedWidth = 1 << 0,
+    GuiFixedHeight = 1 << 1
+};
+
+/*!
+ *  @struct GuiLayoutSpec
+ *  @brief Layout of a panel or group, from its "layout", "gap", "padding" and "columns" keys.
+ */
+struct GuiLayoutSpec {
+    GuiLayoutType type = GuiLayoutType::None;   //!< How the children are placed.
+    float gap = 4;                              //!< Space between children.
+    float padding = 0;                          //!< Space around the children.
+    uint32_t columns = 2;                       //!< Cells per row of a grid.
+};
+
+/*!
+ *  @brief Reads one of the layout keys shared by "gui" blocks and groups.
+ *  @param spec The layout to change.
+ *  @param key The key.
+ *  @param value The value of the key.
+ *  @return False if the key is not a layout key.
+ */
+bool readLayoutKey(GuiLayoutSpec& spec, const std::string& key, const json& value);
+
+/*!
+ *  @struct GuiPanelModel
+ *  @brief Compiled settings of a panel and the range of its elements in the element table.
+ */
+struct GuiPanelModel {
+    std::string title = "Default Panel";    //!< The title of the panel.
+    std::string settingsFile;               //!< The file written and read by the save and load buttons of the panel header.
+    float width = 400;                      //!< The width of the panel.
+    float height = 300;                     //!< The height of the panel.
+    float x = 0;                            //!< The x position of the panel.
+    float y = 0;                            //!< The y position of the panel.
+    size_t firstElement = 0;                //!< Index of the first element of the panel.
+    size_t elementCount = 0;                //!< Number of elements in the panel.
+    size_t firstGroup = 0;                  //!< Index of the first group of the panel.
+    size_t groupCount = 0;                  //!< Number of groups in the panel.
+    GuiLayoutSpec layout;                   //!< Layout of the elements of the panel, None to keep their positions.
+    bool valid = false;                     //!< Whether the panel had a valid 'gui' block.
+
+    /*!
+     *  @brief Returns true if the elements are placed by a layout, either of the panel or of its groups.
+     */
+    bool hasLayout() const { return layout.type != GuiLayoutType::None || groupCount > 0; }
+};
+
+/*!
+ *  @struct GuiGroupModel
+ *  @brief A "group" element: a layout container whose elements are stored in the element table
+ *         like any other, in document order.
+ */
+struct GuiGroupModel {
+    static constexpr uint32_t NoGroup = UINT32_MAX;     //!< Parent of the groups placed by the panel.
+
+    GuiLayoutSpec layout;                   //!< Layout of the children, Column by default.
+    ofRectangle rect;                       //!< Position, used when the parent has no layout, and given size.
+    uint8_t fixedSize = 0;                  //!< GuiFixedSize flags of the size given in JSON.
+    uint32_t parent = NoGroup;              //!< The enclosing group, NoGroup for the panel.
+    size_t firstElement = 0;                //!< Index of the first element after the start of the group.
+};
+
+/*!
+ *  @struct GuiElementDesc
+ *  @brief Descriptor of a single element as read from the configuration, before it is added to the model.
+ */
+struct GuiElementDesc {
+    std::string type;                               //!< The element type as written in JSON.
+    std::string id;                                 //!< The element ID.
+    std::string label;                              //!< The element label.
+    std::string action;                             //!< The element action.
+    ofRectangle rect = ofRectangle(0, 0, 300, 30);  //!< The element position and size.
+    float defaultValue = 0;                         //!< The element default value.
+    std::string audioParameter;                     //!< The audio parameter fed by the element.
+    float smoothingMillis = 0;                      //!< Smoothing time of the audio parameter.
+    std::string rowType = "toggle";                 //!< Row widget of a virtual list, "toggle" or "label".
+    int visibleRows = 8;                            //!< Number of rows a virtual list instantiates.
+    float minValue = 0;                             //!< Lowest value of sliders and fields.
+    float maxValue = 1;                             //!< Highest value of sliders and fields.
+    float maxRate = 0;                              //!< Most notifications per second of sliders and fields, 0 for once per frame.
+    std::vector<std::string> options;               //!< Options of a dropdown.
+    std::string defaultOption;                      //!< Default of a dropdown given by name instead of index.
+    std::vector<std::string> bind;                  //!< Registered values shown by a label.
+    std::string format;                             //!< How a bound label renders its values.
+    uint8_t fixedSize = 0;                          //!< GuiFixedSize flags of the size given in JSON.
+    GuiLayoutSpec layout;                           //!< Layout of a group, Column unless "layout" is given.
+    bool isGroup = false;                           //!< Whether the descriptor is a group with "elements".
+};
+
+/*!
+ *  @brief The object or array of an element a value is read in.
+ */
+enum class GuiElementScope : uint8_t {
+    Element,    //!< The element object.
+    Position,   //!< The "position" object.
+    Size,       //!< The "size" object.
+    Options,    //!< An item of the "options" array.
+    Bind        //!< An item of the "bind" array.
+};
+
+/*!
+ *  @brief Reads one scalar value of an element. The DOM compiler and the SAX loader both read
+ *         elements through it, so they agree on every key.
+ *  @param desc The element to change.
+ *  @param scope Where the value is.
+ *  @param key The key of the value, ignored for array items.
+ *  @param value The value, null values are skipped.
+ *  @return False if the key is not an element key.
+ */
+bool readElementKey(GuiElementDesc& desc, GuiElementScope scope, const std::string& key, const json& value);
+
+/*!
+ *  @struct GuiAudioSettings
+ *  @brief Typed copy of the 'audio_settings' block.
+ */
+struct GuiAudioSettings {
+    int outputChannels = 0;
+    int inputChannels = 0;
+    int sampleRate = 0;
+    int bufferSize = 0;
+    int minFrequency = 0;
+    int maxFrequency = 0;
+    int sensitivity = 0;
+};
+
+/*!
+ *  @struct GuiInteractionSettings
+ *  @brief Typed copy of the 'interaction' block.
+ */
+struct GuiInteractionSettings {
+    bool enable = false;
+    std::string type;
+};
+
+/*!
+ *  @struct GuiProfilerSettings
+ *  @brief Typed copy of the 'profiler' block.
+ */
+struct GuiProfilerSettings {
+    bool enable = false;        //!< Whether the GUI work of each frame is timed and counted.
+    bool overlay = false;       //!< Whether the stats are drawn over the GUI.
+    float x = 10;               //!< Left edge of the overlay.
+    float y = 20;               //!< Baseline of the first line of the overlay.
+    int historyFrames = 120;    //!< Number of frames averaged.
+    std::string traceFile;      //!< Chrome trace written when the GUI is destroyed, empty for none.
+};
+
+/*!
+ *  @struct GuiSettings
+ *  @brief Typed copy of the top level settings of the configuration.
+ */
+struct GuiSettings {
+    bool hasBackgroundColor = false;        //!< Whether a valid 'background_color' was given.
+    int backgroundColor[3] = { 0, 0, 0 };   //!< The background color as r, g, b.
+    GuiAudioSettings audio;                 //!< The 'audio_settings' block.
+    GuiInteractionSettings interaction;     //!< The 'interaction' block.
+    GuiProfilerSettings profiler;           //!< The 'profiler' block.
+};
+
+/*!
+ *  @class GuiModel
+ *  @brief The configuration compiled into a struct-of-arrays element table.
+ *
+ *  Element i of the configuration is described by types[i], ids[i], labels[i], and so on.
+ *  IDs are interned: ids[i] is an index into idNames.
+ */
+class GuiModel {
+public:
+    /*!
+     *  @brief Value used for elements without an ID.
+     */
+    static constexpr uint32_t NoId = UINT32_MAX;
+
+    /*!
+     *  @brief Compiles a JSON configuration, replacing the current contents of the model.
+     *  @param config The JSON configuration.
+     *  @return True if the configuration had a valid 'panels' array.
+     */
+    bool compile(const json& config);
+
+    /*!
+     *  @brief Clears all panels, elements and settings.
+     */
+    void clear();
+
+    /*!
+     *  @brief Starts a new panel. Elements added until endPanel() belong to it.
+     *  @param panel The compiled settings of the panel.
+     */
+    void beginPanel(const GuiPanelModel& panel);
+
+    /*!
+     *  @brief Finishes the panel started by beginPanel().
+     */
+    void endPanel();
+
+    /*!
+     *  @brief Appends an element to the current panel.
+     *  @param desc The descriptor of the element.
+     */
+    void addElement(const GuiElementDesc& desc);
+
+    /*!
+     *  @brief Starts a group in the current panel or group. Elements added until endGroup() belong to it.
+     */
+    void beginGroup();
+
+    /*!
+     *  @brief Finishes the group started by beginGroup().
+     *  @param desc The descriptor of the group, read until its end.
+     */
+    void endGroup(const GuiElementDesc& desc);
+
+    /*!
+     *  @brief Returns the number of elements in the model.
+     */
+    size_t size() const { return types.size(); }
+
+    /*!
+     *  @brief Compiles a 'background_color' array into the settings.
+     *  @param bgColor The JSON array of 3 integers.
+     */
+    void compileBackgroundColor(const json& bgColor);
+
+    /*!
+     *  @brief Interns an ID, returning its index in idNames.
+     *  @param id The ID to intern.
+     */
+    uint32_t intern(const std::string& id);
+
+    /*!
+     *  @brief Finds an interned ID.
+     *  @param id The ID to look up.
+     *  @return The index of the ID, or NoId if it was never interned.
+     */
+    uint32_t findId(const std::string& id) const;
+
+    /*!
+     *  @brief Returns the ID string of an element.
+     *  @param index The index of the element.
+     */
+    const std::string& idOf(size_t index) const;
+
+    std::vector<GuiPanelModel> panels;        //!< The compiled panels.
+
+    std::vector<GuiElementType> types;        //!< Element types.
+    std::vector<uint32_t> ids;                //!< Interned element IDs.
+    std::vector<std::string> labels;          //!< Element labels.
+    std::vector<std::string> actions;         //!< Element actions, empty when not given.
+    std::vector<ofRectangle> rects;           //!< Element positions and sizes.
+    std::vector<float> defaults;              //!< Element default values (0 or 1 for toggles).
+    std::vector<uint32_t> panelIndices;       //!< Index of the panel owning each element.
+    std::vector<std::string> audioParameters; //!< Audio parameter fed by each element, empty when none.
+    std::vector<float> smoothingMillis;       //!< Smoothing time of each audio parameter.
+    std::vector<GuiElementType> rowTypes;     //!< Row widget type of virtual lists, Unknown for other elements.
+    std::vector<uint32_t> visibleRows;        //!< Visible rows of virtual lists, 0 for other elements.
+    std::vector<float> mins;                  //!< Lowest value of sliders and fields.
+    std::vector<float> maxs;                  //!< Highest value of sliders and fields.
+    std::vector<float> maxRates;              //!< Most notifications per second, 0 for once per frame.
+    std::vector<std::vector<std::string>> options; //!< Options of dropdowns, empty for other elements.
+    std::vector<std::vector<std::string>> binds;   //!< Values bound to labels, empty for other elements.
+    std::vector<std::string> formats;         //!< Format of bound labels, empty for the default.
+    std::vector<uint8_t> fixedSizes;          //!< GuiFixedSize flags of the size given to each element.
+    std::vector<uint32_t> elementGroups;      //!< Group of each element, GuiGroupModel::NoGroup for the panel.
+
+    std::vector<GuiGroupModel> groups;        //!< The groups of all panels.
+
+    std::vector<std::string> idNames;         //!< Interned ID strings.
+
+    GuiSettings settings;                     //!< The typed settings block.
+
+private:
+    /*!
+     *  @brief Lookup from ID string to its interned index.
+     */
+    std::unordered_map<std::string, uint32_t> idLookup;
+
+    /*!
+     *  @brief The group elements are added to, NoGroup for the panel.
+     */
+    uint32_t currentGroup = GuiGroupModel::NoGroup;
+
+    /*!
+     *  @brief Compiles the elements of one panel.
+     *  @param panelConfig The JSON configuration of the panel.
+     */
+    void compilePanel(const json& panelConfig);
+
+    /*!
+     *  @brief Compiles an "elements" array of a panel or group.
+     *  @param elementsConfig The JSON array.
+     */
+    void compileElements(const json& elementsConfig);
+
+    /*!
+     *  @brief Compiles the top level settings.
+     *  @param config The JSON configuration.
+     */
+    void compileSettings(const json& config);
+};
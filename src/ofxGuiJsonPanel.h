@@ -0,0 +1,151 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonPanel.h
+
+    @brief    This file defines ofxGuiJsonPanel, an ofxPanel that can detach a
+              single control and keep the rects of a layout. ofxGuiGroup only
+              supports clearing all of its controls, which forces a full
+              rebuild for every removal, and stacks its controls again whenever
+              one of them is resized.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include "ofxGui.h"
+#include <algorithm>
+
+/*!
+ *  @class ofxGuiJsonPanel
+ *  @brief Panel supporting removal of one control, moving up only the rows below it.
+ *
+ *  With a managed layout the controls are not stacked: each keeps the rect given with place(),
+ *  relative to the top left corner below the header, and the panel only follows their extent.
+ *  Removing a control then moves nothing, the layout places the remaining controls again.
+ */
+class ofxGuiJsonPanel : public ofxPanel {
+public:
+    /*!
+     *  @brief Keeps the rects given with place() instead of stacking the controls.
+     *  @param managed True if a layout places the controls.
+     */
+    void setLayoutManaged(bool managed) {
+        if (collection.empty()) {
+            contentTop = b.height;  // Only the header, as left by setup() or clear()
+        }
+        if (managed != layoutManaged) {
+            layoutManaged = managed;
+            sizeChangedCB();
+        }
+    }
+
+    /*!
+     *  @brief Returns true if a layout places the controls.
+     */
+    bool isLayoutManaged() const { return layoutManaged; }
+
+    /*!
+     *  @brief Adds a control. With a managed layout the control keeps its shape until it is placed.
+     *  @param element The control to add.
+     */
+    void add(ofxBaseGui* element) {
+        if (collection.empty()) {
+            contentTop = b.height;  // The panel may have been set up since it was last cleared
+        }
+        ofRectangle shape = element->getShape();
+        ofxPanel::add(element);
+        if (layoutManaged) {
+            element->setPosition(shape.x, shape.y);
+            sizeChangedCB();
+        }
+    }
+
+    /*!
+     *  @brief Detaches every control.
+     */
+    void clear() {
+        ofxPanel::clear();
+        contentTop = b.height;
+    }
+
+    /*!
+     *  @brief Moves and resizes a control of a managed layout.
+     *  @param element The control.
+     *  @param rect The rect, relative to the top left corner below the header.
+     */
+    void place(ofxBaseGui* element, const ofRectangle& rect) {
+        element->setPosition(b.x + rect.x, b.y + contentTop + rect.y);
+        element->setSize(rect.width, rect.height);  // Notifies the panel, which grows to enclose the control
+    }
+
+    /*!
+     *  @brief Detaches a control from the panel. The control itself is not destroyed.
+     *  @param element The control to detach.
+     *  @return True if the control was part of the panel.
+     */
+    bool remove(ofxBaseGui* element) {
+        auto it = std::find(collection.begin(), collection.end(), element);
+        if (it == collection.end()) {
+            return false;
+        }
+        if (layoutManaged) {
+            collection.erase(it);
+            parameters.remove(element->getParameter());
+            element->setParent(nullptr);
+            sizeChangedCB();  // The other controls stay where the layout placed them
+            return true;
+        }
+
+        // Rows above keep their position, rows below move up by the height of the removed row
+        float shift = element->getHeight() + spacing;
+        for (auto below = it + 1; below != collection.end(); ++below) {
+            (*below)->setPosition((*below)->getPosition().x, (*below)->getPosition().y - shift);
+        }
+        collection.erase(it);
+        parameters.remove(element->getParameter());
+        element->setParent(nullptr);
+
+        if (!isMinimized()) {
+            b.height -= shift;  // A minimized panel recomputes its height when maximized
+        }
+        setNeedsRedraw();
+        if (parent) {
+            parent->sizeChangedCB();
+        }
+        return true;
+    }
+
+    /*!
+     *  @brief Called when a control is resized. With a managed layout the controls stay where they
+     *         were placed and only the height of the panel follows them.
+     */
+    void sizeChangedCB() override {
+        if (!layoutManaged) {
+            ofxPanel::sizeChangedCB();
+            return;
+        }
+        float bottom = b.y + contentTop;
+        for (const auto& element : collection) {
+            bottom = std::max(bottom, element->getShape().getBottom() + spacing);
+        }
+        if (!isMinimized()) {
+            b.height = bottom - b.y;  // A minimized panel recomputes its height when maximized
+        }
+        setNeedsRedraw();
+        if (parent) {
+            parent->sizeChangedCB();
+        }
+    }
+
+private:
+    bool layoutManaged = false;     //!< Whether a layout places the controls.
+    float contentTop = 0;           //!< Height of the header, where the rects of a managed layout start.
+};
@@ -0,0 +1,70 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonParallel.h
+
+    @brief    This file defines parallelFor, which spreads independent tasks,
+              such as the preparation of each panel, across worker threads.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+/*!
+ *  @brief Returns the number of threads to use for a requested count.
+ *  @param requested The requested count, 0 for one thread per hardware thread.
+ */
+inline size_t resolveThreadCount(size_t requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+/*!
+ *  @brief Runs task(i) for every i below count, on up to threadCount threads including the calling one.
+ *         Indices are handed out one at a time, so threads that finish early take over the remaining
+ *         tasks. Each task must only write to state owned by its index.
+ *  @param count The number of tasks.
+ *  @param threadCount The maximum number of threads, 1 runs every task on the calling thread in order.
+ *  @param task The task to run for each index.
+ */
+inline void parallelFor(size_t count, size_t threadCount, const std::function<void(size_t)>& task) {
+    size_t workers = std::min(count, threadCount);
+    if (workers <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    auto work = [&]() {
+        for (size_t i = next++; i < count; i = next++) {
+            task(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (size_t t = 1; t < workers; t++) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
@@ -0,0 +1,181 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonPool.h
+
+    @brief    This file defines WidgetPool, a per-type slab allocator for GUI
+              widgets. Widgets are constructed in place in fixed size blocks,
+              reserved from the parsed configuration, and referred to by
+              generation checked handles instead of individual heap
+              allocations.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/*!
+ *  @struct WidgetHandle
+ *  @brief Stable reference to a widget in a WidgetPool. Stale handles are detected by their generation.
+ */
+struct WidgetHandle {
+    uint32_t index = UINT32_MAX;    //!< Index of the slot in the pool.
+    uint32_t generation = 0;        //!< Generation of the slot when the widget was created.
+
+    /*!
+     *  @brief Returns true if the handle was returned by WidgetPool::create().
+     */
+    bool isValid() const { return index != UINT32_MAX; }
+};
+
+/*!
+ *  @class WidgetPool
+ *  @brief Slab allocator constructing widgets of one type in place.
+ *
+ *  Memory is allocated in blocks of BlockSize slots and never moves, so widget addresses handed to
+ *  ofxGui panels stay valid until the widget is destroyed. The block of a slot is found with a shift
+ *  of its index. Destroyed slots are recycled through a free list.
+ */
+template<typename T>
+class WidgetPool {
+public:
+    static constexpr uint32_t BlockShift = 6;                   //!< log2 of the number of slots per block.
+    static constexpr uint32_t BlockSize = 1u << BlockShift;     //!< Number of slots per block.
+
+    WidgetPool() = default;
+    ~WidgetPool() { clear(); }
+    WidgetPool(const WidgetPool&) = delete;
+    WidgetPool& operator=(const WidgetPool&) = delete;
+
+    /*!
+     *  @brief Makes room for at least count widgets in total, rounded up to whole blocks.
+     *  @param count The number of widgets the pool should hold without growing.
+     */
+    void reserve(size_t count) {
+        blocks.reserve((count + BlockSize - 1) >> BlockShift);
+        while (slotCount < count) {
+            addBlock();
+        }
+    }
+
+    /*!
+     *  @brief Constructs a widget in a free slot.
+     *  @return The handle of the new widget.
+     */
+    WidgetHandle create() {
+        if (freeSlots.empty()) {
+            addBlock();
+        }
+        uint32_t index = freeSlots.back();
+        freeSlots.pop_back();
+
+        Slot& slot = slotAt(index);
+        new (slot.storage) T();
+        slot.alive = true;
+        liveCount++;
+
+        WidgetHandle handle;
+        handle.index = index;
+        handle.generation = slot.generation;
+        return handle;
+    }
+
+    /*!
+     *  @brief Returns the widget of a handle.
+     *  @param handle The handle.
+     *  @return The widget, or nullptr if the handle is invalid or the widget was destroyed.
+     */
+    T* get(WidgetHandle handle) const {
+        if (!handle.isValid() || handle.index >= slotCount) {
+            return nullptr;
+        }
+        Slot& slot = slotAt(handle.index);
+        return slot.alive && slot.generation == handle.generation ? slot.object() : nullptr;
+    }
+
+    /*!
+     *  @brief Destroys a widget and recycles its slot. Stale handles are ignored.
+     *  @param handle The handle of the widget.
+     */
+    void destroy(WidgetHandle handle) {
+        if (get(handle)) {
+            release(handle.index);
+        }
+    }
+
+    /*!
+     *  @brief Destroys every widget at once. The memory is kept for reuse.
+     */
+    void clear() {
+        for (uint32_t i = 0; i < slotCount && liveCount > 0; i++) {
+            if (slotAt(i).alive) {
+                release(i);
+            }
+        }
+    }
+
+    /*!
+     *  @brief Returns the number of live widgets.
+     */
+    size_t size() const { return liveCount; }
+
+    /*!
+     *  @brief Returns the number of widgets the pool can hold without allocating.
+     */
+    size_t capacity() const { return slotCount; }
+
+private:
+    /*!
+     *  @struct Slot
+     *  @brief Storage for one widget.
+     */
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];    //!< The widget storage.
+        uint32_t generation = 0;                        //!< Incremented each time the slot is released.
+        bool alive = false;                             //!< Whether a widget is constructed in the slot.
+
+        T* object() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    void addBlock() {
+        blocks.emplace_back(new Slot[BlockSize]);
+        slotCount += BlockSize;
+
+        // Hand out low indices first so widgets created together stay close in memory,
+        // the slots of a new block go after the free slots of the previous ones
+        freeSlots.insert(freeSlots.begin(), BlockSize, 0);
+        for (uint32_t i = 0; i < BlockSize; i++) {
+            freeSlots[i] = static_cast<uint32_t>(slotCount - 1 - i);
+        }
+    }
+
+    Slot& slotAt(uint32_t index) const {
+        return blocks[index >> BlockShift][index & (BlockSize - 1)];
+    }
+
+    void release(uint32_t index) {
+        Slot& slot = slotAt(index);
+        slot.object()->~T();
+        slot.alive = false;
+        slot.generation++;
+        liveCount--;
+        freeSlots.push_back(index);
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> blocks;    //!< The allocated blocks, BlockSize slots each.
+    std::vector<uint32_t> freeSlots;                //!< Indices of free slots, next one at the back.
+    size_t slotCount = 0;                           //!< Total number of slots, a multiple of BlockSize.
+    size_t liveCount = 0;                           //!< Number of constructed widgets.
+};
@@ -0,0 +1,185 @@
+#include "ofxGuiJsonProfiler.h"
+#include <json.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+const char* toString(GuiProfileScope scope) {
+    switch (scope) {
+    case GuiProfileScope::Setup: return "setup";
+    case GuiProfileScope::LoadJson: return "loadJson";
+    case GuiProfileScope::ParseGuiElements: return "parseGuiElements";
+    case GuiProfileScope::UpdateGuiLabels: return "updateGuiLabels";
+    case GuiProfileScope::CommitLabels: return "commitLabelUpdates";
+    case GuiProfileScope::UpdateBindings: return "updateBindings";
+    case GuiProfileScope::Dispatch: return "dispatch";
+    case GuiProfileScope::Draw: return "draw";
+    }
+    return "unknown";
+}
+
+const char* toString(GuiCounter counter) {
+    switch (counter) {
+    case GuiCounter::EventsFired: return "events";
+    case GuiCounter::LabelsChanged: return "labels";
+    case GuiCounter::WidgetsCreated: return "created";
+    case GuiCounter::WidgetsDestroyed: return "destroyed";
+    case GuiCounter::PanelsRendered: return "panels";
+    case GuiCounter::Allocations: return "allocations";
+    case GuiCounter::ElementsMoved: return "moved";
+    }
+    return "unknown";
+}
+
+GuiProfiler::GuiProfiler() : origin(Clock::now()) {
+}
+
+void GuiProfiler::setEnabled(bool enable, size_t historyFrames) {
+    enabled = enable;
+    current = GuiFrameStats();
+    history.assign(std::max<size_t>(1, historyFrames), GuiFrameStats());
+    historyHead = 0;
+    historyCount = 0;
+}
+
+void GuiProfiler::endFrame() {
+    if (!enabled) {
+        return;
+    }
+    current.frame = ofGetFrameNum();
+    if (tracing) {
+        traceFrames.push_back({ sinceOrigin(Clock::now()), current.counters });
+    }
+    history[historyHead] = current;
+    historyHead = (historyHead + 1) % history.size();
+    historyCount = std::min(historyCount + 1, history.size());
+    current = GuiFrameStats();
+}
+
+const GuiFrameStats& GuiProfiler::getLastFrame() const {
+    static const GuiFrameStats empty;
+    return historyCount > 0 ? getHistoryFrame(0) : empty;
+}
+
+const GuiFrameStats& GuiProfiler::getHistoryFrame(size_t age) const {
+    return history[(historyHead + history.size() - 1 - age) % history.size()];
+}
+
+GuiFrameStats GuiProfiler::getAverage() const {
+    GuiFrameStats average;
+    if (historyCount == 0) {
+        return average;
+    }
+    for (size_t age = 0; age < historyCount; age++) {
+        const GuiFrameStats& frame = getHistoryFrame(age);
+        for (size_t s = 0; s < GuiProfileScopeCount; s++) {
+            average.micros[s] += frame.micros[s];
+            average.calls[s] += frame.calls[s];
+        }
+        for (size_t c = 0; c < GuiCounterCount; c++) {
+            average.counters[c] += frame.counters[c];
+        }
+    }
+    for (size_t s = 0; s < GuiProfileScopeCount; s++) {
+        average.micros[s] /= historyCount;
+        average.calls[s] = static_cast<uint32_t>(average.calls[s] / historyCount);
+    }
+    for (size_t c = 0; c < GuiCounterCount; c++) {
+        average.counters[c] /= historyCount;
+    }
+    average.frame = getLastFrame().frame;
+    return average;
+}
+
+void GuiProfiler::setTracing(bool enable, size_t maxEvents) {
+    tracing = enable;
+    maxTraceEvents = maxEvents;
+    traceEvents.clear();
+    traceFrames.clear();
+    if (enable) {
+        traceEvents.reserve(std::min<size_t>(maxEvents, 65536));  // Grows further only for long captures
+    }
+}
+
+void GuiProfiler::record(GuiProfileScope scope, Clock::time_point start, Clock::time_point end) {
+    double micros = std::chrono::duration<double, std::micro>(end - start).count();
+    size_t index = static_cast<size_t>(scope);
+    current.micros[index] += micros;
+    current.calls[index]++;
+
+    if (!tracing) {
+        return;
+    }
+    if (traceEvents.size() >= maxTraceEvents) {
+        tracing = false;
+        ofLogWarning() << "Trace reached " << maxTraceEvents << " events, recording stopped.";
+        return;
+    }
+    traceEvents.push_back({ sinceOrigin(start), static_cast<float>(micros), scope });
+}
+
+int64_t GuiProfiler::sinceOrigin(Clock::time_point time) const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - origin).count();
+}
+
+bool GuiProfiler::writeChromeTrace(const std::string& path) const {
+    using json = nlohmann::json;
+    json events = json::array();
+    for (const auto& event : traceEvents) {
+        events.push_back({
+            { "name", toString(event.scope) },
+            { "cat", "ofxGuiJson" },
+            { "ph", "X" },
+            { "ts", event.startMicros },
+            { "dur", event.durationMicros },
+            { "pid", 0 },
+            { "tid", 0 }
+        });
+    }
+    for (const auto& frame : traceFrames) {
+        json args;
+        for (size_t c = 0; c < GuiCounterCount; c++) {
+            args[toString(static_cast<GuiCounter>(c))] = frame.counters[c];
+        }
+        events.push_back({
+            { "name", "counters" },
+            { "cat", "ofxGuiJson" },
+            { "ph", "C" },
+            { "ts", frame.endMicros },
+            { "pid", 0 },
+            { "args", args }
+        });
+    }
+
+    std::ofstream file(path);
+    if (!file) {
+        ofLogError() << "Failed to write trace: " << path;
+        return false;
+    }
+    json trace;
+    trace["traceEvents"] = std::move(events);
+    trace["displayTimeUnit"] = "ms";
+    file << trace.dump();
+    ofLogNotice() << "Wrote " << traceEvents.size() << " trace events to " << path;
+    return static_cast<bool>(file);
+}
+
+void GuiProfiler::drawOverlay(float x, float y) const {
+    const GuiFrameStats& last = getLastFrame();
+    GuiFrameStats average = getAverage();
+
+    // Formatted into a fixed buffer instead of a stream, the overlay runs every frame
+    char text[1024];
+    int length = std::snprintf(text, sizeof(text), "ofxGuiJson frame %llu (avg of %zu)\n",
+        static_cast<unsigned long long>(last.frame), historyCount);
+    for (size_t s = 0; s < GuiProfileScopeCount && length < static_cast<int>(sizeof(text)); s++) {
+        length += std::snprintf(text + length, sizeof(text) - length, "%-18s %8.1f us %8.1f us\n",
+            toString(static_cast<GuiProfileScope>(s)), last.micros[s], average.micros[s]);
+    }
+    for (size_t c = 0; c < GuiCounterCount && length < static_cast<int>(sizeof(text)); c++) {
+        length += std::snprintf(text + length, sizeof(text) - length, "%-18s %8llu    %8llu\n",
+            toString(static_cast<GuiCounter>(c)), static_cast<unsigned long long>(last.counters[c]),
+            static_cast<unsigned long long>(average.counters[c]));
+    }
+    ofDrawBitmapStringHighlight(text, x, y);
+}
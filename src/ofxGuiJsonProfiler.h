@@ -0,0 +1,272 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonProfiler.h
+
+    @brief    This file defines GuiProfiler, which times the work ofxGuiJson does
+              in each frame, counts what it changed, keeps a rolling history of
+              frames and exports the timed scopes as a Chrome trace.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include "ofMain.h"
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/*!
+ *  @brief Work timed by GuiProfiler. Scopes nest, so the time of a scope includes the scopes it calls.
+ */
+enum class GuiProfileScope : uint8_t {
+    Setup,              //!< setup(), including the load and the build.
+    LoadJson,           //!< loadJson() and the load of reloadConfig().
+    ParseGuiElements,   //!< parseGuiElements().
+    UpdateGuiLabels,    //!< updateGuiLabels().
+    CommitLabels,       //!< commitLabelUpdates().
+    UpdateBindings,     //!< updateBindings(), the commit of the bound labels included.
+    Dispatch,           //!< Notification of one change to its listeners.
+    Draw                //!< draw(), all panels.
+};
+
+/*!
+ *  @brief Number of GuiProfileScope values.
+ */
+constexpr size_t GuiProfileScopeCount = static_cast<size_t>(GuiProfileScope::Draw) + 1;
+
+/*!
+ *  @brief Quantities counted by GuiProfiler.
+ */
+enum class GuiCounter : uint8_t {
+    EventsFired,        //!< Changes notified to listeners.
+    LabelsChanged,      //!< Labels whose text was written to the backend.
+    WidgetsCreated,     //!< Elements created by the backend.
+    WidgetsDestroyed,   //!< Elements destroyed by the backend.
+    PanelsRendered,     //!< Panels drawn, or rendered into their cache in cached mode.
+    Allocations,        //!< Heap allocations made by ofxGuiJson itself: dispatch records, label slots and queue growth.
+    ElementsMoved       //!< Elements moved or resized by the layout after a label or a dynamic toggle changed.
+};
+
+/*!
+ *  @brief Number of GuiCounter values.
+ */
+constexpr size_t GuiCounterCount = static_cast<size_t>(GuiCounter::ElementsMoved) + 1;
+
+/*!
+ *  @brief Returns the name of a scope, as shown in the overlay and the trace.
+ *  @param scope The scope.
+ */
+const char* toString(GuiProfileScope scope);
+
+/*!
+ *  @brief Returns the name of a counter, as shown in the overlay and the trace.
+ *  @param counter The counter.
+ */
+const char* toString(GuiCounter counter);
+
+/*!
+ *  @struct GuiFrameStats
+ *  @brief Timings and counters of one frame.
+ */
+struct GuiFrameStats {
+    uint64_t frame = 0;                                     //!< The frame number, from ofGetFrameNum().
+    std::array<double, GuiProfileScopeCount> micros = {};   //!< Time spent in each scope, in microseconds.
+    std::array<uint32_t, GuiProfileScopeCount> calls = {};  //!< Number of times each scope ran.
+    std::array<uint64_t, GuiCounterCount> counters = {};    //!< Value of each counter.
+
+    /*!
+     *  @brief Returns the time spent in a scope, in microseconds.
+     *  @param scope The scope.
+     */
+    double getMicros(GuiProfileScope scope) const { return micros[static_cast<size_t>(scope)]; }
+
+    /*!
+     *  @brief Returns the number of times a scope ran.
+     *  @param scope The scope.
+     */
+    uint32_t getCalls(GuiProfileScope scope) const { return calls[static_cast<size_t>(scope)]; }
+
+    /*!
+     *  @brief Returns the value of a counter.
+     *  @param counter The counter.
+     */
+    uint64_t getCount(GuiCounter counter) const { return counters[static_cast<size_t>(counter)]; }
+};
+
+/*!
+ *  @class GuiProfiler
+ *  @brief Per-frame timings and counters of ofxGuiJson. Off by default; while off, a timer or a
+ *         counter costs one branch. Main thread only.
+ *
+ *  Work is added to the current frame until endFrame() moves it into a fixed-size history.
+ *  With tracing on, every timed scope is also kept as a trace event for writeChromeTrace().
+ */
+class GuiProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /*!
+     *  @class ScopedTimer
+     *  @brief Adds the time between its construction and its destruction to a scope.
+     */
+    class ScopedTimer {
+    public:
+        ScopedTimer(GuiProfiler& owner, GuiProfileScope timed)
+            : profiler(owner.isEnabled() ? &owner : nullptr), scope(timed) {
+            if (profiler) {
+                start = Clock::now();
+            }
+        }
+
+        ~ScopedTimer() {
+            if (profiler) {
+                profiler->record(scope, start, Clock::now());
+            }
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        GuiProfiler* profiler;      //!< The profiler, nullptr while it is disabled.
+        GuiProfileScope scope;      //!< The timed scope.
+        Clock::time_point start;    //!< When the scope started.
+    };
+
+    GuiProfiler();
+
+    /*!
+     *  @brief Enables or disables the profiler. Enabling clears the history.
+     *  @param enable True to time scopes and count.
+     *  @param historyFrames Number of completed frames kept.
+     */
+    void setEnabled(bool enable, size_t historyFrames = 120);
+
+    /*!
+     *  @brief Returns true if the profiler is enabled.
+     */
+    bool isEnabled() const { return enabled; }
+
+    /*!
+     *  @brief Adds to a counter of the current frame. Does nothing while disabled.
+     *  @param counter The counter.
+     *  @param amount The amount added.
+     */
+    void count(GuiCounter counter, uint64_t amount = 1) {
+        if (enabled) {
+            current.counters[static_cast<size_t>(counter)] += amount;
+        }
+    }
+
+    /*!
+     *  @brief Completes the current frame and starts the next one.
+     */
+    void endFrame();
+
+    /*!
+     *  @brief Returns the frame in progress.
+     */
+    const GuiFrameStats& getCurrentFrame() const { return current; }
+
+    /*!
+     *  @brief Returns the last completed frame, empty before the first endFrame().
+     */
+    const GuiFrameStats& getLastFrame() const;
+
+    /*!
+     *  @brief Returns a completed frame.
+     *  @param age 0 for the last completed frame, 1 for the one before, and so on, below getHistorySize().
+     */
+    const GuiFrameStats& getHistoryFrame(size_t age) const;
+
+    /*!
+     *  @brief Returns the number of completed frames in the history.
+     */
+    size_t getHistorySize() const { return historyCount; }
+
+    /*!
+     *  @brief Returns the mean of the completed frames in the history. The frame field is the last frame.
+     */
+    GuiFrameStats getAverage() const;
+
+    /*!
+     *  @brief Enables or disables recording trace events. Enabling clears the recorded events.
+     *  @param enable True to record every timed scope.
+     *  @param maxEvents Number of events recorded before recording stops, to bound memory.
+     */
+    void setTracing(bool enable, size_t maxEvents = 1000000);
+
+    /*!
+     *  @brief Returns true if trace events are recorded.
+     */
+    bool isTracing() const { return tracing; }
+
+    /*!
+     *  @brief Writes the recorded events in the Chrome trace-event format, for chrome://tracing or Perfetto.
+     *         Scopes are complete events, the counters of each frame are counter events.
+     *  @param path The path of the file to write.
+     *  @return False if the file could not be written.
+     */
+    bool writeChromeTrace(const std::string& path) const;
+
+    /*!
+     *  @brief Draws the last completed frame and the average of the history as text. Needs a GL context.
+     *  @param x The left edge.
+     *  @param y The baseline of the first line.
+     */
+    void drawOverlay(float x, float y) const;
+
+private:
+    /*!
+     *  @struct TraceEvent
+     *  @brief One timed scope, in microseconds since the profiler was created.
+     */
+    struct TraceEvent {
+        int64_t startMicros;        //!< When the scope started.
+        float durationMicros;       //!< How long it ran.
+        GuiProfileScope scope;      //!< The scope.
+    };
+
+    /*!
+     *  @struct TraceFrame
+     *  @brief The counters of one frame, in microseconds since the profiler was created.
+     */
+    struct TraceFrame {
+        int64_t endMicros;                                  //!< When the frame ended.
+        std::array<uint64_t, GuiCounterCount> counters;     //!< The counters of the frame.
+    };
+
+    /*!
+     *  @brief Adds a timed scope to the current frame and to the trace.
+     *  @param scope The scope.
+     *  @param start When the scope started.
+     *  @param end When the scope ended.
+     */
+    void record(GuiProfileScope scope, Clock::time_point start, Clock::time_point end);
+
+    /*!
+     *  @brief Returns the microseconds between the creation of the profiler and a time point.
+     *  @param time The time point.
+     */
+    int64_t sinceOrigin(Clock::time_point time) const;
+
+    bool enabled = false;                   //!< Whether scopes are timed and counters counted.
+    GuiFrameStats current;                  //!< The frame in progress.
+    std::vector<GuiFrameStats> history;     //!< Ring of completed frames.
+    size_t historyHead = 0;                 //!< Slot of history written by the next endFrame().
+    size_t historyCount = 0;                //!< Number of valid frames in history.
+    bool tracing = false;                   //!< Whether scopes are recorded as trace events.
+    size_t maxTraceEvents = 0;              //!< Number of trace events recorded before recording stops.
+    std::vector<TraceEvent> traceEvents;    //!< The recorded scopes.
+    std::vector<TraceFrame> traceFrames;    //!< The counters of each frame while tracing.
+    Clock::time_point origin;               //!< Time zero of the trace.
+};
@@ -0,0 +1,341 @@
+#include "ofxGuiJsonRemote.h"
+#include <algorithm>
+#include <cstddef>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#ifdef _WIN32
+    using NativeSocket = SOCKET;
+
+    bool startSockets() {
+        static const bool started = [] {
+            WSADATA data;
+            return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }();
+        return started;
+    }
+
+    void closeSocket(NativeSocket socket) {
+        closesocket(socket);
+    }
+#else
+    using NativeSocket = int;
+
+    bool startSockets() {
+        return true;
+    }
+
+    void closeSocket(NativeSocket socket) {
+        ::close(socket);
+    }
+#endif
+
+    NativeSocket toNative(intptr_t handle) {
+        return static_cast<NativeSocket>(handle);
+    }
+}
+
+void GuiRemoteBatch::clear(uint32_t sequence) {
+    GuiRemoteHeader header;
+    header.sequence = sequence;
+    bytes.resize(sizeof(header));
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    count = 0;
+}
+
+void GuiRemoteBatch::setSequence(uint32_t sequence) {
+    std::memcpy(bytes.data() + offsetof(GuiRemoteHeader, sequence), &sequence, sizeof(sequence));
+}
+
+bool GuiRemoteBatch::add(GuiRemoteOp op, std::string_view id, GuiEventType type, GuiEvent::Value value) {
+    GuiRemoteMessageHeader messageHeader;
+    if (id.size() > UINT16_MAX || count == UINT16_MAX || bytes.size() + sizeof(messageHeader) + id.size() > MaxBytes) {
+        return false;
+    }
+    messageHeader.op = static_cast<uint8_t>(op);
+    messageHeader.type = static_cast<uint8_t>(type);
+    messageHeader.idLength = static_cast<uint16_t>(id.size());
+    messageHeader.value = value;
+    const char* raw = reinterpret_cast<const char*>(&messageHeader);
+    bytes.insert(bytes.end(), raw, raw + sizeof(messageHeader));
+    bytes.insert(bytes.end(), id.begin(), id.end());
+    count++;
+
+    GuiRemoteHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    header.count = count;
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    return true;
+}
+
+bool GuiRemoteSocket::open(uint16_t port) {
+    close();
+    if (!startSockets()) {
+        ofLogError() << "Could not initialize sockets.";
+        return false;
+    }
+    NativeSocket native = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+#ifdef _WIN32
+    if (native == INVALID_SOCKET) {
+#else
+    if (native < 0) {
+#endif
+        ofLogError() << "Could not create remote control socket.";
+        return false;
+    }
+    handle = static_cast<intptr_t>(native);
+
+    // A large receive buffer absorbs bursts of sets between two frames
+    int bufferBytes = 1 << 20;
+    setsockopt(native, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&bufferBytes), sizeof(bufferBytes));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);  // Never reachable from other machines
+    address.sin_port = htons(port);
+    if (::bind(native, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        ofLogError() << "Could not bind remote control socket to 127.0.0.1:" << port;
+        close();
+        return false;
+    }
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    bool configured = ioctlsocket(native, FIONBIO, &nonBlocking) == 0;
+#else
+    int flags = fcntl(native, F_GETFL, 0);
+    bool configured = flags >= 0 && fcntl(native, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+    if (!configured) {
+        ofLogError() << "Could not make remote control socket non-blocking.";
+        close();
+        return false;
+    }
+
+    socklen_t addressLength = sizeof(address);
+    getsockname(native, reinterpret_cast<sockaddr*>(&address), &addressLength);
+    boundPort = ntohs(address.sin_port);
+    buffer.resize(65536);
+    return true;
+}
+
+void GuiRemoteSocket::close() {
+    if (handle != InvalidHandle) {
+        closeSocket(toNative(handle));
+    }
+    handle = InvalidHandle;
+    boundPort = 0;
+}
+
+bool GuiRemoteSocket::send(const GuiRemotePeer& peer, const char* data, size_t length) {
+    if (!isOpen()) {
+        return false;
+    }
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = peer.address;
+    address.sin_port = peer.port;
+    auto sent = ::sendto(toNative(handle), data, static_cast<int>(length), 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    return sent == static_cast<decltype(sent)>(length);
+}
+
+bool GuiRemoteSocket::receive(GuiRemotePeer& peer, const char*& data, size_t& length) {
+    if (!isOpen()) {
+        return false;
+    }
+    sockaddr_in address = {};
+    socklen_t addressLength = sizeof(address);
+    auto received = ::recvfrom(toNative(handle), buffer.data(), static_cast<int>(buffer.size()), 0,
+        reinterpret_cast<sockaddr*>(&address), &addressLength);
+    if (received < 0) {
+        return false;  // Nothing waiting; errors such as a closed peer port are not fatal either
+    }
+    peer.address = address.sin_addr.s_addr;
+    peer.port = address.sin_port;
+    data = buffer.data();
+    length = static_cast<size_t>(received);
+    return true;
+}
+
+GuiRemotePeer GuiRemoteSocket::loopback(uint16_t port) {
+    GuiRemotePeer peer;
+    peer.address = htonl(INADDR_LOOPBACK);
+    peer.port = htons(port);
+    return peer;
+}
+
+void GuiRemoteEndpoint::stop() {
+    socket.close();
+    batches.clear();
+    subscribers.clear();
+    changes.clear();
+    changeIndex.clear();
+}
+
+GuiRemoteEndpoint::PeerBatch& GuiRemoteEndpoint::replyBatch(const GuiRemotePeer& peer) {
+    for (auto& entry : batches) {
+        if (entry.peer == peer) {
+            return entry;
+        }
+    }
+    batches.emplace_back();
+    batches.back().peer = peer;
+    return batches.back();
+}
+
+void GuiRemoteEndpoint::stampReplies(const GuiRemotePeer& peer, uint32_t sequence) {
+    PeerBatch& entry = replyBatch(peer);
+    entry.sequence = sequence;
+    if (!entry.batch.empty()) {
+        entry.batch.setSequence(sequence);
+    }
+}
+
+void GuiRemoteEndpoint::append(PeerBatch& entry, GuiRemoteOp op, std::string_view id, GuiEventType type, GuiEvent::Value value) {
+    if (entry.batch.empty()) {
+        entry.batch.clear(entry.sequence);
+    }
+    if (!entry.batch.add(op, id, type, value)) {
+        send(entry);
+        entry.batch.clear(entry.sequence);
+        if (!entry.batch.add(op, id, type, value)) {
+            ofLogWarning() << "Remote control ID too long: " << id.substr(0, 64);
+        }
+    }
+}
+
+void GuiRemoteEndpoint::send(PeerBatch& entry) {
+    if (entry.batch.empty()) {
+        return;
+    }
+    if (socket.send(entry.peer, entry.batch.data(), entry.batch.byteSize())) {
+        stats.datagramsSent++;
+        stats.messagesSent += entry.batch.size();
+    }
+    entry.batch.clear(entry.sequence);
+}
+
+void GuiRemoteEndpoint::reply(const GuiRemotePeer& peer, GuiRemoteOp op, std::string_view id, GuiEventType type, GuiEvent::Value value) {
+    append(replyBatch(peer), op, id, type, value);
+}
+
+void GuiRemoteEndpoint::notify(const GuiEvent& event, std::string_view name) {
+    if (subscribers.empty() || event.type == GuiEventType::Trigger) {
+        return;
+    }
+    auto found = changeIndex.find(event.id);
+    if (found != changeIndex.end()) {
+        changes[found->second].event = event;  // Only the latest value of the frame is sent
+        return;
+    }
+    changeIndex.emplace(event.id, changes.size());
+    changes.push_back({ event, name });
+}
+
+void GuiRemoteEndpoint::updateSubscription(const GuiRemotePeer& peer, const GuiRemoteMessage& message) {
+    auto subscriber = std::find_if(subscribers.begin(), subscribers.end(), [&](const Subscriber& s) { return s.peer == peer; });
+    if (message.op == GuiRemoteOp::Subscribe) {
+        if (subscriber == subscribers.end()) {
+            subscribers.emplace_back();
+            subscriber = std::prev(subscribers.end());
+            subscriber->peer = peer;
+        }
+        if (message.id.empty()) {
+            subscriber->all = true;
+        }
+        else {
+            subscriber->ids.emplace(message.id);
+        }
+        return;
+    }
+    if (subscriber == subscribers.end()) {
+        return;
+    }
+    if (message.id.empty()) {
+        subscriber->all = false;
+        subscriber->ids.clear();
+    }
+    else {
+        subscriber->ids.erase(std::string(message.id));
+    }
+    if (!subscriber->all && subscriber->ids.empty()) {
+        subscribers.erase(subscriber);
+    }
+}
+
+size_t GuiRemoteEndpoint::flush() {
+    for (const auto& change : changes) {
+        for (const auto& subscriber : subscribers) {
+            if (subscriber.all || subscriber.ids.count(std::string(change.name))) {
+                append(replyBatch(subscriber.peer), GuiRemoteOp::Value, change.name, change.event.type, change.event.value);
+            }
+        }
+    }
+    changes.clear();
+    changeIndex.clear();
+
+    uint64_t sentBefore = stats.datagramsSent;
+    for (auto& entry : batches) {
+        send(entry);
+    }
+    return static_cast<size_t>(stats.datagramsSent - sentBefore);
+}
+
+bool GuiRemoteClient::connect(uint16_t port) {
+    app = GuiRemoteSocket::loopback(port);
+    batch.clear(sequence);
+    return socket.open(0);
+}
+
+void GuiRemoteClient::set(std::string_view id, bool value) {
+    GuiEvent::Value v;
+    v.toggle = value;
+    queue(GuiRemoteOp::Set, id, GuiEventType::Toggle, v);
+}
+
+void GuiRemoteClient::set(std::string_view id, float value) {
+    GuiEvent::Value v;
+    v.number = value;
+    queue(GuiRemoteOp::Set, id, GuiEventType::Float, v);
+}
+
+void GuiRemoteClient::set(std::string_view id, int32_t value) {
+    GuiEvent::Value v;
+    v.integer = value;
+    queue(GuiRemoteOp::Set, id, GuiEventType::Int, v);
+}
+
+void GuiRemoteClient::queue(GuiRemoteOp op, std::string_view id, GuiEventType type, GuiEvent::Value value) {
+    if (batch.add(op, id, type, value)) {
+        return;
+    }
+    sendFailed |= !socket.send(app, batch.data(), batch.byteSize());
+    batch.clear(++sequence);
+    batch.add(op, id, type, value);
+}
+
+bool GuiRemoteClient::send() {
+    bool sent = !sendFailed;
+    sendFailed = false;
+    if (!batch.empty()) {
+        sent = socket.send(app, batch.data(), batch.byteSize()) && sent;
+    }
+    batch.clear(++sequence);
+    return sent;
+}
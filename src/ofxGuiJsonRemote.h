@@ -0,0 +1,551 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonRemote.h
+
+    @brief    This file defines the remote control protocol of ofxGuiJson: a
+              compact binary framing of batched set/get messages sent over a
+              loopback UDP socket, the endpoint serving it inside the app and a
+              client for test rigs and other processes.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxGuiJsonEvent.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/*!
+ *  @brief Operation of a remote message.
+ */
+enum class GuiRemoteOp : uint8_t {
+    Set = 1,            //!< Client to app: sets the value of an element, as if the user changed it.
+    Get = 2,            //!< Client to app: asks for the value of an element, answered with Value.
+    Subscribe = 3,      //!< Client to app: sends Value for every change of an element, or of all elements if the ID is empty.
+    Unsubscribe = 4,    //!< Client to app: stops a Subscribe with the same ID.
+    Value = 5,          //!< App to client: the value of an element.
+    Error = 6           //!< App to client: the element of a Set or Get does not exist or has no value.
+};
+
+/*!
+ *  @struct GuiRemoteHeader
+ *  @brief Header of a datagram. The messages follow it, each a GuiRemoteMessageHeader and the ID bytes.
+ *         Fields are in the byte order of the machine, the protocol only runs over loopback.
+ */
+struct GuiRemoteHeader {
+    char magic[4] = { 'G', 'J', 'R', 'C' };    //!< Identifies a remote control datagram.
+    uint16_t version = 1;                       //!< Protocol version, bumped when the framing changes.
+    uint16_t count = 0;                         //!< Number of messages.
+    uint32_t sequence = 0;                      //!< Chosen by the client, echoed in the replies of the app.
+};
+
+/*!
+ *  @struct GuiRemoteMessageHeader
+ *  @brief Fixed part of a message, followed by idLength bytes of element ID.
+ */
+struct GuiRemoteMessageHeader {
+    uint8_t op = 0;                     //!< The GuiRemoteOp.
+    uint8_t type = 0;                   //!< The GuiEventType of the value.
+    uint16_t idLength = 0;              //!< Length of the ID.
+    GuiEvent::Value value = { false };  //!< The value, for Set and Value.
+};
+
+/*!
+ *  @struct GuiRemoteMessage
+ *  @brief A decoded message. The ID views the received datagram and is valid during the callback only.
+ */
+struct GuiRemoteMessage {
+    GuiRemoteOp op = GuiRemoteOp::Get;          //!< The operation.
+    GuiEventType type = GuiEventType::Toggle;   //!< The type of the value.
+    GuiEvent::Value value = { false };          //!< The value.
+    std::string_view id;                        //!< The ID of the element.
+
+    /*!
+     *  @brief Returns the value as a number, as GuiEvent::asFloat().
+     */
+    float asFloat() const {
+        GuiEvent event;
+        event.type = type;
+        event.value = value;
+        return event.asFloat();
+    }
+};
+
+/*!
+ *  @struct GuiRemotePeer
+ *  @brief Address of the other end of the socket.
+ */
+struct GuiRemotePeer {
+    uint32_t address = 0;   //!< IPv4 address, network byte order.
+    uint16_t port = 0;      //!< Port, network byte order.
+
+    bool operator==(const GuiRemotePeer& other) const { return address == other.address && port == other.port; }
+    bool operator!=(const GuiRemotePeer& other) const { return !(*this == other); }
+};
+
+/*!
+ *  @class GuiRemoteBatch
+ *  @brief Encodes messages into one datagram, reusing its buffer.
+ */
+class GuiRemoteBatch {
+public:
+    /*!
+     *  @brief Largest datagram written, below the UDP limit.
+     */
+    static constexpr size_t MaxBytes = 60000;
+
+    GuiRemoteBatch() { clear(); }
+
+    /*!
+     *  @brief Removes all messages, keeping the capacity.
+     *  @param sequence The sequence number of the next datagram.
+     */
+    void clear(uint32_t sequence = 0);
+
+    /*!
+     *  @brief Changes the sequence number of the datagram, keeping its messages.
+     *  @param sequence The sequence number.
+     */
+    void setSequence(uint32_t sequence);
+
+    /*!
+     *  @brief Appends a message.
+     *  @param op The operation.
+     *  @param id The ID of the element.
+     *  @param type The type of the value.
+     *  @param value The value.
+     *  @return False if the datagram is full or the ID is too long; send it and clear it first.
+     */
+    bool add(GuiRemoteOp op, std::string_view id, GuiEventType type = GuiEventType::Toggle, GuiEvent::Value value = { false });
+
+    /*!
+     *  @brief Returns the number of messages.
+     */
+    size_t size() const { return count; }
+
+    /*!
+     *  @brief Returns true if the batch has no message.
+     */
+    bool empty() const { return count == 0; }
+
+    /*!
+     *  @brief Returns the encoded datagram.
+     */
+    const char* data() const { return bytes.data(); }
+
+    /*!
+     *  @brief Returns the size of the encoded datagram.
+     */
+    size_t byteSize() const { return bytes.size(); }
+
+private:
+    std::vector<char> bytes;    //!< Header and messages.
+    uint16_t count = 0;         //!< Number of messages.
+};
+
+/*!
+ *  @brief Decodes a datagram, calling a handler for each message.
+ *  @param data The datagram.
+ *  @param length The size of the datagram.
+ *  @param sequence Set to the sequence number of the datagram.
+ *  @param handler Called as handler(const GuiRemoteMessage&).
+ *  @return False if the datagram is not a remote control datagram or is truncated. Messages
+ *          before the damage have been handled.
+ */
+template<typename Handler>
+bool decodeRemoteBatch(const char* data, size_t length, uint32_t& sequence, Handler&& handler) {
+    GuiRemoteHeader expected;
+    GuiRemoteHeader header;
+    if (length < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 || header.version != expected.version) {
+        return false;
+    }
+    sequence = header.sequence;
+    size_t offset = sizeof(header);
+    for (uint16_t m = 0; m < header.count; m++) {
+        GuiRemoteMessageHeader messageHeader;
+        if (length - offset < sizeof(messageHeader)) {
+            return false;
+        }
+        std::memcpy(&messageHeader, data + offset, sizeof(messageHeader));
+        offset += sizeof(messageHeader);
+        if (length - offset < messageHeader.idLength || messageHeader.type > static_cast<uint8_t>(GuiEventType::Choice)) {
+            return false;
+        }
+        GuiRemoteMessage message;
+        message.op = static_cast<GuiRemoteOp>(messageHeader.op);
+        message.type = static_cast<GuiEventType>(messageHeader.type);
+        message.value = messageHeader.value;
+        message.id = std::string_view(data + offset, messageHeader.idLength);
+        offset += messageHeader.idLength;
+        handler(message);
+    }
+    return true;
+}
+
+/*!
+ *  @class GuiRemoteSocket
+ *  @brief Non-blocking UDP socket bound to the loopback interface.
+ */
+class GuiRemoteSocket {
+public:
+    GuiRemoteSocket() = default;
+    ~GuiRemoteSocket() { close(); }
+    GuiRemoteSocket(const GuiRemoteSocket&) = delete;
+    GuiRemoteSocket& operator=(const GuiRemoteSocket&) = delete;
+
+    /*!
+     *  @brief Opens the socket on 127.0.0.1.
+     *  @param port The port, 0 for any free port.
+     *  @return False if the socket could not be created or the port is taken.
+     */
+    bool open(uint16_t port);
+
+    /*!
+     *  @brief Closes the socket.
+     */
+    void close();
+
+    /*!
+     *  @brief Returns true if the socket is open.
+     */
+    bool isOpen() const { return handle != InvalidHandle; }
+
+    /*!
+     *  @brief Returns the port the socket is bound to, in host byte order.
+     */
+    uint16_t getPort() const { return boundPort; }
+
+    /*!
+     *  @brief Sends a datagram.
+     *  @param peer The destination.
+     *  @param data The datagram.
+     *  @param length The size of the datagram.
+     *  @return False if the datagram was not sent.
+     */
+    bool send(const GuiRemotePeer& peer, const char* data, size_t length);
+
+    /*!
+     *  @brief Receives one waiting datagram without blocking.
+     *  @param peer Set to the sender.
+     *  @param data Set to the datagram, valid until the next call.
+     *  @param length Set to the size of the datagram.
+     *  @return False if no datagram is waiting.
+     */
+    bool receive(GuiRemotePeer& peer, const char*& data, size_t& length);
+
+    /*!
+     *  @brief Returns the peer for a port on 127.0.0.1.
+     *  @param port The port, in host byte order.
+     */
+    static GuiRemotePeer loopback(uint16_t port);
+
+private:
+    static constexpr intptr_t InvalidHandle = -1;
+
+    intptr_t handle = InvalidHandle;    //!< The native socket.
+    uint16_t boundPort = 0;             //!< The bound port, host byte order.
+    std::vector<char> buffer;           //!< The last received datagram.
+};
+
+/*!
+ *  @struct GuiRemoteStats
+ *  @brief Traffic counters of a GuiRemoteEndpoint.
+ */
+struct GuiRemoteStats {
+    uint64_t datagramsReceived = 0;     //!< Datagrams read from the socket.
+    uint64_t messagesReceived = 0;      //!< Messages decoded from them.
+    uint64_t malformed = 0;             //!< Datagrams rejected as not remote control datagrams or truncated.
+    uint64_t datagramsSent = 0;         //!< Replies and notifications sent.
+    uint64_t messagesSent = 0;          //!< Messages in them.
+};
+
+/*!
+ *  @class GuiRemoteEndpoint
+ *  @brief The app side of the protocol. poll() reads every waiting datagram and hands the messages
+ *         to the app; replies and the changes seen by notify() are sent by flush(), batched per peer.
+ *         Main thread only.
+ */
+class GuiRemoteEndpoint {
+public:
+    /*!
+     *  @brief Opens the endpoint.
+     *  @param port The port on 127.0.0.1.
+     *  @return False if the port could not be bound.
+     */
+    bool start(uint16_t port) { return socket.open(port); }
+
+    /*!
+     *  @brief Closes the endpoint and forgets the subscribers.
+     */
+    void stop();
+
+    /*!
+     *  @brief Returns true if the endpoint is open.
+     */
+    bool isRunning() const { return socket.isOpen(); }
+
+    /*!
+     *  @brief Returns the port of the endpoint.
+     */
+    uint16_t getPort() const { return socket.getPort(); }
+
+    /*!
+     *  @brief Handles every waiting datagram. Subscribe and Unsubscribe are handled here.
+     *  @param handler Called as handler(const GuiRemoteMessage&, const GuiRemotePeer&) for Set and Get.
+     *  @return The number of messages handled.
+     */
+    template<typename Handler>
+    size_t poll(Handler&& handler) {
+        size_t handled = 0;
+        GuiRemotePeer peer;
+        const char* data;
+        size_t length;
+        while (socket.receive(peer, data, length)) {
+            stats.datagramsReceived++;
+            uint32_t sequence = 0;
+            bool stamped = false;
+            bool valid = decodeRemoteBatch(data, length, sequence, [&](const GuiRemoteMessage& message) {
+                if (!stamped) {
+                    stampReplies(peer, sequence);  // Before any reply to this datagram is queued
+                    stamped = true;
+                }
+                handled++;
+                if (message.op == GuiRemoteOp::Subscribe || message.op == GuiRemoteOp::Unsubscribe) {
+                    updateSubscription(peer, message);
+                }
+                else {
+                    handler(message, peer);
+                }
+            });
+            if (!valid) {
+                stats.malformed++;
+            }
+        }
+        stats.messagesReceived += handled;
+        return handled;
+    }
+
+    /*!
+     *  @brief Queues a reply, sent by the next flush().
+     *  @param peer The client.
+     *  @param op GuiRemoteOp::Value or GuiRemoteOp::Error.
+     *  @param id The ID of the element.
+     *  @param type The type of the value.
+     *  @param value The value.
+     */
+    void reply(const GuiRemotePeer& peer, GuiRemoteOp op, std::string_view id, GuiEventType type = GuiEventType::Toggle,
+        GuiEvent::Value value = { false });
+
+    /*!
+     *  @brief Records the change of an element for the subscribers. Only the latest value of
+     *         each element is sent by the next flush().
+     *  @param event The change.
+     *  @param name The ID of the element, valid until the next flush().
+     */
+    void notify(const GuiEvent& event, std::string_view name);
+
+    /*!
+     *  @brief Sends the queued replies and the recorded changes.
+     *  @return The number of datagrams sent.
+     */
+    size_t flush();
+
+    /*!
+     *  @brief Returns the number of subscribed clients.
+     */
+    size_t getSubscriberCount() const { return subscribers.size(); }
+
+    /*!
+     *  @brief Returns the traffic counters.
+     */
+    const GuiRemoteStats& getStats() const { return stats; }
+
+private:
+    /*!
+     *  @struct PeerBatch
+     *  @brief The datagram being filled for one client.
+     */
+    struct PeerBatch {
+        GuiRemotePeer peer;         //!< The client.
+        GuiRemoteBatch batch;       //!< The messages.
+        uint32_t sequence = 0;      //!< Sequence of the latest datagram of the client, echoed in the replies.
+    };
+
+    /*!
+     *  @struct Subscriber
+     *  @brief A client receiving changes.
+     */
+    struct Subscriber {
+        GuiRemotePeer peer;                 //!< The client.
+        bool all = false;                   //!< Whether the client receives the changes of every element.
+        std::unordered_set<std::string> ids;    //!< The elements, when not all.
+    };
+
+    /*!
+     *  @struct Change
+     *  @brief The latest change of an element since the last flush().
+     */
+    struct Change {
+        GuiEvent event;             //!< The change.
+        std::string_view name;      //!< The ID of the element.
+    };
+
+    /*!
+     *  @brief Returns the batch of a client, adding it if needed.
+     *  @param peer The client.
+     */
+    PeerBatch& replyBatch(const GuiRemotePeer& peer);
+
+    /*!
+     *  @brief Makes the replies of a client echo the sequence of the datagram being handled. Replies
+     *         to earlier datagrams of the same frame that are still queued take the latest sequence.
+     *  @param peer The client.
+     *  @param sequence The sequence of the datagram.
+     */
+    void stampReplies(const GuiRemotePeer& peer, uint32_t sequence);
+
+    /*!
+     *  @brief Appends a message to the batch of a client, sending the batch first if it is full.
+     *  @param entry The batch of the client.
+     */
+    void append(PeerBatch& entry, GuiRemoteOp op, std::string_view id, GuiEventType type, GuiEvent::Value value);
+
+    /*!
+     *  @brief Sends the batch of a client if it has messages, and clears it.
+     *  @param entry The batch of the client.
+     */
+    void send(PeerBatch& entry);
+
+    /*!
+     *  @brief Handles a Subscribe or Unsubscribe message.
+     *  @param peer The client.
+     *  @param message The message.
+     */
+    void updateSubscription(const GuiRemotePeer& peer, const GuiRemoteMessage& message);
+
+    GuiRemoteSocket socket;                         //!< The loopback socket.
+    std::vector<PeerBatch> batches;                 //!< One batch per client seen, reused across frames.
+    std::vector<Subscriber> subscribers;            //!< The subscribed clients.
+    std::vector<Change> changes;                    //!< The changes since the last flush(), one per element.
+    std::unordered_map<GuiId, size_t> changeIndex;  //!< Index of each changed element in changes.
+    GuiRemoteStats stats;                           //!< Traffic counters.
+};
+
+/*!
+ *  @class GuiRemoteClient
+ *  @brief The client side of the protocol, for test rigs and other processes.
+ *
+ *  @code
+ *  GuiRemoteClient client;
+ *  client.connect(9100);
+ *  client.set("frequencySlider", 440.f);
+ *  client.get("muteToggle");
+ *  client.send();
+ *  client.receive([](const GuiRemoteMessage& message) { ... });
+ *  @endcode
+ */
+class GuiRemoteClient {
+public:
+    /*!
+     *  @brief Opens a socket on any free port, talking to an app on a port of 127.0.0.1.
+     *  @param port The port of the app.
+     *  @return False if the socket could not be opened.
+     */
+    bool connect(uint16_t port);
+
+    /*!
+     *  @brief Queues setting a toggle.
+     */
+    void set(std::string_view id, bool value);
+
+    /*!
+     *  @brief Queues setting a slider or float field.
+     */
+    void set(std::string_view id, float value);
+
+    /*!
+     *  @brief Queues setting an integer slider, integer field or dropdown option.
+     */
+    void set(std::string_view id, int32_t value);
+
+    /*!
+     *  @brief Queues a message. Full datagrams are sent as the batch grows.
+     *  @param op The operation.
+     *  @param id The ID of the element, empty to subscribe to all elements.
+     *  @param type The type of the value.
+     *  @param value The value.
+     */
+    void queue(GuiRemoteOp op, std::string_view id, GuiEventType type = GuiEventType::Toggle, GuiEvent::Value value = { false });
+
+    /*!
+     *  @brief Queues asking for the value of an element.
+     */
+    void get(std::string_view id) { queue(GuiRemoteOp::Get, id); }
+
+    /*!
+     *  @brief Queues subscribing to the changes of an element, or of all elements if the ID is empty.
+     */
+    void subscribe(std::string_view id = {}) { queue(GuiRemoteOp::Subscribe, id); }
+
+    /*!
+     *  @brief Sends the queued messages.
+     *  @return False if a datagram was not sent.
+     */
+    bool send();
+
+    /*!
+     *  @brief Returns the sequence number of the datagram being queued, echoed in the replies to it.
+     */
+    uint32_t getSequence() const { return sequence; }
+
+    /*!
+     *  @brief Returns the sequence number echoed by the last datagram received.
+     */
+    uint32_t getReplySequence() const { return replySequence; }
+
+    /*!
+     *  @brief Handles every waiting reply and notification without blocking.
+     *  @param handler Called as handler(const GuiRemoteMessage&).
+     *  @return The number of messages handled.
+     */
+    template<typename Handler>
+    size_t receive(Handler&& handler) {
+        size_t handled = 0;
+        GuiRemotePeer peer;
+        const char* data;
+        size_t length;
+        while (socket.receive(peer, data, length)) {
+            decodeRemoteBatch(data, length, replySequence, [&](const GuiRemoteMessage& message) {
+                handled++;
+                handler(message);
+            });
+        }
+        return handled;
+    }
+
+private:
+    GuiRemoteSocket socket;     //!< The client socket.
+    GuiRemotePeer app;          //!< The endpoint of the app.
+    GuiRemoteBatch batch;       //!< The queued messages.
+    uint32_t sequence = 0;      //!< Sequence of the next datagram.
+    uint32_t replySequence = 0; //!< Sequence echoed by the last datagram received.
+    bool sendFailed = false;    //!< Whether a full datagram failed to send since the last send().
+};
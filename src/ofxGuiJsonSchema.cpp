@@ -0,0 +1,423 @@
+#include "ofxGuiJsonSchema.h"
+#include "ofxGuiJsonModel.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // The configuration format. Blocks owned by ofxGuiJson reject unknown keys, so a misspelled
+    // key is reported instead of silently falling back to its default; the root, audio_settings
+    // and interaction blocks stay open for application settings.
+    const char* const builtinSchemaText = R"schema({
+    "$schema": "http://json-schema.org/draft-07/schema#",
+    "title": "ofxGuiJson configuration",
+    "type": "object",
+    "required": [ "panels" ],
+    "properties": {
+        "panels": { "type": "array", "items": { "$ref": "#/definitions/panel" } },
+        "background_color": {
+            "type": "array", "minItems": 3, "maxItems": 3,
+            "items": { "type": "integer", "minimum": 0, "maximum": 255 }
+        },
+        "audio_settings": {
+            "type": "object",
+            "properties": {
+                "outputChannels": { "type": "integer", "minimum": 0 },
+                "inputChannels": { "type": "integer", "minimum": 0 },
+                "sampleRate": { "type": "integer", "minimum": 0 },
+                "bufferSize": { "type": "integer", "minimum": 0 },
+                "minFrequency": { "type": "integer" },
+                "maxFrequency": { "type": "integer" },
+                "sensitivity": { "type": "integer" }
+            }
+        },
+        "interaction": {
+            "type": "object",
+            "properties": {
+                "enable": { "type": "boolean" },
+                "type": { "type": "string" }
+            }
+        },
+        "profiler": {
+            "type": "object",
+            "additionalProperties": false,
+            "properties": {
+                "enable": { "type": "boolean" },
+                "overlay": { "type": "boolean" },
+                "position": { "$ref": "#/definitions/position" },
+                "history_frames": { "type": "integer", "minimum": 1 },
+                "trace_file": { "type": "string" }
+            }
+        }
+    },
+    "definitions": {
+        "position": {
+            "type": "object",
+            "additionalProperties": false,
+            "properties": { "x": { "type": "number" }, "y": { "type": "number" } }
+        },
+        "size": {
+            "type": "object",
+            "additionalProperties": false,
+            "properties": {
+                "width": { "type": "number", "minimum": 0 },
+                "height": { "type": "number", "minimum": 0 }
+            }
+        },
+        "layout": { "type": "string", "enum": [ "column", "row", "grid" ] },
+        "panel": {
+            "type": "object",
+            "additionalProperties": false,
+            "required": [ "gui" ],
+            "properties": {
+                "gui": {
+                    "type": "object",
+                    "additionalProperties": false,
+                    "properties": {
+                        "title": { "type": "string" },
+                        "settings_file": { "type": "string" },
+                        "width": { "type": "number", "minimum": 0 },
+                        "height": { "type": "number", "minimum": 0 },
+                        "position": { "$ref": "#/definitions/position" },
+                        "layout": { "$ref": "#/definitions/layout" },
+                        "gap": { "type": "number", "minimum": 0 },
+                        "padding": { "type": "number", "minimum": 0 },
+                        "columns": { "type": "integer", "minimum": 1 }
+                    }
+                },
+                "elements": { "type": "array", "items": { "$ref": "#/definitions/element" } }
+            }
+        },
+        "element": {
+            "type": "object",
+            "additionalProperties": false,
+            "required": [ "type" ],
+            "properties": {
+                "type": {
+                    "type": "string",
+                    "enum": [ "toggle", "label", "virtual_list", "slider", "int_slider", "button", "dropdown", "float_field", "int_field", "group" ]
+                },
+                "id": { "type": "string" },
+                "label": { "type": "string" },
+                "action": { "type": "string" },
+                "position": { "$ref": "#/definitions/position" },
+                "size": { "$ref": "#/definitions/size" },
+                "default": { "type": [ "boolean", "number", "string" ] },
+                "min": { "type": "number" },
+                "max": { "type": "number" },
+                "max_rate": { "type": "number", "minimum": 0 },
+                "options": { "type": "array", "items": { "type": "string" } },
+                "bind": { "type": [ "string", "array" ], "items": { "type": "string" } },
+                "format": { "type": "string" },
+                "audio_parameter": { "type": "string" },
+                "smoothing_ms": { "type": "number", "minimum": 0 },
+                "row_type": { "type": "string", "enum": [ "toggle", "label" ] },
+                "visible_rows": { "type": "integer", "minimum": 1 },
+                "layout": { "$ref": "#/definitions/layout" },
+                "gap": { "type": "number", "minimum": 0 },
+                "padding": { "type": "number", "minimum": 0 },
+                "columns": { "type": "integer", "minimum": 1 },
+                "elements": { "type": "array", "items": { "$ref": "#/definitions/element" } }
+            }
+        }
+    }
+})schema";
+
+    uint8_t parseTypeBit(const std::string& name) {
+        if (name == "null") return GuiSchema::Null;
+        if (name == "boolean") return GuiSchema::Boolean;
+        if (name == "integer") return GuiSchema::Integer;
+        if (name == "number") return GuiSchema::Number;
+        if (name == "string") return GuiSchema::String;
+        if (name == "array") return GuiSchema::Array;
+        if (name == "object") return GuiSchema::Object;
+        return 0;
+    }
+
+    std::string describeTypes(uint8_t types) {
+        static const char* const names[] = { "null", "boolean", "integer", "number", "string", "array", "object" };
+        std::string text;
+        for (int bit = 0; bit < 7; bit++) {
+            if (types & (1 << bit)) {
+                text += text.empty() ? "" : " or ";
+                text += names[bit];
+            }
+        }
+        return text;
+    }
+
+    void appendToken(std::string& pointer, const std::string& token) {
+        pointer += '/';
+        for (char c : token) {
+            if (c == '~') pointer += "~0";
+            else if (c == '/') pointer += "~1";
+            else pointer += c;
+        }
+    }
+
+    void walk(GuiSchemaValidator& validator, const json& node) {
+        if (node.is_object()) {
+            validator.beginObject();
+            for (auto it = node.begin(); it != node.end(); ++it) {
+                validator.key(it.key());
+                walk(validator, it.value());
+            }
+            validator.endObject();
+        }
+        else if (node.is_array()) {
+            validator.beginArray();
+            for (const auto& item : node) {
+                walk(validator, item);
+            }
+            validator.endArray();
+        }
+        else {
+            validator.value(node);
+        }
+    }
+}
+
+bool GuiSchema::compile(const json& definition) {
+    nodes.clear();
+    references.clear();
+    failed = false;
+    compileNode(definition, definition);
+    if (failed) {
+        nodes.clear();
+    }
+    return !failed;
+}
+
+uint32_t GuiSchema::compileNode(const json& definition, const json& document) {
+    const json& reference = readJsonChild(definition, "$ref");
+    if (reference.is_string()) {
+        const std::string& path = reference.get_ref<const std::string&>();
+        auto found = references.find(path);
+        if (found != references.end()) {
+            return found->second;
+        }
+        const std::string prefix = "#/definitions/";
+        std::string name = path.compare(0, prefix.size(), prefix) == 0 ? path.substr(prefix.size()) : std::string();
+        const json& target = readJsonChild(readJsonChild(document, "definitions"), name.c_str());
+        if (!target.is_object()) {
+            ofLogError() << "Cannot resolve schema reference: " << path;
+            failed = true;
+            return NoNode;
+        }
+        // Registered before the target is compiled, so recursive definitions resolve to it
+        uint32_t index = static_cast<uint32_t>(nodes.size());
+        references.emplace(path, index);
+        nodes.emplace_back();
+        uint32_t compiled = compileNode(target, document);
+        if (compiled != NoNode) {
+            nodes[index] = nodes[compiled];
+        }
+        return index;
+    }
+
+    uint32_t index = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+    Node node;
+
+    const json& types = readJsonChild(definition, "type");
+    if (types.is_string() || types.is_array()) {
+        node.types = 0;
+        for (const auto& type : types.is_array() ? types : json::array({ types })) {
+            node.types |= type.is_string() ? parseTypeBit(type.get<std::string>()) : 0;
+        }
+    }
+
+    const json& properties = readJsonChild(definition, "properties");
+    if (properties.is_object()) {
+        if (properties.size() > 64) {
+            ofLogError() << "Schema objects are limited to 64 properties.";
+            failed = true;
+            return NoNode;
+        }
+        for (auto it = properties.begin(); it != properties.end(); ++it) {
+            Property property;
+            property.name = it.key();
+            property.node = compileNode(it.value(), document);
+            node.propertyIndex.emplace(property.name, static_cast<uint32_t>(node.properties.size()));
+            node.properties.push_back(std::move(property));
+        }
+    }
+    for (const auto& name : readJsonChild(definition, "required")) {
+        auto found = name.is_string() ? node.propertyIndex.find(name.get<std::string>()) : node.propertyIndex.end();
+        if (found != node.propertyIndex.end()) {
+            node.properties[found->second].required = true;
+        }
+        else {
+            ofLogWarning() << "Ignoring required key without a schema: " << name.dump();
+        }
+    }
+    node.additionalProperties = readJsonValue<bool>(definition, "additionalProperties", true);
+
+    const json& items = readJsonChild(definition, "items");
+    if (items.is_object()) {
+        node.items = compileNode(items, document);
+    }
+    node.minItems = readJsonValue<uint32_t>(definition, "minItems", node.minItems);
+    node.maxItems = readJsonValue<uint32_t>(definition, "maxItems", node.maxItems);
+    node.minimum = readJsonValue<double>(definition, "minimum", node.minimum);
+    node.maximum = readJsonValue<double>(definition, "maximum", node.maximum);
+    node.enumValues = readJsonValue<std::vector<std::string>>(definition, "enum", node.enumValues);
+
+    nodes[index] = std::move(node);  // Children were compiled first and may have moved the table
+    return index;
+}
+
+const json& GuiSchema::builtinDefinition() {
+    static const json definition = json::parse(builtinSchemaText);
+    return definition;
+}
+
+const GuiSchema& GuiSchema::builtin() {
+    static const GuiSchema schema = [] {
+        GuiSchema compiled;
+        compiled.compile(builtinDefinition());
+        return compiled;
+    }();
+    return schema;
+}
+
+void GuiSchemaValidator::reset() {
+    frames.clear();
+    pointer.clear();
+    currentKey.clear();
+    errors.clear();
+    errorCount = 0;
+}
+
+void GuiSchemaValidator::addError(std::string message) {
+    errorCount++;
+    if (errors.size() < MaxErrors) {
+        errors.push_back({ pointer, std::move(message) });
+    }
+}
+
+uint32_t GuiSchemaValidator::enterValue() {
+    if (frames.empty()) {
+        pointer.clear();
+        return schema.root();
+    }
+    Frame& parent = frames.back();
+    if (parent.isArray) {
+        appendToken(pointer, std::to_string(parent.count++));
+        return parent.node != GuiSchema::NoNode ? schema.node(parent.node).items : GuiSchema::NoNode;
+    }
+    appendToken(pointer, currentKey);
+    if (parent.node == GuiSchema::NoNode) {
+        return GuiSchema::NoNode;
+    }
+    const GuiSchema::Node& node = schema.node(parent.node);
+    auto found = node.propertyIndex.find(currentKey);
+    if (found == node.propertyIndex.end()) {
+        if (!node.additionalProperties) {
+            addError("unknown key '" + currentKey + "'");
+        }
+        return GuiSchema::NoNode;
+    }
+    parent.seen |= uint64_t(1) << found->second;
+    return node.properties[found->second].node;
+}
+
+bool GuiSchemaValidator::checkType(uint32_t node, uint8_t type, bool integral) {
+    uint8_t accepted = schema.node(node).types;
+    bool matches = (accepted & type) || (type == GuiSchema::Integer && (accepted & GuiSchema::Number)) ||
+        (type == GuiSchema::Number && integral && (accepted & GuiSchema::Integer));
+    if (!matches) {
+        addError("expected " + describeTypes(accepted) + ", found " + describeTypes(type));
+    }
+    return matches;
+}
+
+void GuiSchemaValidator::value(const json& value) {
+    size_t start = pointer.size();
+    uint32_t index = enterValue();
+    if (index != GuiSchema::NoNode) {
+        uint8_t type = GuiSchema::Null;
+        bool integral = false;
+        switch (value.type()) {
+        case json::value_t::boolean: type = GuiSchema::Boolean; break;
+        case json::value_t::number_integer:
+        case json::value_t::number_unsigned: type = GuiSchema::Integer; break;
+        case json::value_t::number_float: {
+            double number = value.get<double>();
+            type = GuiSchema::Number;
+            integral = std::isfinite(number) && std::floor(number) == number;
+            break;
+        }
+        case json::value_t::string: type = GuiSchema::String; break;
+        default: break;
+        }
+
+        const GuiSchema::Node& node = schema.node(index);
+        if (checkType(index, type, integral)) {
+            if (value.is_number()) {
+                double number = value.get<double>();
+                if (number < node.minimum) {
+                    addError(value.dump() + " is below the minimum " + ofToString(node.minimum));
+                }
+                else if (number > node.maximum) {
+                    addError(value.dump() + " is above the maximum " + ofToString(node.maximum));
+                }
+            }
+            else if (value.is_string() && !node.enumValues.empty()) {
+                const std::string& text = value.get_ref<const std::string&>();
+                if (std::find(node.enumValues.begin(), node.enumValues.end(), text) == node.enumValues.end()) {
+                    addError(value.dump() + " is not one of " + ofJoinString(node.enumValues, ", "));
+                }
+            }
+        }
+    }
+    pointer.resize(start);
+}
+
+void GuiSchemaValidator::beginContainer(bool isArray) {
+    size_t start = pointer.size();
+    uint32_t index = enterValue();
+    if (index != GuiSchema::NoNode && !checkType(index, isArray ? GuiSchema::Array : GuiSchema::Object, false)) {
+        index = GuiSchema::NoNode;  // The contents of a value of the wrong type are not checked
+    }
+    frames.push_back({ index, isArray, 0, 0, start });
+}
+
+void GuiSchemaValidator::endContainer() {
+    if (frames.empty()) {
+        return;
+    }
+    const Frame& frame = frames.back();
+    if (frame.node != GuiSchema::NoNode) {
+        const GuiSchema::Node& node = schema.node(frame.node);
+        if (frame.isArray) {
+            if (frame.count < node.minItems || frame.count > node.maxItems) {
+                addError("expected " + ofToString(node.minItems) + (node.maxItems != node.minItems ?
+                    " to " + ofToString(node.maxItems) : std::string()) + " items, found " + ofToString(frame.count));
+            }
+        }
+        else {
+            for (size_t p = 0; p < node.properties.size(); p++) {
+                if (node.properties[p].required && !(frame.seen & (uint64_t(1) << p))) {
+                    addError("missing required key '" + node.properties[p].name + "'");
+                }
+            }
+        }
+    }
+    pointer.resize(frame.pointerStart);
+    frames.pop_back();
+}
+
+bool GuiSchemaValidator::validate(const json& document) {
+    reset();
+    walk(*this, document);
+    return isValid();
+}
+
+void GuiSchemaValidator::logErrors(const std::string& source) const {
+    for (const auto& error : errors) {
+        ofLogError() << source << "#" << error.pointer << ": " << error.message;
+    }
+    if (errorCount > errors.size()) {
+        ofLogError() << source << ": " << errorCount - errors.size() << " more errors.";
+    }
+}
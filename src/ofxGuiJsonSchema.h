@@ -0,0 +1,271 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonSchema.h
+
+    @brief    This file defines the schema of the ofxGuiJson configuration
+              format and its validator. The schema is written as a JSON Schema
+              and compiled once into a flat node table; the validator checks a
+              configuration against it from the parse events of the loader, in
+              the same pass that builds the model.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include "ofMain.h"
+#include <json.hpp>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using json = nlohmann::json;
+
+/*!
+ *  @struct GuiSchemaError
+ *  @brief A value that does not match the schema.
+ */
+struct GuiSchemaError {
+    std::string pointer;    //!< JSON pointer to the value, e.g. /panels/0/elements/3/type; empty for the document.
+    std::string message;    //!< What is wrong with it.
+};
+
+/*!
+ *  @class GuiSchema
+ *  @brief A JSON Schema compiled into a flat table of nodes.
+ *
+ *  The supported keywords are type, properties, required, additionalProperties, items, enum
+ *  (of strings), minimum, maximum, minItems, maxItems, and $ref to #/definitions. Other
+ *  keywords, such as title and description, are ignored.
+ */
+class GuiSchema {
+public:
+    /*!
+     *  @brief Index of a node; NoNode when a value is not checked.
+     */
+    static constexpr uint32_t NoNode = UINT32_MAX;
+
+    /*!
+     *  @brief JSON types, as a bit mask.
+     */
+    enum TypeBits : uint8_t {
+        Null = 1 << 0,
+        Boolean = 1 << 1,
+        Integer = 1 << 2,
+        Number = 1 << 3,    //!< Accepts integers too.
+        String = 1 << 4,
+        Array = 1 << 5,
+        Object = 1 << 6,
+        AnyType = 0x7f
+    };
+
+    /*!
+     *  @struct Property
+     *  @brief A property of an object node.
+     */
+    struct Property {
+        std::string name;           //!< The key.
+        uint32_t node = NoNode;     //!< The schema of the value.
+        bool required = false;      //!< Whether the key must be present.
+    };
+
+    /*!
+     *  @struct Node
+     *  @brief The compiled schema of one value.
+     */
+    struct Node {
+        uint8_t types = AnyType;                    //!< The accepted types.
+        std::vector<Property> properties;           //!< Known keys of objects, at most 64.
+        std::unordered_map<std::string, uint32_t> propertyIndex;    //!< Key to index in properties.
+        bool additionalProperties = true;           //!< Whether objects may have other keys.
+        uint32_t items = NoNode;                    //!< The schema of array items, NoNode for any.
+        uint32_t minItems = 0;                      //!< Fewest array items.
+        uint32_t maxItems = UINT32_MAX;             //!< Most array items.
+        double minimum = -std::numeric_limits<double>::infinity();  //!< Lowest number.
+        double maximum = std::numeric_limits<double>::infinity();   //!< Highest number.
+        std::vector<std::string> enumValues;        //!< Accepted strings, empty for any.
+    };
+
+    /*!
+     *  @brief Compiles a JSON Schema, replacing the current nodes.
+     *  @param definition The schema.
+     *  @return False if the schema uses a $ref that cannot be resolved or an object has more than 64 properties.
+     */
+    bool compile(const json& definition);
+
+    /*!
+     *  @brief Returns the node of the document.
+     */
+    uint32_t root() const { return nodes.empty() ? NoNode : 0; }
+
+    /*!
+     *  @brief Returns a node.
+     *  @param index The index of the node, not NoNode.
+     */
+    const Node& node(uint32_t index) const { return nodes[index]; }
+
+    /*!
+     *  @brief Returns the schema of the ofxGuiJson configuration format, compiled on first use.
+     */
+    static const GuiSchema& builtin();
+
+    /*!
+     *  @brief Returns the JSON Schema of the ofxGuiJson configuration format, e.g. to save it for an editor.
+     */
+    static const json& builtinDefinition();
+
+private:
+    /*!
+     *  @brief Compiles a schema object into a node.
+     *  @param definition The schema object.
+     *  @param document The whole schema, for $ref.
+     *  @return The index of the node, NoNode on failure.
+     */
+    uint32_t compileNode(const json& definition, const json& document);
+
+    std::vector<Node> nodes;                                //!< The compiled nodes, the document first.
+    std::unordered_map<std::string, uint32_t> references;   //!< Node of each compiled $ref.
+    bool failed = false;                                    //!< Whether compileNode() reported an error.
+};
+
+/*!
+ *  @class GuiSchemaValidator
+ *  @brief Checks a document against a GuiSchema from its parse events, in document order. Every
+ *         error is recorded with its JSON pointer; a subtree of the wrong type is not checked further.
+ */
+class GuiSchemaValidator {
+public:
+    /*!
+     *  @brief Most errors recorded, further errors are only counted.
+     */
+    static constexpr size_t MaxErrors = 1000;
+
+    /*!
+     *  @brief Creates a validator for a schema, which must outlive it.
+     *  @param compiled The compiled schema.
+     */
+    explicit GuiSchemaValidator(const GuiSchema& compiled = GuiSchema::builtin()) : schema(compiled) {}
+
+    /*!
+     *  @brief Forgets the errors and the position, to validate another document.
+     */
+    void reset();
+
+    /*!
+     *  @brief Handles a scalar value.
+     *  @param value The value.
+     */
+    void value(const json& value);
+
+    /*!
+     *  @brief Handles the start of an object.
+     */
+    void beginObject() { beginContainer(false); }
+
+    /*!
+     *  @brief Handles a key of the current object.
+     *  @param name The key.
+     */
+    void key(const std::string& name) { currentKey = name; }
+
+    /*!
+     *  @brief Handles the end of the current object.
+     */
+    void endObject() { endContainer(); }
+
+    /*!
+     *  @brief Handles the start of an array.
+     */
+    void beginArray() { beginContainer(true); }
+
+    /*!
+     *  @brief Handles the end of the current array.
+     */
+    void endArray() { endContainer(); }
+
+    /*!
+     *  @brief Validates a whole document, as if its parse events were fed with the keys of each
+     *         object in the order of the json object.
+     *  @param document The document.
+     *  @return True if the document matches the schema.
+     */
+    bool validate(const json& document);
+
+    /*!
+     *  @brief Returns true if no error was found so far.
+     */
+    bool isValid() const { return errorCount == 0; }
+
+    /*!
+     *  @brief Returns the recorded errors, in document order.
+     */
+    const std::vector<GuiSchemaError>& getErrors() const { return errors; }
+
+    /*!
+     *  @brief Returns the number of errors, including those past MaxErrors.
+     */
+    size_t getErrorCount() const { return errorCount; }
+
+    /*!
+     *  @brief Logs every recorded error.
+     *  @param source The name of the document, e.g. its path, prefixed to each pointer.
+     */
+    void logErrors(const std::string& source) const;
+
+private:
+    /*!
+     *  @struct Frame
+     *  @brief An open object or array.
+     */
+    struct Frame {
+        uint32_t node;          //!< The schema of the container, NoNode if it is not checked.
+        bool isArray;           //!< Whether the container is an array.
+        uint32_t count;         //!< Number of items read, arrays only.
+        uint64_t seen;          //!< Bit mask of the known properties read, objects only.
+        size_t pointerStart;    //!< Length of the pointer before the token of the container.
+    };
+
+    /*!
+     *  @brief Appends the token of the next value to the pointer and returns its schema.
+     */
+    uint32_t enterValue();
+
+    /*!
+     *  @brief Checks the type of a value against a node, recording an error on mismatch.
+     *  @return False on mismatch.
+     */
+    bool checkType(uint32_t node, uint8_t type, bool integral);
+
+    /*!
+     *  @brief Enters an object or array.
+     *  @param isArray True for arrays.
+     */
+    void beginContainer(bool isArray);
+
+    /*!
+     *  @brief Checks the required properties or the item count of the current container and leaves it.
+     */
+    void endContainer();
+
+    /*!
+     *  @brief Records an error at the current pointer.
+     *  @param message What is wrong.
+     */
+    void addError(std::string message);
+
+    const GuiSchema& schema;            //!< The schema.
+    std::vector<Frame> frames;          //!< The open containers.
+    std::string pointer;                //!< JSON pointer of the current value.
+    std::string currentKey;             //!< The last key read.
+    std::vector<GuiSchemaError> errors; //!< The recorded errors.
+    size_t errorCount = 0;              //!< Number of errors found.
+};
@@ -0,0 +1,274 @@
+#include "ofxGuiJsonSnapshot.h"
+#include "ofxGuiJsonModel.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace {
+    const char* typeName(GuiEventType type) {
+        switch (type) {
+        case GuiEventType::Toggle: return "toggle";
+        case GuiEventType::Float: return "float";
+        case GuiEventType::Int: return "int";
+        case GuiEventType::Trigger: return "trigger";
+        case GuiEventType::Choice: return "choice";
+        }
+        return "unknown";
+    }
+
+    bool parseTypeName(const std::string& name, GuiEventType& type) {
+        static const GuiEventType types[] = { GuiEventType::Toggle, GuiEventType::Float, GuiEventType::Int, GuiEventType::Choice };
+        for (GuiEventType candidate : types) {
+            if (name == typeName(candidate)) {
+                type = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool isValueType(uint8_t type) {
+        return type <= static_cast<uint8_t>(GuiEventType::Choice) && type != static_cast<uint8_t>(GuiEventType::Trigger);
+    }
+}
+
+GuiSnapshot::Format GuiSnapshot::formatOf(const std::string& path) {
+    std::string extension = ofToLower(std::filesystem::path(path).extension().string());
+    if (extension == ".json") {
+        return Format::Json;
+    }
+    if (extension == ".xml") {
+        return Format::Xml;
+    }
+    return Format::Binary;
+}
+
+const GuiSnapshot::Entry* GuiSnapshot::find(const std::string& id) const {
+    for (const auto& entry : entries) {
+        if (entry.active && entry.id == id) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+std::string GuiSnapshot::toBinary() const {
+    GuiSnapshotHeader header;
+    std::string data(sizeof(header), '\0');
+    for (const auto& entry : entries) {
+        if (!entry.active) {
+            continue;
+        }
+        EntryHeader entryHeader;
+        entryHeader.type = static_cast<uint8_t>(entry.type);
+        entryHeader.idLength = static_cast<uint16_t>(std::min<size_t>(entry.id.size(), UINT16_MAX));
+        entryHeader.value = entry.value;
+        data.append(reinterpret_cast<const char*>(&entryHeader), sizeof(entryHeader));
+        data.append(entry.id, 0, entryHeader.idLength);
+        header.entryCount++;
+    }
+    header.payloadBytes = data.size() - sizeof(header);
+    header.payloadHash = guiHash(data.data() + sizeof(header), header.payloadBytes);
+    std::memcpy(&data[0], &header, sizeof(header));
+    return data;
+}
+
+bool GuiSnapshot::fromBinary(const char* data, size_t length) {
+    GuiSnapshotHeader expected;
+    GuiSnapshotHeader header;
+    if (length < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 || header.version != expected.version ||
+        header.payloadBytes != length - sizeof(header)) {
+        return false;
+    }
+    const char* payload = data + sizeof(header);
+    if (header.payloadHash != guiHash(payload, header.payloadBytes)) {
+        return false;  // Damaged, e.g. by a disk error
+    }
+
+    if (header.entryCount > header.payloadBytes / sizeof(EntryHeader)) {
+        return false;  // More entries than the payload can hold, do not reserve for them
+    }
+
+    std::vector<Entry> read;
+    read.reserve(static_cast<size_t>(header.entryCount));
+    size_t offset = 0;
+    for (uint64_t e = 0; e < header.entryCount; e++) {
+        EntryHeader entryHeader;
+        if (header.payloadBytes - offset < sizeof(entryHeader)) {
+            return false;
+        }
+        std::memcpy(&entryHeader, payload + offset, sizeof(entryHeader));
+        offset += sizeof(entryHeader);
+        if (header.payloadBytes - offset < entryHeader.idLength || !isValueType(entryHeader.type)) {
+            return false;
+        }
+        Entry entry;
+        entry.id.assign(payload + offset, entryHeader.idLength);
+        entry.type = static_cast<GuiEventType>(entryHeader.type);
+        entry.value = entryHeader.value;
+        offset += entryHeader.idLength;
+        read.push_back(std::move(entry));
+    }
+    entries = std::move(read);
+    return true;
+}
+
+json GuiSnapshot::toJson() const {
+    json node;
+    node["version"] = GuiSnapshotHeader().version;
+    json& list = node["elements"];
+    list = json::array();
+    for (const auto& entry : entries) {
+        if (!entry.active) {
+            continue;
+        }
+        json element = { { "id", entry.id }, { "type", typeName(entry.type) } };
+        switch (entry.type) {
+        case GuiEventType::Toggle: element["value"] = entry.value.toggle; break;
+        case GuiEventType::Float: element["value"] = entry.value.number; break;
+        default: element["value"] = entry.value.integer; break;
+        }
+        list.push_back(element);
+    }
+    return node;
+}
+
+bool GuiSnapshot::fromJson(const json& node) {
+    const json& list = readJsonChild(node, "elements");
+    if (!list.is_array()) {
+        return false;
+    }
+    entries.clear();
+    for (const auto& element : list) {
+        Entry entry;
+        entry.id = readJsonValue<std::string>(element, "id", "");
+        const json& value = readJsonChild(element, "value");
+        if (entry.id.empty() || !parseTypeName(readJsonValue<std::string>(element, "type", ""), entry.type) ||
+            !(value.is_boolean() || value.is_number())) {
+            ofLogWarning() << "Skipping an invalid snapshot entry: " << element.dump();
+            continue;
+        }
+        float number = value.is_boolean() ? (value.get<bool>() ? 1.f : 0.f) : value.get<float>();
+        switch (entry.type) {
+        case GuiEventType::Toggle: entry.value.toggle = number != 0; break;
+        case GuiEventType::Float: entry.value.number = number; break;
+        default: entry.value.integer = static_cast<int32_t>(number); break;
+        }
+        entries.push_back(std::move(entry));
+    }
+    return true;
+}
+
+std::string GuiSnapshot::toXml() const {
+    ofXml xml;
+    ofXml root = xml.appendChild("snapshot");
+    root.setAttribute("version", GuiSnapshotHeader().version);
+    for (const auto& entry : entries) {
+        if (!entry.active) {
+            continue;
+        }
+        ofXml element = root.appendChild("element");
+        element.setAttribute("id", entry.id);
+        element.setAttribute("type", std::string(typeName(entry.type)));
+        switch (entry.type) {
+        case GuiEventType::Toggle: element.setAttribute("value", entry.value.toggle ? 1 : 0); break;
+        case GuiEventType::Float: element.setAttribute("value", entry.value.number); break;
+        default: element.setAttribute("value", entry.value.integer); break;
+        }
+    }
+    return xml.toString();
+}
+
+bool GuiSnapshot::fromXml(const std::string& text) {
+    ofXml xml;
+    if (!xml.parse(text)) {
+        return false;
+    }
+    ofXml root = xml.getChild("snapshot");
+    if (!root) {
+        return false;
+    }
+    entries.clear();
+    for (const auto& element : root.getChildren("element")) {
+        Entry entry;
+        entry.id = element.getAttribute("id").getValue();
+        auto value = element.getAttribute("value");
+        if (entry.id.empty() || !parseTypeName(element.getAttribute("type").getValue(), entry.type) || !value) {
+            ofLogWarning() << "Skipping an invalid snapshot entry: " << entry.id;
+            continue;
+        }
+        switch (entry.type) {
+        case GuiEventType::Toggle: entry.value.toggle = value.getIntValue() != 0; break;
+        case GuiEventType::Float: entry.value.number = value.getFloatValue(); break;
+        default: entry.value.integer = value.getIntValue(); break;
+        }
+        entries.push_back(std::move(entry));
+    }
+    return true;
+}
+
+bool GuiSnapshot::save(const std::string& path, Format format) const {
+    std::string data;
+    switch (format) {
+    case Format::Json: data = toJson().dump(4); break;
+    case Format::Xml: data = toXml(); break;
+    default: data = toBinary(); break;
+    }
+
+    // Write next to the file and rename, so a crash never leaves a partial snapshot
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), data.size());
+        if (!out) {
+            ofLogError() << "Could not write snapshot: " << tempPath;
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        ofLogError() << "Could not write snapshot: " << path << " (" << error.message() << ")";
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool GuiSnapshot::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        ofLogError() << "Failed to open snapshot: " << path;
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    GuiSnapshotHeader header;
+    if (data.size() >= sizeof(header.magic) && std::memcmp(data.data(), header.magic, sizeof(header.magic)) == 0) {
+        if (!fromBinary(data.data(), data.size())) {
+            ofLogError() << "Ignoring damaged or incompatible snapshot: " << path;
+            return false;
+        }
+        return true;
+    }
+    size_t first = data.find_first_not_of(" \t\r\n");
+    if (first != std::string::npos && data[first] == '<') {
+        if (!fromXml(data)) {
+            ofLogError() << "Failed to parse XML snapshot: " << path;
+            return false;
+        }
+        return true;
+    }
+    json node = json::parse(data, nullptr, false);
+    if (node.is_discarded() || !fromJson(node)) {
+        ofLogError() << "Failed to parse JSON snapshot: " << path;
+        return false;
+    }
+    return true;
+}
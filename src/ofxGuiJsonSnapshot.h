@@ -0,0 +1,149 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonSnapshot.h
+
+    @brief    This file defines GuiSnapshot, the values of all elements at one
+              point in time, and its binary, JSON and XML file formats. The
+              binary format is meant for frequent autosaves, the others for
+              people reading or editing the values.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxGuiJsonEvent.h"
+#include <json.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+/*!
+ *  @struct GuiSnapshotHeader
+ *  @brief Header of a binary snapshot file. The entries follow it, each an EntryHeader and the ID bytes.
+ */
+struct GuiSnapshotHeader {
+    char magic[4] = { 'G', 'J', 'S', 'N' };    //!< Identifies a snapshot file.
+    uint32_t version = 1;                       //!< Layout version, bumped when the snapshot format changes.
+    uint64_t entryCount = 0;                    //!< Number of entries.
+    uint64_t payloadBytes = 0;                  //!< Size of the entries.
+    uint64_t payloadHash = 0;                   //!< FNV-1a hash of the entries, to reject damaged files.
+};
+
+/*!
+ *  @struct GuiSnapshot
+ *  @brief The values of the elements, by element ID. Buttons have no value and are not included.
+ *
+ *  ofxGuiJson never changes a snapshot it has handed out: the next change copies it first, so a
+ *  snapshot can be read or saved on another thread while the GUI keeps changing.
+ */
+struct GuiSnapshot {
+    /*!
+     *  @brief File formats of a snapshot.
+     */
+    enum class Format {
+        Binary,     //!< Compact, for autosaves.
+        Json,       //!< Readable, for people.
+        Xml         //!< Readable, for people.
+    };
+
+    /*!
+     *  @struct Entry
+     *  @brief The value of one element.
+     */
+    struct Entry {
+        std::string id;                             //!< The ID of the element.
+        GuiEventType type = GuiEventType::Toggle;   //!< The type of the value.
+        GuiEvent::Value value = { false };          //!< The value, typed as the GuiEvent of the element.
+        bool active = true;                         //!< False once the element was removed, such entries are not saved.
+    };
+
+    /*!
+     *  @struct EntryHeader
+     *  @brief Fixed part of an entry in the binary format, followed by idLength bytes of ID.
+     */
+    struct EntryHeader {
+        uint8_t type = 0;                   //!< The GuiEventType of the value.
+        uint8_t reserved = 0;               //!< Always 0.
+        uint16_t idLength = 0;              //!< Length of the ID.
+        GuiEvent::Value value = { false };  //!< The value.
+    };
+
+    std::vector<Entry> entries;     //!< The entries, in the order the elements were first created.
+
+    /*!
+     *  @brief Returns the format of a path from its extension: .json, .xml, anything else is binary.
+     *  @param path The path.
+     */
+    static Format formatOf(const std::string& path);
+
+    /*!
+     *  @brief Returns the active entry of an element.
+     *  @param id The ID of the element.
+     *  @return The entry, or nullptr.
+     */
+    const Entry* find(const std::string& id) const;
+
+    /*!
+     *  @brief Encodes the active entries in the binary format.
+     */
+    std::string toBinary() const;
+
+    /*!
+     *  @brief Replaces the entries with a binary snapshot.
+     *  @param data The bytes of the file.
+     *  @param length The number of bytes.
+     *  @return False if the data is not a snapshot, is of another version or is damaged.
+     */
+    bool fromBinary(const char* data, size_t length);
+
+    /*!
+     *  @brief Encodes the active entries as JSON, e.g. { "elements": [ { "id": "muteToggle", "type": "toggle", "value": true } ] }.
+     */
+    json toJson() const;
+
+    /*!
+     *  @brief Replaces the entries with a JSON snapshot. Entries without an ID, a known type or a value are skipped.
+     *  @param node The JSON snapshot.
+     *  @return False if the node has no 'elements' array.
+     */
+    bool fromJson(const json& node);
+
+    /*!
+     *  @brief Encodes the active entries as XML, one element node per entry with id, type and value attributes.
+     */
+    std::string toXml() const;
+
+    /*!
+     *  @brief Replaces the entries with an XML snapshot.
+     *  @param text The XML text.
+     *  @return False if the text has no 'snapshot' node.
+     */
+    bool fromXml(const std::string& text);
+
+    /*!
+     *  @brief Writes the snapshot. The file is written next to the path and renamed,
+     *         so a crash during the write leaves the previous file intact.
+     *  @param path The path of the file.
+     *  @param format The format.
+     *  @return False if the file could not be written.
+     */
+    bool save(const std::string& path, Format format) const;
+
+    /*!
+     *  @brief Replaces the entries with a snapshot file of any format, detected from its contents.
+     *  @param path The path of the file.
+     *  @return False if the file could not be read or parsed.
+     */
+    bool load(const std::string& path);
+};
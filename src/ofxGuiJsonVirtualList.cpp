@@ -0,0 +1,111 @@
+#include "ofxGuiJsonVirtualList.h"
+
+void ofxGuiJsonVirtualList::setup(const std::string& label, GuiElementType type, size_t visibleRows, float width, float rowHeight) {
+    ofxGuiGroup::setup(label);
+    clear();
+    rows.clear();
+    rowListeners.clear();
+    title = label;
+    rowType = type;
+    first = 0;
+
+    // The rows are created once, scrolling only rebinds them
+    for (size_t r = 0; r < visibleRows; r++) {
+        if (rowType == GuiElementType::Label) {
+            auto row = std::make_unique<ofxLabel>();
+            row->setup("", width, rowHeight);
+            add(row.get());
+            rows.push_back(std::move(row));
+        }
+        else {
+            auto row = std::make_unique<ofxToggle>();
+            row->setup("", false, width, rowHeight);
+            ofParameter<bool>& param = row->getParameter().cast<bool>();
+            rowListeners.push_back(param.newListener([this, r](bool& state) {
+                onRowChanged(r, state);
+            }));
+            add(row.get());
+            rows.push_back(std::move(row));
+        }
+    }
+    setWidthElements(width);
+    refresh();
+}
+
+void ofxGuiJsonVirtualList::setSource(VirtualListSource* listSource) {
+    source = listSource;
+    first = 0;
+    refresh();
+}
+
+void ofxGuiJsonVirtualList::refresh() {
+    size_t count = source ? source->getCount() : 0;
+    if (first + rows.size() > count) {
+        first = count > rows.size() ? count - rows.size() : 0;  // Items were removed below the window
+    }
+
+    rebinding = true;
+    for (size_t r = 0; r < rows.size(); r++) {
+        size_t index = first + r;
+        bool bound = index < count;
+        ofxBaseGui& row = *rows[r];
+        row.setName(bound ? source->getText(index) : "");
+        if (rowType == GuiElementType::Toggle) {
+            row.getParameter().cast<bool>() = bound && source->getState(index);
+        }
+        row.setPosition(row.getPosition().x, row.getPosition().y);  // Regenerates the text of the row
+    }
+    rebinding = false;
+
+    if (count > rows.size()) {
+        setName(title + " (" + ofToString(first + 1) + "-" + ofToString(first + rows.size()) + " of " + ofToString(count) + ")");
+    }
+    else {
+        setName(title);
+    }
+}
+
+void ofxGuiJsonVirtualList::scrollTo(size_t index) {
+    size_t count = source ? source->getCount() : 0;
+    size_t last = count > rows.size() ? count - rows.size() : 0;
+    size_t next = std::min(index, last);
+    if (next != first) {
+        first = next;
+        refresh();
+    }
+}
+
+void ofxGuiJsonVirtualList::scrollBy(int count) {
+    if (count < 0) {
+        size_t up = static_cast<size_t>(-count);
+        scrollTo(first > up ? first - up : 0);
+    }
+    else {
+        scrollTo(first + static_cast<size_t>(count));
+    }
+}
+
+bool ofxGuiJsonVirtualList::mouseScrolled(ofMouseEventArgs& args) {
+    if (isMinimized() || !b.inside(args.x, args.y)) {
+        return ofxGuiGroup::mouseScrolled(args);
+    }
+    if (args.scrollY != 0) {
+        scrollBy(args.scrollY > 0 ? -1 : 1);  // Wheel up shows earlier items
+    }
+    return true;
+}
+
+void ofxGuiJsonVirtualList::onRowChanged(size_t row, bool state) {
+    if (rebinding) {
+        return;
+    }
+    if (!source || first + row >= source->getCount()) {
+        refresh();  // Empty row, undo the click
+        return;
+    }
+    VirtualListEvent event;
+    event.index = first + row;
+    event.state = state;
+    source->setState(event.index, state);
+    ofNotifyEvent(onRowToggled, event, this);
+}
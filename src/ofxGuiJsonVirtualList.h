@@ -0,0 +1,171 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonVirtualList.h
+
+    @brief    This file defines the "virtual_list" element: a scrolling list
+              that instantiates only its visible rows and binds them by index
+              to an application data source, so memory and draw cost do not
+              depend on the number of items.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxGui.h"
+#include "ofxGuiJsonModel.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/*!
+ *  @class VirtualListSource
+ *  @brief Data behind a virtual list. Rows read items by index when they are bound.
+ */
+class VirtualListSource {
+public:
+    virtual ~VirtualListSource() {}
+
+    /*!
+     *  @brief Returns the number of items.
+     */
+    virtual size_t getCount() const = 0;
+
+    /*!
+     *  @brief Returns the text shown for an item.
+     *  @param index The index of the item.
+     */
+    virtual std::string getText(size_t index) const = 0;
+
+    /*!
+     *  @brief Returns the state of an item shown by toggle rows.
+     *  @param index The index of the item.
+     */
+    virtual bool getState(size_t /*index*/) const { return false; }
+
+    /*!
+     *  @brief Stores the state of an item after its toggle row was clicked.
+     *  @param index The index of the item.
+     *  @param state The new state.
+     */
+    virtual void setState(size_t /*index*/, bool /*state*/) {}
+};
+
+/*!
+ *  @class VectorListSource
+ *  @brief Ready-made source keeping the items in a vector.
+ */
+class VectorListSource : public VirtualListSource {
+public:
+    /*!
+     *  @struct Item
+     *  @brief One item of the list.
+     */
+    struct Item {
+        std::string text;       //!< The text of the row.
+        bool state = false;     //!< The state of the toggle row.
+    };
+
+    size_t getCount() const override { return items.size(); }
+    std::string getText(size_t index) const override { return items[index].text; }
+    bool getState(size_t index) const override { return items[index].state; }
+    void setState(size_t index, bool state) override { items[index].state = state; }
+
+    std::vector<Item> items;    //!< The items, edit freely and call ofxGuiJsonVirtualList::refresh().
+};
+
+/*!
+ *  @struct VirtualListEvent
+ *  @brief Payload of ofxGuiJsonVirtualList::onRowToggled.
+ */
+struct VirtualListEvent {
+    size_t index = 0;       //!< The index of the item in the source.
+    bool state = false;     //!< The new state of the item.
+};
+
+/*!
+ *  @class ofxGuiJsonVirtualList
+ *  @brief Group with a fixed number of recycled rows showing a window of a VirtualListSource.
+ *
+ *  Scrolling with the mouse wheel moves the window; rows are rebound, never created or destroyed.
+ */
+class ofxGuiJsonVirtualList : public ofxGuiGroup {
+public:
+    /*!
+     *  @brief Creates the rows of the list.
+     *  @param label The title of the list.
+     *  @param type GuiElementType::Toggle or GuiElementType::Label.
+     *  @param visibleRows The number of rows to instantiate.
+     *  @param width The width of the list.
+     *  @param rowHeight The height of each row.
+     */
+    void setup(const std::string& label, GuiElementType type, size_t visibleRows, float width, float rowHeight);
+
+    /*!
+     *  @brief Sets the data shown by the list. The source must outlive the list or be reset to nullptr.
+     *  @param listSource The data source.
+     */
+    void setSource(VirtualListSource* listSource);
+
+    /*!
+     *  @brief Rebinds the visible rows after the source changed. In cached render mode,
+     *         also call ofxGuiJson::markElementDirty() with the ID of the list.
+     */
+    void refresh();
+
+    /*!
+     *  @brief Scrolls so that an item is the first visible row. Clamped to the last full page.
+     *  @param index The index of the item.
+     */
+    void scrollTo(size_t index);
+
+    /*!
+     *  @brief Scrolls by a number of rows.
+     *  @param count Rows to scroll, negative values scroll up.
+     */
+    void scrollBy(int count);
+
+    /*!
+     *  @brief Returns the index of the item in the first visible row.
+     */
+    size_t getFirstVisible() const { return first; }
+
+    /*!
+     *  @brief Returns the number of instantiated rows.
+     */
+    size_t getVisibleRows() const { return rows.size(); }
+
+    /*!
+     *  @brief Scrolls the list when the wheel is used over it.
+     */
+    bool mouseScrolled(ofMouseEventArgs& args) override;
+
+    /*!
+     *  @brief Notified when a toggle row is clicked, with the index of its item.
+     */
+    ofEvent<VirtualListEvent> onRowToggled;
+
+private:
+    /*!
+     *  @brief Handles a click on a toggle row.
+     *  @param row The index of the row.
+     *  @param state The new state.
+     */
+    void onRowChanged(size_t row, bool state);
+
+    std::string title;                               //!< The title without the scroll range.
+    GuiElementType rowType = GuiElementType::Toggle; //!< The widget type of the rows.
+    std::vector<std::unique_ptr<ofxBaseGui>> rows;   //!< The recycled rows.
+    std::vector<ofEventListener> rowListeners;       //!< Listeners of the toggle rows.
+    VirtualListSource* source = nullptr;             //!< The data shown, not owned.
+    size_t first = 0;                                //!< Index of the item in the first row.
+    bool rebinding = false;                          //!< Set while rows are rebound, so their changes are not clicks.
+};
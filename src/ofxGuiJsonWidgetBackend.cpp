@@ -0,0 +1,447 @@
+#include "ofxGuiJsonWidgetBackend.h"
+#include <algorithm>
+
+GuiWidgetBackend::GuiWidgetBackend() {
+    gui.setLayoutManaged(true);  // The dynamic toggles are placed by their own layout
+}
+
+GuiWidgetBackend::~GuiWidgetBackend() {
+    clear();
+}
+
+void GuiWidgetBackend::setPanelCount(size_t count) {
+    while (panels.size() < count) {
+        panels.push_back(std::make_shared<ofxGuiJsonPanel>());
+    }
+    panels.resize(count);
+}
+
+void GuiWidgetBackend::setupPanel(size_t panel, const GuiPanelModel& panelModel) {
+    panels[panel]->setup(panelModel.title, panelModel.settingsFile, panelModel.width, panelModel.height);
+    panels[panel]->setPosition(panelModel.x, panelModel.y);
+    panelAt(panel).setLayoutManaged(panelModel.hasLayout());
+}
+
+void GuiWidgetBackend::updatePanel(size_t panel, const GuiPanelModel& previous, const GuiPanelModel& next) {
+    ofxPanel& target = *panels[panel];
+    if (next.title != previous.title) {
+        target.setName(next.title);
+    }
+    if (next.width != previous.width || next.height != previous.height) {
+        target.setSize(next.width, next.height);
+    }
+    if (next.x != previous.x || next.y != previous.y) {
+        target.setPosition(next.x, next.y);
+    }
+    panelAt(panel).setLayoutManaged(next.hasLayout());
+}
+
+void GuiWidgetBackend::setPanelElements(size_t panel, const std::vector<GuiElementRef>& elements) {
+    ofxGuiJsonPanel& target = panelAt(panel);
+    target.clear();
+    for (const auto& element : elements) {
+        ofxBaseGui* widget = getWidget(element);
+        if (widget) {
+            target.add(widget);
+        }
+    }
+}
+
+size_t GuiWidgetBackend::findPanelAt(float x, float y) const {
+    // Panels drawn last are on top
+    for (size_t p = panels.size(); p-- > 0;) {
+        if (panels[p]->getShape().inside(x, y)) {
+            return p;
+        }
+    }
+    return GuiDirtyTracker::NoPanel;
+}
+
+void GuiWidgetBackend::draw(GuiDirtyTracker& dirtyTracker, bool cached) {
+    if (!cached) {
+        panelCaches.clear();
+        cachedShapes.clear();
+        for (auto& panel : panels) {
+            panel->draw();
+        }
+        return;
+    }
+
+    dirtyTracker.resize(panels.size());
+    panelCaches.resize(panels.size());
+    cachedShapes.resize(panels.size());
+    for (size_t p = 0; p < panels.size(); p++) {
+        ofRectangle shape = panels[p]->getShape();
+        if (shape.width <= 0 || shape.height <= 0) {
+            continue;  // Panel without a valid "gui" section
+        }
+        if (shape.width != cachedShapes[p].width || shape.height != cachedShapes[p].height) {
+            dirtyTracker.markDirty(p);  // Resized or minimized, moving alone only changes where the cache is drawn
+        }
+        if (dirtyTracker.isDirty(p)) {
+            renderPanelCache(p, shape, dirtyTracker);
+        }
+        panelCaches[p].draw(shape.x, shape.y);
+    }
+}
+
+void GuiWidgetBackend::renderPanelCache(size_t index, const ofRectangle& shape, GuiDirtyTracker& dirtyTracker) {
+    ofFbo& cache = panelCaches[index];
+    int width = static_cast<int>(std::ceil(shape.width));
+    int height = static_cast<int>(std::ceil(shape.height));
+    if (!cache.isAllocated() || cache.getWidth() != width || cache.getHeight() != height) {
+        cache.allocate(width, height, GL_RGBA);
+    }
+
+    cache.begin();
+    ofClear(0, 0, 0, 0);
+    ofPushMatrix();
+    ofTranslate(-shape.x, -shape.y);  // Panels draw at their absolute position
+    panels[index]->draw();
+    ofPopMatrix();
+    cache.end();
+
+    cachedShapes[index] = shape;
+    dirtyTracker.markClean(index);
+}
+
+void GuiWidgetBackend::reserve(const GuiTypeCounts& counts) {
+    auto count = [&counts](GuiElementType type) { return counts[static_cast<size_t>(type)]; };
+    togglePool.reserve(count(GuiElementType::Toggle));
+    labelPool.reserve(count(GuiElementType::Label));
+    listPool.reserve(count(GuiElementType::VirtualList));
+    sliderPool.reserve(count(GuiElementType::Slider));
+    intSliderPool.reserve(count(GuiElementType::IntSlider));
+    buttonPool.reserve(count(GuiElementType::Button));
+    dropdownPool.reserve(count(GuiElementType::Dropdown));
+    floatFieldPool.reserve(count(GuiElementType::FloatField));
+    intFieldPool.reserve(count(GuiElementType::IntField));
+}
+
+GuiElementRef GuiWidgetBackend::createElement(const GuiModel& model, size_t index, const ofRectangle& rect) {
+    const std::string& label = model.labels[index];
+    int defaultInt = static_cast<int>(std::lround(model.defaults[index]));
+    int minInt = static_cast<int>(std::lround(model.mins[index]));
+    int maxInt = static_cast<int>(std::lround(model.maxs[index]));
+
+    GuiElementRef element;
+    element.type = model.types[index];
+    ofxBaseGui* widget = nullptr;
+
+    switch (element.type) {
+    case GuiElementType::Toggle: {
+        element.handle = togglePool.create();
+        ofxToggle* toggle = togglePool.get(element.handle);
+        toggle->setup(label, model.defaults[index] != 0, rect.width, rect.height);
+        widget = toggle;
+        break;
+    }
+    case GuiElementType::Label: {
+        element.handle = labelPool.create();
+        ofxLabel* labelControl = labelPool.get(element.handle);
+        labelControl->setup(label, rect.width, rect.height);
+        widget = labelControl;
+        break;
+    }
+    case GuiElementType::VirtualList: {
+        // Only the visible rows are instantiated, the size sets the width and the height of each row
+        element.handle = listPool.create();
+        ofxGuiJsonVirtualList* list = listPool.get(element.handle);
+        list->setup(label, model.rowTypes[index], model.visibleRows[index], rect.width, rect.height);
+        widget = list;
+        break;
+    }
+    case GuiElementType::Slider: {
+        element.handle = sliderPool.create();
+        ofxFloatSlider* slider = sliderPool.get(element.handle);
+        slider->setup(label, model.defaults[index], model.mins[index], model.maxs[index], rect.width, rect.height);
+        widget = slider;
+        break;
+    }
+    case GuiElementType::IntSlider: {
+        element.handle = intSliderPool.create();
+        ofxIntSlider* slider = intSliderPool.get(element.handle);
+        slider->setup(label, defaultInt, minInt, maxInt, rect.width, rect.height);
+        widget = slider;
+        break;
+    }
+    case GuiElementType::Button: {
+        element.handle = buttonPool.create();
+        ofxButton* button = buttonPool.get(element.handle);
+        button->setup(label, rect.width, rect.height);
+        widget = button;
+        break;
+    }
+    case GuiElementType::Dropdown: {
+        // The size sets the width and the height of each option row
+        element.handle = dropdownPool.create();
+        ofxGuiJsonDropdown* dropdown = dropdownPool.get(element.handle);
+        dropdown->setup(label, model.options[index], defaultInt, rect.width, rect.height);
+        widget = dropdown;
+        break;
+    }
+    case GuiElementType::FloatField: {
+        element.handle = floatFieldPool.create();
+        ofxFloatField* field = floatFieldPool.get(element.handle);
+        field->setup(label, model.defaults[index], model.mins[index], model.maxs[index], rect.width, rect.height);
+        widget = field;
+        break;
+    }
+    case GuiElementType::IntField: {
+        element.handle = intFieldPool.create();
+        ofxIntField* field = intFieldPool.get(element.handle);
+        field->setup(label, defaultInt, minInt, maxInt, rect.width, rect.height);
+        widget = field;
+        break;
+    }
+    default:
+        break;
+    }
+
+    if (widget) {
+        widget->setPosition(rect.x, rect.y);
+    }
+    return element;
+}
+
+GuiElementRef GuiWidgetBackend::createToggle(const std::string& label, bool state, const ofRectangle& rect) {
+    GuiElementRef element;
+    element.type = GuiElementType::Toggle;
+    element.handle = togglePool.create();
+    ofxToggle* toggle = togglePool.get(element.handle);
+    toggle->setup(label, state, rect.width, rect.height);
+    toggle->setPosition(rect.x, rect.y);
+    return element;
+}
+
+void GuiWidgetBackend::destroyElement(const GuiElementRef& element) {
+    // Stale handles are ignored by the pools, so a widget can safely be released twice
+    switch (element.type) {
+    case GuiElementType::Toggle:
+        togglePool.destroy(element.handle);
+        break;
+    case GuiElementType::Label:
+        labelPool.destroy(element.handle);
+        break;
+    case GuiElementType::VirtualList:
+        listPool.destroy(element.handle);
+        break;
+    case GuiElementType::Slider:
+        sliderPool.destroy(element.handle);
+        break;
+    case GuiElementType::IntSlider:
+        intSliderPool.destroy(element.handle);
+        break;
+    case GuiElementType::Button:
+        buttonPool.destroy(element.handle);
+        break;
+    case GuiElementType::Dropdown:
+        dropdownPool.destroy(element.handle);
+        break;
+    case GuiElementType::FloatField:
+        floatFieldPool.destroy(element.handle);
+        break;
+    case GuiElementType::IntField:
+        intFieldPool.destroy(element.handle);
+        break;
+    default:
+        break;
+    }
+}
+
+void GuiWidgetBackend::clear() {
+    for (auto& panel : panels) {
+        panel->clear();
+    }
+    panels.clear();
+    gui.clear();
+    panelCaches.clear();
+    cachedShapes.clear();
+
+    // One pass over each pool instead of one deallocation per widget
+    togglePool.clear();
+    labelPool.clear();
+    listPool.clear();
+    sliderPool.clear();
+    intSliderPool.clear();
+    buttonPool.clear();
+    dropdownPool.clear();
+    floatFieldPool.clear();
+    intFieldPool.clear();
+}
+
+void GuiWidgetBackend::setLabel(const GuiElementRef& element, const std::string& text) {
+    ofxBaseGui* widget = getWidget(element);
+    if (widget) {
+        widget->setName(text);
+    }
+}
+
+std::string GuiWidgetBackend::getLabel(const GuiElementRef& element) const {
+    ofxBaseGui* widget = getWidget(element);
+    return widget ? widget->getName() : std::string();
+}
+
+void GuiWidgetBackend::setRect(const GuiElementRef& element, const ofRectangle& rect) {
+    ofxBaseGui* widget = getWidget(element);
+    if (!widget) {
+        return;
+    }
+    ofxGuiJsonPanel* panel = dynamic_cast<ofxGuiJsonPanel*>(widget->getParent());
+    if (panel && panel->isLayoutManaged()) {
+        panel->place(widget, rect);  // Relative to the panel, which keeps it there
+    }
+    else {
+        widget->setSize(rect.width, rect.height);
+        widget->setPosition(rect.x, rect.y);
+    }
+}
+
+ofEventListener GuiWidgetBackend::listen(const GuiElementRef& element, std::function<void(const GuiEvent::Value&)> callback) {
+    ofxBaseGui* widget = getWidget(element);
+    if (!widget) {
+        return ofEventListener();
+    }
+
+    switch (element.type) {
+    case GuiElementType::Toggle:
+        return widget->getParameter().cast<bool>().newListener([callback](bool& state) {
+            GuiEvent::Value value = {};
+            value.toggle = state;
+            callback(value);
+        });
+    case GuiElementType::Slider:
+    case GuiElementType::FloatField:
+        return widget->getParameter().cast<float>().newListener([callback](float& number) {
+            GuiEvent::Value value = {};
+            value.number = number;
+            callback(value);
+        });
+    case GuiElementType::IntSlider:
+    case GuiElementType::IntField:
+        return widget->getParameter().cast<int>().newListener([callback](int& integer) {
+            GuiEvent::Value value = {};
+            value.integer = integer;
+            callback(value);
+        });
+    case GuiElementType::Button:
+        return widget->getParameter().cast<void>().newListener([callback]() {
+            GuiEvent::Value value = {};
+            callback(value);
+        });
+    case GuiElementType::Dropdown:
+        return static_cast<ofxGuiJsonDropdown*>(widget)->getSelectedParameter().newListener([callback](int& selected) {
+            GuiEvent::Value value = {};
+            value.integer = selected;
+            callback(value);
+        });
+    default:
+        return ofEventListener();
+    }
+}
+
+GuiEvent::Value GuiWidgetBackend::getValue(const GuiElementRef& element) const {
+    GuiEvent::Value value = {};
+    ofxBaseGui* widget = getWidget(element);
+    if (!widget) {
+        return value;
+    }
+
+    switch (element.type) {
+    case GuiElementType::Toggle:
+        value.toggle = widget->getParameter().cast<bool>().get();
+        break;
+    case GuiElementType::Slider:
+    case GuiElementType::FloatField:
+        value.number = widget->getParameter().cast<float>().get();
+        break;
+    case GuiElementType::IntSlider:
+    case GuiElementType::IntField:
+        value.integer = widget->getParameter().cast<int>().get();
+        break;
+    case GuiElementType::Dropdown:
+        value.integer = static_cast<ofxGuiJsonDropdown*>(widget)->getSelected();
+        break;
+    default:
+        break;
+    }
+    return value;
+}
+
+bool GuiWidgetBackend::setValue(const GuiElementRef& element, const GuiEvent::Value& value) {
+    ofxBaseGui* widget = getWidget(element);
+    if (!widget || !hasElementValue(element.type)) {
+        return false;
+    }
+
+    // Setting the parameter notifies its listeners, exactly as a change made with the mouse
+    switch (element.type) {
+    case GuiElementType::Toggle:
+        widget->getParameter().cast<bool>().set(value.toggle);
+        break;
+    case GuiElementType::Slider:
+    case GuiElementType::FloatField: {
+        ofParameter<float>& parameter = widget->getParameter().cast<float>();
+        parameter.set(ofClamp(value.number, parameter.getMin(), parameter.getMax()));
+        break;
+    }
+    case GuiElementType::IntSlider:
+    case GuiElementType::IntField: {
+        ofParameter<int>& parameter = widget->getParameter().cast<int>();
+        parameter.set(std::clamp(value.integer, parameter.getMin(), parameter.getMax()));
+        break;
+    }
+    case GuiElementType::Button:
+        widget->getParameter().cast<void>().trigger();
+        break;
+    case GuiElementType::Dropdown:
+        static_cast<ofxGuiJsonDropdown*>(widget)->setSelected(value.integer);
+        break;
+    default:
+        break;
+    }
+    return true;
+}
+
+void GuiWidgetBackend::addToMainPanel(const GuiElementRef& element) {
+    ofxBaseGui* widget = getWidget(element);
+    if (widget) {
+        gui.add(widget);  // The panel grows to enclose the widget once it is placed
+    }
+}
+
+void GuiWidgetBackend::removeFromMainPanel(const GuiElementRef& element) {
+    ofxBaseGui* widget = getWidget(element);
+    if (widget) {
+        gui.remove(widget);  // Nothing moves, the toggle layout places the rows below
+    }
+}
+
+void GuiWidgetBackend::clearMainPanel() {
+    gui.clear();
+}
+
+ofxBaseGui* GuiWidgetBackend::getWidget(const GuiElementRef& element) const {
+    switch (element.type) {
+    case GuiElementType::Toggle:
+        return togglePool.get(element.handle);
+    case GuiElementType::Label:
+        return labelPool.get(element.handle);
+    case GuiElementType::VirtualList:
+        return listPool.get(element.handle);
+    case GuiElementType::Slider:
+        return sliderPool.get(element.handle);
+    case GuiElementType::IntSlider:
+        return intSliderPool.get(element.handle);
+    case GuiElementType::Button:
+        return buttonPool.get(element.handle);
+    case GuiElementType::Dropdown:
+        return dropdownPool.get(element.handle);
+    case GuiElementType::FloatField:
+        return floatFieldPool.get(element.handle);
+    case GuiElementType::IntField:
+        return intFieldPool.get(element.handle);
+    default:
+        return nullptr;
+    }
+}
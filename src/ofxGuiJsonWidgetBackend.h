@@ -0,0 +1,111 @@
+/**************************************************************************/
+/*!
+    @file     ofxGuiJsonWidgetBackend.h
+
+    @brief    This file defines GuiWidgetBackend, the default GuiBackend, which
+              shows the elements as pooled ofxGui widgets in ofxPanels and can
+              render each panel through an FBO cache.
+
+    @section  LICENSE
+
+              EmotiBit invests time and resources providing this open source code,
+              please support EmotiBit and open-source hardware by purchasing
+              products from EmotiBit!
+
+              Written by Moises Moreno for EmotiBit.
+*/
+/**************************************************************************/
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxGui.h"
+#include "ofxGuiJsonBackend.h"
+#include "ofxGuiJsonPanel.h"
+#include "ofxGuiJsonVirtualList.h"
+#include "ofxGuiJsonDropdown.h"
+#include <memory>
+#include <vector>
+
+/*!
+ *  @class GuiWidgetBackend
+ *  @brief GuiBackend creating ofxGui widgets. Needs a GL context to draw.
+ */
+class GuiWidgetBackend : public GuiBackend {
+public:
+    /*!
+     *  @brief Creates the backend. The main panel keeps the rects given to its toggles.
+     */
+    GuiWidgetBackend();
+
+    /*!
+     *  @brief Detaches the pooled widgets from their panels before the pools are destroyed.
+     */
+    ~GuiWidgetBackend();
+
+    void setPanelCount(size_t count) override;
+    size_t getPanelCount() const override { return panels.size(); }
+    void setupPanel(size_t panel, const GuiPanelModel& panelModel) override;
+    void updatePanel(size_t panel, const GuiPanelModel& previous, const GuiPanelModel& next) override;
+    void setPanelElements(size_t panel, const std::vector<GuiElementRef>& elements) override;
+    size_t findPanelAt(float x, float y) const override;
+    void draw(GuiDirtyTracker& dirtyTracker, bool cached) override;
+
+    void reserve(const GuiTypeCounts& counts) override;
+    GuiElementRef createElement(const GuiModel& model, size_t index, const ofRectangle& rect) override;
+    GuiElementRef createToggle(const std::string& label, bool state, const ofRectangle& rect) override;
+    void destroyElement(const GuiElementRef& element) override;
+    void clear() override;
+    void setLabel(const GuiElementRef& element, const std::string& text) override;
+    std::string getLabel(const GuiElementRef& element) const override;
+    void setRect(const GuiElementRef& element, const ofRectangle& rect) override;
+    ofEventListener listen(const GuiElementRef& element, std::function<void(const GuiEvent::Value&)> callback) override;
+    GuiEvent::Value getValue(const GuiElementRef& element) const override;
+    bool setValue(const GuiElementRef& element, const GuiEvent::Value& value) override;
+
+    void addToMainPanel(const GuiElementRef& element) override;
+    void removeFromMainPanel(const GuiElementRef& element) override;
+    void clearMainPanel() override;
+
+    ofxBaseGui* getWidget(const GuiElementRef& element) const override;
+
+    /*!
+     *  @brief Returns the panels, one per panel of the model.
+     */
+    std::vector<std::shared_ptr<ofxPanel>>& getPanels() { return panels; }
+
+    /*!
+     *  @brief Returns the main panel holding the dynamic toggles.
+     */
+    ofxGuiJsonPanel& getMainPanel() { return gui; }
+
+private:
+    /*!
+     *  @brief Renders a panel into its FBO cache.
+     *  @param index The index of the panel.
+     *  @param shape The current shape of the panel.
+     *  @param dirtyTracker Marks the panel clean once rendered.
+     */
+    void renderPanelCache(size_t index, const ofRectangle& shape, GuiDirtyTracker& dirtyTracker);
+
+    /*!
+     *  @brief Returns a panel as the ofxGuiJsonPanel it was created as.
+     *  @param index The index of the panel.
+     */
+    ofxGuiJsonPanel& panelAt(size_t index) { return static_cast<ofxGuiJsonPanel&>(*panels[index]); }
+
+    std::vector<std::shared_ptr<ofxPanel>> panels;          //!< One panel per panel of the model, each an ofxGuiJsonPanel.
+    ofxGuiJsonPanel gui;                                    //!< The main panel holding the dynamic toggles.
+    std::vector<ofFbo> panelCaches;                         //!< The offscreen buffer of each panel.
+    std::vector<ofRectangle> cachedShapes;                  //!< The shape of each panel when its cache was last rendered.
+
+    WidgetPool<ofxToggle> togglePool;                       //!< Toggles, sized from the configuration.
+    WidgetPool<ofxLabel> labelPool;                         //!< Labels, sized from the configuration.
+    WidgetPool<ofxGuiJsonVirtualList> listPool;             //!< Virtual lists, sized from the configuration.
+    WidgetPool<ofxFloatSlider> sliderPool;                  //!< Float sliders, sized from the configuration.
+    WidgetPool<ofxIntSlider> intSliderPool;                 //!< Integer sliders, sized from the configuration.
+    WidgetPool<ofxButton> buttonPool;                       //!< Buttons, sized from the configuration.
+    WidgetPool<ofxGuiJsonDropdown> dropdownPool;            //!< Dropdowns, sized from the configuration.
+    WidgetPool<ofxFloatField> floatFieldPool;               //!< Float input fields, sized from the configuration.
+    WidgetPool<ofxIntField> intFieldPool;                   //!< Integer input fields, sized from the configuration.
+};
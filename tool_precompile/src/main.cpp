@@ -0,0 +1,27 @@
+#include "ofMain.h"
+#include "ofxGuiJsonLoader.h"
+#include <filesystem>
+
+//========================================================================
+// Validates configuration files and writes their binary caches (<config>.cache),
+// so deployed applications skip text parsing on the first launch.
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		std::cerr << "Usage: tool_precompile config.json [more.json ...]" << std::endl;
+		return 1;
+	}
+
+	ofLogToConsole();
+	int failures = 0;
+	for (int i = 1; i < argc; i++) {
+		std::string path = std::filesystem::absolute(argv[i]).string();
+		if (GuiModelLoader::precompile(path)) {
+			std::cout << path << " -> " << GuiModelLoader::cachePath(path) << std::endl;
+		}
+		else {
+			std::cerr << path << ": failed" << std::endl;
+			failures++;
+		}
+	}
+	return failures > 0 ? 1 : 0;
+}